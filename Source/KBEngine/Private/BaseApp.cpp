@@ -9,6 +9,7 @@
 #include "KBEPersonality.h"
 #include "Entity.h"
 #include "KBEMath.h"
+#include "PackedFloat.h"
 #include "KBEErrors.h"
 #include "EntityDef.h"
 #include "ScriptModule.h"
@@ -22,19 +23,21 @@ namespace KBEngine
 		KBE_ASSERT(app_);
 
 		messages_ = app->pMessages();
-		messageReader_ = new MessageReader(this, messages_, KBEngineApp::app->GetTcpRecvBufferMax());
+		messageReader_ = new MessageReader(this, messages_);
+		messages_->RegisterHandler(this);
 	}
 
 	BaseApp::~BaseApp()
 	{
 		KBE_DEBUG(TEXT("BaseApp::~BaseApp()"));
+		messages_->UnregisterHandler(this);
 		ClearNetwork();
 		SAFE_DELETE(messageReader_);
+		SAFE_DELETE(frameBundle_);
+		SAFE_DELETE(syncBundle_);
 
-		// Entity
-		for (auto it : bufferedCreateEntityMessage_)
-			delete it.Value;
-		bufferedCreateEntityMessage_.Reset();
+		// 清理缓存的Entity数据
+		bufferedCreateEntityMessage_.Clear();
 
 		ClearEntities(true);
 	}
@@ -46,10 +49,19 @@ namespace KBEngine
 
 	void BaseApp::ClearNetwork()
 	{
+		// 网络已经断开，积攒的消息没有必要再发送
+		if (frameBundle_)
+			frameBundle_->Discard();
+
+		if (syncBundle_)
+			syncBundle_->Discard();
+
+		volatileDataBatch_.Reset();
+
 		if (networkInterface_)
 		{
-			networkInterface_->Close();
-			delete networkInterface_;
+			// 可能是在这个网络的消息处理函数中调用的，由Destroy决定何时真正销毁
+			NetworkInterfaceBase::Destroy(networkInterface_);
 			networkInterface_ = nullptr;
 		}
 	}
@@ -72,7 +84,7 @@ namespace KBEngine
 		return nullptr;
 	}
 
-	int32 BaseApp::GetAoiEntityIDFromStream(MemoryStream &stream)
+	int32 BaseApp::GetAoiEntityIDFromStream(MemoryStreamView &stream)
 	{
 		if (!app_->UseAliasEntityID())
 			return stream.ReadInt32();
@@ -86,9 +98,9 @@ namespace KBEngine
 		{
 			byte aliasID = stream.ReadUint8();
 
-			// Ϊ0ҿͻһص½ҷentityڶڼһֱ״̬
-			// Ժ, ΪcellappһֱbaseappͬϢ ͻʱδ
-			// ˳ʼ迪ʼյͬϢ, ʱͻ
+			// 如果为0且客户端上一步是重登陆或者重连操作并且服务端entity在断线期间一直处于在线状态
+			// 则可以忽略这个错误, 因为cellapp可能一直在向baseapp发送同步消息， 当客户端重连上时未等
+			// 服务端初始化步骤开始则收到同步信息, 此时这里就会出错。
 			if (entityIDAliasIDList_.Num() <= aliasID)
 				return 0;
 
@@ -98,14 +110,6 @@ namespace KBEngine
 		return id;
 	}
 
-	MemoryStream* BaseApp::FindBufferedCreateEntityMessage(int32 entityID)
-	{
-		MemoryStream **p = bufferedCreateEntityMessage_.Find(entityID);
-		if (p)
-			return *p;
-		return nullptr;
-	}
-
 	void BaseApp::ClearEntities(bool isall)
 	{
 		controlledEntities_.Empty();
@@ -123,7 +127,7 @@ namespace KBEngine
 					if (iter.Value()->InWorld())
 						iter.Value()->LeaveWorld();
 
-					iter.Value()->Destroy();
+					DestroyEntity(iter.Value());
 					iter.RemoveCurrent();
 				}
 
@@ -136,10 +140,56 @@ namespace KBEngine
 				if (iter.Value()->InWorld())
 					iter.Value()->LeaveWorld();
 
-				iter.Value()->Destroy();
+				DestroyEntity(iter.Value());
 				iter.RemoveCurrent();
 			}
 
+			pendingChildren_.Reset();
+		}
+	}
+
+	void BaseApp::DestroyEntity(Entity* entity)
+	{
+		// 销毁自身时子对象仍然保留着parentID，它们重新进入等待状态，
+		// 以便父对象再次进入世界时能够挂接上
+		for (auto iter : entity->children_)
+			AddPendingChild(entity->ID(), iter.Key);
+
+		if (!entity->parent_ && entity->parentID_ > 0)
+			RemovePendingChild(entity->parentID_, entity->ID());
+
+		entity->Destroy();
+	}
+
+	void BaseApp::AddPendingChild(int32 parentID, int32 childID)
+	{
+		pendingChildren_.FindOrAdd(parentID).AddUnique(childID);
+	}
+
+	void BaseApp::RemovePendingChild(int32 parentID, int32 childID)
+	{
+		TArray<int32>* children = pendingChildren_.Find(parentID);
+		if (!children)
+			return;
+
+		children->RemoveSingleSwap(childID);
+		if (children->Num() == 0)
+			pendingChildren_.Remove(parentID);
+	}
+
+	void BaseApp::AttachPendingChildren(Entity* parent)
+	{
+		TArray<int32> children;
+		if (!pendingChildren_.RemoveAndCopyValue(parent->ID(), children))
+			return;
+
+		for (int32 childID : children)
+		{
+			Entity* child = FindEntity(childID);
+
+			// 登记之后子对象可能已经换了父对象，这里再确认一次
+			if (child && !child->parent_ && child->parentID_ == parent->ID())
+				child->SetParent(parent);
 		}
 	}
 
@@ -186,6 +236,29 @@ namespace KBEngine
 		return needUpdate;
 	}
 
+	// 同步给服务器的坐标精度（单位：厘米）与朝向精度（与服务器压缩朝向时的int8精度一致，单位：度）
+	static const float SYNC_POSITION_PRECISION = 1.0f;
+	static const float SYNC_DIRECTION_PRECISION = 360.0f / 256.0f;
+
+	// 向服务器同步坐标、朝向的间隔，即每秒10次；单位：秒
+	static const double PLAYER_SYNC_INTERVAL = 0.1;
+
+	static FVector QuantizeSyncPosition(const FVector& position)
+	{
+		return FVector(
+			FMath::RoundToFloat(position.X / SYNC_POSITION_PRECISION) * SYNC_POSITION_PRECISION,
+			FMath::RoundToFloat(position.Y / SYNC_POSITION_PRECISION) * SYNC_POSITION_PRECISION,
+			FMath::RoundToFloat(position.Z / SYNC_POSITION_PRECISION) * SYNC_POSITION_PRECISION);
+	}
+
+	static FVector QuantizeSyncDirection(const FVector& direction)
+	{
+		return FVector(
+			FMath::RoundToFloat(direction.X / SYNC_DIRECTION_PRECISION) * SYNC_DIRECTION_PRECISION,
+			FMath::RoundToFloat(direction.Y / SYNC_DIRECTION_PRECISION) * SYNC_DIRECTION_PRECISION,
+			FMath::RoundToFloat(direction.Z / SYNC_DIRECTION_PRECISION) * SYNC_DIRECTION_PRECISION);
+	}
+
 	void BaseApp::UpdatePlayerToServer()
 	{
 		if (!app_->SyncPlayer() || spaceID_ == 0)
@@ -193,194 +266,127 @@ namespace KBEngine
 			return;
 		}
 
-		// ʱв㣬֤ÿ뷢10
-		auto now = FDateTime::UtcNow();
-		auto span = now - lastUpdateToServerTime_;
+		double time = FPlatformTime::Seconds();
+		double span = time - lastUpdateToServerTime_;
 
-		if (span.GetTicks() < 1000000)
+		if (span < PLAYER_SYNC_INTERVAL)
 			return;
 
-		lastUpdateToServerTime_ = now - (span - FTimespan(1000000));
+		// 对时间进行补偿计算，尽量保证每秒发送10次；落后超过一个间隔（第一次同步或者卡顿之后）时不再追赶
+		lastUpdateToServerTime_ = span < PLAYER_SYNC_INTERVAL * 2 ? lastUpdateToServerTime_ + PLAYER_SYNC_INTERVAL : time;
 
 		Entity* playerEntity = Player();
 		if (playerEntity == NULL || playerEntity->InWorld() == false)
 			return;
 
-		// ʼԼϢ
-		if (!playerEntity->IsControlled())
-		{
-			const FVector &position = playerEntity->Position();
-			const FVector &direction = playerEntity->Direction();
+		if (!syncBundle_)
+			syncBundle_ = new Bundle();
 
-			bool posHasChanged;
-			bool dirHasChanged;
-			bool needUpdate;
+		// 玩家自己以及所有被控制了的entity的同步消息都写入同一个包，一次发送
+		int32 count = 0;
 
-			//parentlocalλãǷıҪҪͬҽlocal궼
-			if (playerEntity->Parent() != nullptr)
-			{
-				const FVector &localPosition = playerEntity->localPosition_;
-				const FVector &localDirection = playerEntity->localDirection_;
+		if (!playerEntity->IsControlled() && WriteVolatileDataToServer(syncBundle_, playerEntity, true, time))
+			count++;
 
-				posHasChanged = FVector::Dist(playerEntity->lastSyncLocalPos_, localPosition) > 0.1f;
-				dirHasChanged = FVector::Dist(playerEntity->lastSyncLocalDir_, localDirection) > 0.1f;
-				needUpdate = this->PlayerNeedUpdate(playerEntity, posHasChanged || dirHasChanged);
-				if (needUpdate)
-				{
-					playerEntity->lastSyncLocalPos_ = localPosition;
-					playerEntity->lastSyncLocalDir_ = localDirection;
-					playerEntity->lastSyncPos_ = position;
-					playerEntity->lastSyncDir_ = direction;
-
-					Bundle* bundle = new Bundle();
-					bundle->NewMessage(messages_->GetMessage("Baseapp_onUpdateDataFromClientOnParent"));
-					bundle->WriteInt32(playerEntity->Parent()->ID());
-
-					auto localPos = KBEMath::Unreal2KBEnginePosition(localPosition);
-
-					bundle->WriteFloat(localPos.X);
-					bundle->WriteFloat(localPos.Y);
-					bundle->WriteFloat(localPos.Z);
+		for (auto* entity : controlledEntities_)
+		{
+			if (WriteVolatileDataToServer(syncBundle_, entity, false, time))
+				count++;
+		}
 
-					auto pos = KBEMath::Unreal2KBEnginePosition(position);
+		if (count > 0)
+			SendBundle(syncBundle_);
+	}
 
-					bundle->WriteFloat(pos.X);
-					bundle->WriteFloat(pos.Y);
-					bundle->WriteFloat(pos.Z);
+	bool BaseApp::WriteVolatileDataToServer(Bundle* bundle, Entity* entity, bool isPlayer, double time)
+	{
+		Entity* parent = entity->Parent();
 
-					auto dir = KBEMath::Unreal2KBEngineDirection(direction);
+		// 有parent，则依据local位置（或朝向）是否改变来决定要不要同步，并且将local坐标和世界坐标都传给服务器
+		// 没有parent，则依据世界位置（或朝向）是否改变来决定要不要同步，并且只传世界坐标给服务器
+		FVector position = QuantizeSyncPosition(entity->Position());
+		FVector direction = QuantizeSyncDirection(entity->Direction());
+		FVector localPosition = QuantizeSyncPosition(entity->localPosition_);
+		FVector localDirection = QuantizeSyncDirection(entity->localDirection_);
 
-					bundle->WriteFloat(dir.X);
-					bundle->WriteFloat(dir.Y);
-					bundle->WriteFloat(dir.Z);
-					bundle->WriteUint8((uint8)(playerEntity->IsOnGround() == true ? 1 : 0));
-					bundle->WriteUint32(spaceID_);
-					bundle->Send(networkInterface_);
-					delete bundle;
-				}
+		const FVector& checkPosition = parent ? localPosition : position;
+		const FVector& checkDirection = parent ? localDirection : direction;
+		const FVector& lastPosition = parent ? entity->lastSyncLocalPos_ : entity->lastSyncPos_;
+		const FVector& lastDirection = parent ? entity->lastSyncLocalDir_ : entity->lastSyncDir_;
 
-			}
+		bool posHasChanged = checkPosition != QuantizeSyncPosition(lastPosition);
+		bool dirHasChanged = checkDirection != QuantizeSyncDirection(lastDirection);
 
-			// ûparentλãǷıҪҪֻͬ
-			else
+		// 移动较慢时降低同步频率：距离上次同步的移动距离没有达到playerSyncDistance时，最多间隔playerSyncMaxInterval同步一次
+		// 朝向变化了至少一个量化精度(原地转身)时不受此限制，否则转身要等到间隔到期才会同步
+		if (posHasChanged && !dirHasChanged)
+		{
+			// 同步按PLAYER_SYNC_INTERVAL的节拍进行，每拍的时间有抖动，留出半拍的余量，
+			// 否则间隔刚好到期的同步会因为差了几毫秒被推迟到下一拍
+			double elapsed = time - entity->lastSyncTime_ + PLAYER_SYNC_INTERVAL * 0.5;
+			if (elapsed * 1000.0 < app_->PlayerSyncMaxInterval() &&
+				FVector::Dist(checkPosition, lastPosition) < app_->PlayerSyncDistance())
 			{
-				posHasChanged = FVector::Dist(playerEntity->lastSyncPos_, position) > 0.1f;
-				dirHasChanged = FVector::Dist(playerEntity->lastSyncDir_, direction) > 0.1f;
-				needUpdate = this->PlayerNeedUpdate(playerEntity, posHasChanged || dirHasChanged);
-				if (needUpdate)
-				{
-					playerEntity->lastSyncPos_ = position;
-					playerEntity->lastSyncDir_ = direction;
-
-					auto pos = KBEMath::Unreal2KBEnginePosition(position);
-
-					Bundle* bundle = new Bundle();
-					bundle->NewMessage(messages_->GetMessage("Baseapp_onUpdateDataFromClient"));
-					bundle->WriteFloat(pos.X);
-					bundle->WriteFloat(pos.Y);
-					bundle->WriteFloat(pos.Z);
-
-					auto dir = KBEMath::Unreal2KBEngineDirection(direction);
-
-					bundle->WriteFloat(dir.X);
-					bundle->WriteFloat(dir.Y);
-					bundle->WriteFloat(dir.Z);
-					bundle->WriteUint8((uint8)(playerEntity->IsOnGround() == true ? 1 : 0));
-					bundle->WriteUint32(spaceID_);
-					bundle->Send(networkInterface_);
-					delete bundle;
-				}
+				return false;
 			}
 		}
 
-		// ʼͬб˵entityλ
-		for (auto* entity : controlledEntities_)
-		{
-			const FVector &position = entity->Position();
-			const FVector &direction = entity->Direction();
+		if (!this->PlayerNeedUpdate(entity, posHasChanged || dirHasChanged))
+			return false;
 
-			bool posHasChanged;
-			bool dirHasChanged;
-			bool needUpdate;
+		entity->lastSyncLocalPos_ = localPosition;
+		entity->lastSyncLocalDir_ = localDirection;
+		entity->lastSyncPos_ = position;
+		entity->lastSyncDir_ = direction;
+		entity->lastSyncTime_ = time;
 
-			//parentlocalλãǷıҪҪͬҽlocal궼
-			if (entity->Parent() != nullptr)
+		if (parent)
+		{
+			if (isPlayer)
 			{
-				const FVector &localPosition = entity->localPosition_;
-				const FVector &localDirection = entity->localDirection_;
-
-				posHasChanged = FVector::Dist(entity->lastSyncLocalPos_, localPosition) > 0.1f;
-				dirHasChanged = FVector::Dist(entity->lastSyncLocalDir_, localDirection) > 0.1f;
-				needUpdate = this->PlayerNeedUpdate(entity, posHasChanged || dirHasChanged);
-				if (needUpdate)
-				{
-					entity->lastSyncLocalPos_ = localPosition;
-					entity->lastSyncLocalDir_ = localDirection;
-					entity->lastSyncPos_ = position;
-					entity->lastSyncDir_ = direction;
-
-					Bundle* bundle = new Bundle();
-					bundle->NewMessage(messages_->GetMessage("Baseapp_onUpdateDataFromClientForControlledEntityOnParent"));
-					bundle->WriteInt32(entity->ID());
-					bundle->WriteInt32(entity->Parent()->ID());
-
-					auto localPos = KBEMath::Unreal2KBEnginePosition(localPosition);
-
-					bundle->WriteFloat(localPos.X);
-					bundle->WriteFloat(localPos.Y);
-					bundle->WriteFloat(localPos.Z);
-
-					auto pos = KBEMath::Unreal2KBEnginePosition(position);
-
-					bundle->WriteFloat(pos.X);
-					bundle->WriteFloat(pos.Y);
-					bundle->WriteFloat(pos.Z);
+				bundle->NewMessage(messages_->GetMessage("Baseapp_onUpdateDataFromClientOnParent"));
+			}
+			else
+			{
+				bundle->NewMessage(messages_->GetMessage("Baseapp_onUpdateDataFromClientForControlledEntityOnParent"));
+				bundle->WriteInt32(entity->ID());
+			}
 
-					auto dir = KBEMath::Unreal2KBEngineDirection(direction);
+			bundle->WriteInt32(parent->ID());
 
-					bundle->WriteFloat(dir.X);
-					bundle->WriteFloat(dir.Y);
-					bundle->WriteFloat(dir.Z);
-					bundle->WriteUint8((uint8)(entity->IsOnGround() == true ? 1 : 0));
-					bundle->WriteUint32(spaceID_);
-					bundle->Send(networkInterface_);
-					delete bundle;
-				}
+			auto localPos = KBEMath::Unreal2KBEnginePosition(localPosition);
 
+			bundle->WriteFloat(localPos.X);
+			bundle->WriteFloat(localPos.Y);
+			bundle->WriteFloat(localPos.Z);
+		}
+		else
+		{
+			if (isPlayer)
+			{
+				bundle->NewMessage(messages_->GetMessage("Baseapp_onUpdateDataFromClient"));
 			}
-
-			// ûparentλãǷıҪҪֻͬ
 			else
 			{
-				posHasChanged = FVector::Dist(entity->lastSyncPos_, position) > 0.1f;
-				dirHasChanged = FVector::Dist(entity->lastSyncDir_, direction) > 0.1f;
-				needUpdate = this->PlayerNeedUpdate(entity, posHasChanged || dirHasChanged);
-				if (needUpdate)
-				{
-					entity->lastSyncPos_ = position;
-					entity->lastSyncDir_ = direction;
-
-					auto pos = KBEMath::Unreal2KBEnginePosition(position);
-
-					Bundle* bundle = new Bundle();
-					bundle->NewMessage(messages_->GetMessage("Baseapp_onUpdateDataFromClientForControlledEntity"));
-					bundle->WriteInt32(entity->ID());
-					bundle->WriteFloat(pos.X);
-					bundle->WriteFloat(pos.Y);
-					bundle->WriteFloat(pos.Z);
-
-					auto dir = KBEMath::Unreal2KBEngineDirection(direction);
-
-					bundle->WriteFloat(dir.X);
-					bundle->WriteFloat(dir.Y);
-					bundle->WriteFloat(dir.Z);
-					bundle->WriteUint8((uint8)(entity->IsOnGround() == true ? 1 : 0));
-					bundle->WriteUint32(spaceID_);
-					bundle->Send(networkInterface_);
-					delete bundle;
-				}
+				bundle->NewMessage(messages_->GetMessage("Baseapp_onUpdateDataFromClientForControlledEntity"));
+				bundle->WriteInt32(entity->ID());
 			}
 		}
+
+		auto pos = KBEMath::Unreal2KBEnginePosition(position);
+
+		bundle->WriteFloat(pos.X);
+		bundle->WriteFloat(pos.Y);
+		bundle->WriteFloat(pos.Z);
+
+		auto dir = KBEMath::Unreal2KBEngineDirection(direction);
+
+		bundle->WriteFloat(dir.X);
+		bundle->WriteFloat(dir.Y);
+		bundle->WriteFloat(dir.Z);
+		bundle->WriteUint8((uint8)(entity->IsOnGround() == true ? 1 : 0));
+		bundle->WriteUint32(spaceID_);
+		return true;
 	}
 
 	void BaseApp::SendTick()
@@ -392,11 +398,11 @@ namespace KBEngine
 
 		if (span.GetTotalSeconds() >= app_->TickInterval())
 		{
-			// phw: жϴҪkbe 0.8.10ϰ汾ķ֧
+			// phw: 心跳判断代码需要kbe 0.8.10以上版本的服务器支持
 			span = lastTickCBTime_ - lastTicktime_;
 
-			// صʱСʱ䣬˵ûյص
-			// ʱӦ֪ͨͻ˵
+			// 如果心跳回调接收时间小于心跳发送时间，说明没有收到回调
+			// 此时应该通知客户端掉线了
 			if (span.GetTotalSeconds() < 0)
 			{
 				KBE_ERROR(TEXT("BaseApp::SendTick: Receive appTick timeout!lastTickCBTime_(%s) - lastTicktime_(%s) < 0, span(%s)"), 
@@ -413,7 +419,7 @@ namespace KBEngine
 			{
 				Bundle* bundle = new Bundle();
 				bundle->NewMessage(messages_->GetMessage("Baseapp_onClientActiveTick"));
-				bundle->Send(networkInterface_);
+				SendBundle(bundle);
 				delete bundle;
 				//KBE_ERROR(TEXT("shufeng --->>> BaseApp::SendTick: send message Baseapp_onClientActiveTick time:%s:%d"), 
 				//	*FDateTime::UtcNow().ToString(), FDateTime::UtcNow().GetMillisecond());
@@ -486,11 +492,11 @@ namespace KBEngine
 		bundle->WriteString(app_->ClientVersion());
 		bundle->WriteString(app_->ClientScriptVersion());
 		bundle->WriteBlob(app_->EncryptedKey());
-		bundle->Send(networkInterface_);
+		SendBundle(bundle);
 		delete bundle;
 	}
 
-	void BaseApp::Client_onHelloCB(MemoryStream &stream)
+	void BaseApp::Client_onHelloCB(MemoryStreamView &stream)
 	{
 		FString serverVersion = stream.ReadString();
 		FString serverScriptVersion = stream.ReadString();
@@ -509,7 +515,7 @@ namespace KBEngine
 			digestMatch = app_->pPersistentInofs()->OnServerDigest(SERVER_APP_TYPE::BaseApp, serverProtocolMD5, serverEntitydefMD5);
 
 		KBE_DEBUG(TEXT("BaseApp::Client_onHelloCB: digest match(%s)"), digestMatch ? TEXT("true") : TEXT("false"));
-		// ԼرϢ
+		// 尝试加载本地消息定义
 		bool success = digestMatch;
 		if (success)
 		{
@@ -519,11 +525,11 @@ namespace KBEngine
 				success = messages_->ImportMessagesFromStream(out, SERVER_APP_TYPE::BaseApp);
 		}
 
-		// ʧ
+		// 加载失败则向服务器请求
 		if (!success)
 			CmdImportClientMessages();
 
-		// ԼرEntityDef
+		// 尝试加载本地EntityDef定义
 		success = digestMatch;
 		if (success)
 		{
@@ -533,7 +539,7 @@ namespace KBEngine
 				success = EntityDef::ImportEntityDefFromStream(out);
 		}
 
-		// ʧ
+		// 加载失败则向服务器请求
 		if (!success)
 			CmdImportClientEntityDef();
 
@@ -541,7 +547,7 @@ namespace KBEngine
 			connectedCallbackFunc_((int)ERROR_TYPE::SUCCESS);
 	}
 
-	void BaseApp::Client_onVersionNotMatch(MemoryStream &stream)
+	void BaseApp::Client_onVersionNotMatch(MemoryStreamView &stream)
 	{
 		auto serverVersion = stream.ReadString();
 
@@ -554,7 +560,7 @@ namespace KBEngine
 			connectedCallbackFunc_((int)ERROR_TYPE::VERSION_NOT_MATCH);
 	}
 
-	void BaseApp::Client_onScriptVersionNotMatch(MemoryStream &stream)
+	void BaseApp::Client_onScriptVersionNotMatch(MemoryStreamView &stream)
 	{
 		auto serverScriptVersion = stream.ReadString();
 
@@ -573,16 +579,16 @@ namespace KBEngine
 		KBE_DEBUG(TEXT("BaseApp::CmdImportClientMessages: send Baseapp_importClientMessages ..."));
 		Bundle* bundle = new Bundle();
 		bundle->NewMessage(messages_->GetMessage("Baseapp_importClientMessages"));
-		bundle->Send(networkInterface_);
+		SendBundle(bundle);
 		delete bundle;
 	}
 
-	void BaseApp::Client_onImportClientMessages(MemoryStream &stream)
+	void BaseApp::Client_onImportClientMessages(MemoryStreamView &stream)
 	{
 		KBE_DEBUG(TEXT("BaseApp::Client_onImportClientMessages: stream size: %d"), stream.Length());
 
-		// ȸһݳΪд׼
-		MemoryStream datas(stream);
+		// 先记下当前的读取位置，以为写入作准备（视图只借用内存，无需复制）
+		MemoryStreamView datas(stream);
 
 		messages_->ImportMessagesFromStream(stream, SERVER_APP_TYPE::BaseApp);
 
@@ -600,16 +606,16 @@ namespace KBEngine
 		KBE_DEBUG(TEXT("BaseApp::CmdImportClientEntityDef: send Baseapp_importClientEntityDef ..."));
 		Bundle* bundle = new Bundle();
 		bundle->NewMessage(messages_->GetMessage("Baseapp_importClientEntityDef"));
-		bundle->Send(networkInterface_);
+		SendBundle(bundle);
 		delete bundle;
 	}
 
-	void BaseApp::Client_onImportClientEntityDef(MemoryStream &stream)
+	void BaseApp::Client_onImportClientEntityDef(MemoryStreamView &stream)
 	{
 		KBE_DEBUG(TEXT("BaseApp::Client_onImportClientEntityDef: stream size: %d"), stream.Length());
 
-		// ȸһݳΪд׼
-		MemoryStream datas(stream);
+		// 先记下当前的读取位置，以为写入作准备（视图只借用内存，无需复制）
+		MemoryStreamView datas(stream);
 
 		EntityDef::ImportEntityDefFromStream(stream);
 
@@ -639,7 +645,7 @@ namespace KBEngine
 		bundle->NewMessage(messages_->GetMessage("Baseapp_loginBaseapp"));
 		bundle->WriteString(account);
 		bundle->WriteString(password);
-		bundle->Send(networkInterface_);
+		SendBundle(bundle);
 		delete bundle;
 	}
 
@@ -654,7 +660,7 @@ namespace KBEngine
 		bundle->WriteString(password_);
 		bundle->WriteUint64(entity_uuid_);
 		bundle->WriteInt32(entity_id_);
-		bundle->Send(networkInterface_);
+		SendBundle(bundle);
 		delete bundle;
 	}
 
@@ -667,7 +673,7 @@ namespace KBEngine
 		bundle->WriteString(password);
 		bundle->WriteInt8((int8)clientType);
 		bundle->WriteUint64(loginKey);
-		bundle->Send(networkInterface_);
+		SendBundle(bundle);
 		delete bundle;
 	}
 
@@ -683,7 +689,7 @@ namespace KBEngine
 			connectedCallbackFunc_(failedcode);
 	}
 
-	void BaseApp::Client_onLoginBaseappSuccessfully(MemoryStream &stream) 
+	void BaseApp::Client_onLoginBaseappSuccessfully(MemoryStreamView &stream) 
 	{
 		entity_uuid_ = stream.ReadUint64();
 		KBE_DEBUG(TEXT("BaseApp::Client_onLoginBaseappSuccessfully: name(%s)!"), *account_);
@@ -698,7 +704,7 @@ namespace KBEngine
 			connectedCallbackFunc_(failedcode);
 	}
 
-	void BaseApp::Client_onReloginBaseappSuccessfully(MemoryStream &stream)
+	void BaseApp::Client_onReloginBaseappSuccessfully(MemoryStreamView &stream)
 	{
 		entity_uuid_ = stream.ReadUint64();
 		KBE_DEBUG(TEXT("BaseApp::Client_onReloginBaseappSuccessfully: name(%s)!"), *account_);
@@ -715,7 +721,7 @@ namespace KBEngine
 		bundle->WriteInt32(entity_id_);
 		bundle->WriteString(password_);
 		bundle->WriteString(emailAddress);
-		bundle->Send(networkInterface_);
+		SendBundle(bundle);
 		delete bundle;
 	}
 
@@ -734,7 +740,7 @@ namespace KBEngine
 			connectedCallbackFunc_(failcode);
 	}
 
-	// ޸
+	// 修改密码
 	void BaseApp::NewPassword(const FString& old_password, const FString& new_password, ConnectCallbackFunc func)
 	{
 		connectedCallbackFunc_ = func;
@@ -744,7 +750,7 @@ namespace KBEngine
 		bundle->WriteInt32(entity_id_);
 		bundle->WriteString(old_password);
 		bundle->WriteString(new_password);
-		bundle->Send(networkInterface_);
+		SendBundle(bundle);
 		delete bundle;
 	}
 
@@ -777,8 +783,8 @@ namespace KBEngine
 		bool isCont = isControlled != 0;
 		if (isCont)
 		{
-			// ԼǱʾԼ˿
-			// ԼӦýб
+			// 如果被控制者是玩家自己，那表示玩家自己被其它人控制了
+			// 所以玩家自己不应该进入这个被控制列表
 			if (Player()->ID() != entity->ID())
 			{
 				controlledEntities_.Add(entity);
@@ -808,13 +814,12 @@ namespace KBEngine
 		if (entities_.Contains(eid))
 		{
 			//KBE_WARNING(TEXT("BaseApp::Client_onCreatedProxies: eid(%d) has exist!"), eid);
-			MemoryStream *entityMessage = FindBufferedCreateEntityMessage(eid);
+			MemoryStreamView entityMessage;
 
-			if (entityMessage)
+			if (bufferedCreateEntityMessage_.Find(eid, entityMessage))
 			{
-				Client_onUpdatePropertys(*entityMessage);
+				OnUpdatePropertys(eid, entityMessage);
 				bufferedCreateEntityMessage_.Remove(eid);
-				SAFE_DELETE(entityMessage);
 			}
 			return;
 		}
@@ -833,17 +838,16 @@ namespace KBEngine
 			return;
 		}
 
-		auto *mb = new Mailbox(eid, entityType, Mailbox::MAILBOX_TYPE::MAILBOX_TYPE_BASE);
+		auto *mb = module->CreateMailbox(eid, Mailbox::MAILBOX_TYPE::MAILBOX_TYPE_BASE);
 		entity->BaseMailbox(mb);
 
 		entities_.Add(eid, entity);
 
-		MemoryStream* entityMessage = FindBufferedCreateEntityMessage(eid);
-		if (entityMessage != NULL)
+		MemoryStreamView entityMessage;
+		if (bufferedCreateEntityMessage_.Find(eid, entityMessage))
 		{
-			Client_onUpdatePropertys(*entityMessage);
+			OnUpdatePropertys(eid, entityMessage);
 			bufferedCreateEntityMessage_.Remove(eid);
-			SAFE_DELETE(entityMessage);
 		}
 
 		entity->__init__();
@@ -853,34 +857,32 @@ namespace KBEngine
 			entity->CallPropertysSetMethods();
 	}
 
-	void BaseApp::Client_onUpdatePropertysOptimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdatePropertysOptimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 		OnUpdatePropertys(eid, stream);
 	}
 
-	void BaseApp::Client_onUpdatePropertys(MemoryStream &stream)
+	void BaseApp::Client_onUpdatePropertys(MemoryStreamView &stream)
 	{
 		int32 eid = stream.ReadInt32();
 		OnUpdatePropertys(eid, stream);
 	}
 
-	void BaseApp::OnUpdatePropertys(int32 eid, MemoryStream& stream)
+	void BaseApp::OnUpdatePropertys(int32 eid, MemoryStreamView &stream)
 	{
 		Entity* entity = FindEntity(eid);
 
 		if (!entity)
 		{
-			MemoryStream* entityMessage = FindBufferedCreateEntityMessage(eid);
-			if (entityMessage)
+			if (bufferedCreateEntityMessage_.Contains(eid))
 			{
 				KBE_ERROR(TEXT("BaseApp::OnUpdatePropertys: entity(%d) has more then one buffer message, has bug?"), eid);
 				return;
 			}
 
-			MemoryStream* stream1 = new MemoryStream();
-			stream1->Append(&(stream.Data()[stream.RPos() - 4]), stream.Length() + 4);
-			bufferedCreateEntityMessage_.Add(eid, stream1);
+			// 只缓存实体ID之后的属性数据，进入世界时直接交给OnUpdatePropertys处理
+			bufferedCreateEntityMessage_.Add(eid, stream.Data() + stream.RPos(), stream.Length());
 			return;
 		}
 
@@ -900,11 +902,10 @@ namespace KBEngine
 			}
 
 			Property* propertydata = sm->GetProperty(utype);
-			utype = propertydata->properUtype;
 			PropertyHandler setmethod = propertydata->setmethod;
 
-			FVariant val = propertydata->utype->CreateFromStream(&stream);
-			FVariant oldval = entity->GetDefinedPropertyByUType(utype);
+			FVariant val = propertydata->plan.IsValid() ? propertydata->plan.Decode(stream) : propertydata->utype->CreateFromStream(&stream);
+			FVariant oldval = entity->GetDefinedPropertyBySlot(propertydata->slot);
 
 			//KBE_DEBUG(TEXT("BaseApp::OnUpdatePropertys: %s(id=%d %s=%s), hasSetMethod=%p!"), *entity.className, eid, *propertydata.name, FVariant2FString(val), setmethod);
 
@@ -921,7 +922,7 @@ namespace KBEngine
 			else
 			{
 
-				entity->SetDefinedPropertyByUType(utype, val);
+				entity->SetDefinedPropertyBySlot(propertydata->slot, val);
 
 				//if (!setmethod)
 				//	return;
@@ -931,7 +932,7 @@ namespace KBEngine
 					if (entity->Inited())
 					{
 						//setmethod(entity, oldval);
-						entity->OnUpdateProperty(propertydata->name, val, oldval);
+						entity->OnUpdateProperty(*propertydata, val, oldval);
 					}
 				}
 				else
@@ -939,26 +940,26 @@ namespace KBEngine
 					if (entity->InWorld())
 					{
 						//setmethod(entity, oldval);
-						entity->OnUpdateProperty(propertydata->name, val, oldval);
+						entity->OnUpdateProperty(*propertydata, val, oldval);
 					}
 				}
 			}
 		}
 	}
 
-	void BaseApp::Client_onRemoteMethodCallOptimized(MemoryStream &stream)
+	void BaseApp::Client_onRemoteMethodCallOptimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 		OnRemoteMethodCall(eid, stream);
 	}
 
-	void BaseApp::Client_onRemoteMethodCall(MemoryStream &stream)
+	void BaseApp::Client_onRemoteMethodCall(MemoryStreamView &stream)
 	{
 		int32 eid = stream.ReadInt32();
 		OnRemoteMethodCall(eid, stream);
 	}
 
-	void BaseApp::OnRemoteMethodCall(int32 eid, MemoryStream& stream)
+	void BaseApp::OnRemoteMethodCall(int32 eid, MemoryStreamView &stream)
 	{
 		Entity* entity = FindEntity(eid);
 
@@ -983,21 +984,19 @@ namespace KBEngine
 
 		Method* methoddata = module->GetMethod(methodUtype);
 
-		//KBE_DEBUG(TEXT("BaseApp::OnRemoteMethodCall: %s.%s"), *entity->ClassName(), *methoddata->name);
-
-		FVariantArray args;
-		args.SetNum(methoddata->args.Num());
-
-		for (int i = 0; i<methoddata->args.Num(); i++)
+		if (!methoddata)
 		{
-			args[i] = methoddata->args[i]->CreateFromStream(&stream);
+			KBE_ERROR(TEXT("BaseApp::OnRemoteMethodCall: method(%d) not found! entity: %s(%d)"), methodUtype, *entity->ClassName(), eid);
+			return;
 		}
 
-		//methoddata.handler.Invoke(entity, args);
-		entity->RemoteMethodCall(methoddata->name, args);
+		//KBE_DEBUG(TEXT("BaseApp::OnRemoteMethodCall: %s.%s"), *entity->ClassName(), *methoddata->name);
+
+		// 参数由实体按方法声明的类型直接从数据流中解码
+		entity->RemoteMethodCall(*methoddata, stream);
 	}
 
-	void BaseApp::Client_onEntityEnterWorld(MemoryStream &stream)
+	void BaseApp::Client_onEntityEnterWorld(MemoryStreamView &stream)
 	{
 		int32 eid = stream.ReadInt32();
 		if (entity_id_ > 0 && entity_id_ != eid)
@@ -1035,8 +1034,8 @@ namespace KBEngine
 		Entity* entity = FindEntity(eid);
 		if (!entity)
 		{
-			MemoryStream* entityMessage = FindBufferedCreateEntityMessage(eid);
-			if (!entityMessage)
+			MemoryStreamView entityMessage;
+			if (!bufferedCreateEntityMessage_.Find(eid, entityMessage))
 			{
 				KBE_ERROR(TEXT("BaseApp::Client_onEntityEnterWorld: entity(%d) not found!"), eid);
 				return;
@@ -1047,7 +1046,6 @@ namespace KBEngine
 			{
 				KBE_ERROR(TEXT("BaseApp::Client_onEntityEnterWorld: not found module '%s'!"), *entityType);
 				bufferedCreateEntityMessage_.Remove(eid);
-				SAFE_DELETE(entityMessage);
 				return;
 			}
 
@@ -1056,24 +1054,22 @@ namespace KBEngine
 			{
 				KBE_ERROR(TEXT("BaseApp::Client_onEntityEnterWorld: module '%s' has no entity script!"), *entityType);
 				bufferedCreateEntityMessage_.Remove(eid);
-				SAFE_DELETE(entityMessage);
 				return;
 			}
 
-			auto *mb = new Mailbox(eid, entityType, Mailbox::MAILBOX_TYPE::MAILBOX_TYPE_CELL);
+			auto *mb = module->CreateMailbox(eid, Mailbox::MAILBOX_TYPE::MAILBOX_TYPE_CELL);
 			entity->CellMailbox(mb);
 
 			entities_.Add(eid, entity);
 
-			Client_onUpdatePropertys(*entityMessage);
+			OnUpdatePropertys(eid, entityMessage);
 			bufferedCreateEntityMessage_.Remove(eid);
-			SAFE_DELETE(entityMessage);
 
 			entity->IsOnGround(isOnGround > 0);
 
 			if (parentID > 0)
 			{
-				// ܸǷڣӦ
+				// 不管父对象是否存在，都应该设置这个
 				entity->parentID_ = parentID;
 
 				Entity* parentEntity = FindEntity(parentID);
@@ -1083,8 +1079,9 @@ namespace KBEngine
 				}
 				else
 				{
-					// @TODO(penghuawei): ｫҪǵȸһ֣ԱӽϵĲ飬
-					//                    ȻҲʹԼentity.enterWorld()parentIDparent״̬Լ
+					// @TODO(penghuawei): 这里将来需要考虑等父对象过来后再一起出现，以避免视角上的不良体验，
+					//                    当然，也可以让使用者自己在entity.enterWorld()里面根据parentID和parent状态自己处理。
+					AddPendingChild(parentID, eid);
 				}
 			}
 
@@ -1096,31 +1093,29 @@ namespace KBEngine
 			if (app_->IsOnInitCallPropertysSetMethods())
 				entity->CallPropertysSetMethods();
 
-			// ֪ͨentityµentityˣ
-			// entityentityָ
-			// @TODO(penghuawei): ǰȼ򵥱ԿŻֻиentity㲥ԉܡ
-			for (auto iter : entities_)
-			{
-				if (iter.Value->parentID_ == entity->ID())
-					iter.Value->SetParent(entity);
-			}
+			// 通知正在等待该entity的子对象，有新的entity出现了，
+			// 以让其它依赖该entity的子类entity能指向它
+			AttachPendingChildren(entity);
 		}
 		else
 		{
-			// ϣֻҶʱŻߵ
-			//KBE_ASSERT(entity->ID() == entity_id_);		//changeToRealʱҰentityҲߵҪע͵
+			// 理论上，只有玩家断线重连的时候才会走到这里
+			//KBE_ASSERT(entity->ID() == entity_id_);		//玩家changeToReal时视野内其他entity也会走到这儿，因此需要注释掉
 			if (!entity->InWorld())
 			{
 				KBE_DEBUG(TEXT("BaseApp::Client_onEntityEnterWorld: entity(%d) EnterWorld."), eid);
 
-				// ȫ һ
-				// ʹgiveClientToлȨ
-				// ֮ǰʵѾ磬 лʵҲ磬 ܻ֮ǰǸʵϢ
+				// 安全起见， 这里清空一下
+				// 如果服务端上使用giveClientTo切换控制权
+				// 之前的实体已经进入世界， 切换后的实体也进入世界， 这里可能会残留之前那个实体进入世界的信息
 				entityIDAliasIDList_.Reset();
 				ClearEntities(false);
 				entities_.Add(entity->ID(), entity);
 
-				auto *mb = new Mailbox(eid, entityType, Mailbox::MAILBOX_TYPE::MAILBOX_TYPE_CELL);
+				if (entity->CellMailbox())
+					entity->scriptModule_->ReleaseMailbox(entity->CellMailbox());
+
+				auto *mb = entity->scriptModule_->CreateMailbox(eid, Mailbox::MAILBOX_TYPE::MAILBOX_TYPE_CELL);
 				entity->CellMailbox(mb);
 
 				entity->IsOnGround(isOnGround > 0);
@@ -1137,7 +1132,7 @@ namespace KBEngine
 		}
 	}
 
-	void BaseApp::Client_onEntityLeaveWorldOptimized(MemoryStream &stream)
+	void BaseApp::Client_onEntityLeaveWorldOptimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 		Client_onEntityLeaveWorld(eid);
@@ -1159,18 +1154,21 @@ namespace KBEngine
 		if (entity_id_ == eid)
 		{
 			ClearSpace(false);
+
+			if (entity->CellMailbox())
+				entity->scriptModule_->ReleaseMailbox(entity->CellMailbox());
 			entity->CellMailbox(nullptr);
 		}
 		else
 		{
 			controlledEntities_.Remove(entity);
 			entities_.Remove(eid);
-			entity->Destroy();
+			DestroyEntity(entity);
 			entityIDAliasIDList_.Remove(eid);
 		}
 	}
 
-	void BaseApp::Client_onEntityEnterSpace(MemoryStream &stream)
+	void BaseApp::Client_onEntityEnterSpace(MemoryStreamView &stream)
 	{
 		int32 eid = stream.ReadInt32();
 		spaceID_ = stream.ReadUint32();
@@ -1217,7 +1215,7 @@ namespace KBEngine
 			KBEPersonality::Instance()->OnAddSpaceGeometryMapping(spaceID, respath);
 	}
 
-	void BaseApp::Client_initSpaceData(MemoryStream &stream)
+	void BaseApp::Client_initSpaceData(MemoryStreamView &stream)
 	{
 		ClearSpace(false);
 		spaceID_ = stream.ReadUint32();
@@ -1288,7 +1286,7 @@ namespace KBEngine
 
 		controlledEntities_.Remove(entity);
 		entities_.Remove(eid);
-		entity->Destroy();
+		DestroyEntity(entity);
 	}
 
 	void BaseApp::Client_onUpdateBasePos(float x, float y, float z)
@@ -1317,7 +1315,7 @@ namespace KBEngine
 		Client_onUpdateBasePos(x, old.Y, z);
 	}
 
-	void BaseApp::Client_onUpdateBaseDir(MemoryStream &stream)
+	void BaseApp::Client_onUpdateBaseDir(MemoryStreamView &stream)
 	{
 		FVector direction(0.0);
 		direction.X = stream.ReadFloat();
@@ -1341,7 +1339,7 @@ namespace KBEngine
 		}
 	}
 
-	void BaseApp::Client_onUpdateData(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1353,7 +1351,7 @@ namespace KBEngine
 		}
 	}
 
-	void BaseApp::Client_onSetEntityPosAndDir(MemoryStream &stream)
+	void BaseApp::Client_onSetEntityPosAndDir(MemoryStreamView &stream)
 	{
 		int32 eid = stream.ReadInt32();
 
@@ -1379,7 +1377,7 @@ namespace KBEngine
 		entity->OnDirectionSet(KBEMath::KBEngine2UnrealDirection(direction));
 	}
 
-	void BaseApp::Client_onUpdateData_ypr_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_ypr_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1390,7 +1388,7 @@ namespace KBEngine
 		UpdateVolatileData(eid,FLT_MAX, FLT_MAX, FLT_MAX, y, p, r, -1, true);
 	}
 
-	void BaseApp::Client_onUpdateData_yp_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_yp_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1400,7 +1398,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, FLT_MAX, FLT_MAX, FLT_MAX, y, p, KBEDATATYPE_BASE::KBE_FLT_MAX, -1, true);
 	}
 
-	void BaseApp::Client_onUpdateData_yr_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_yr_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1410,7 +1408,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, FLT_MAX, FLT_MAX, FLT_MAX, y, KBEDATATYPE_BASE::KBE_FLT_MAX, r, -1, true);
 	}
 
-	void BaseApp::Client_onUpdateData_pr_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_pr_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1420,7 +1418,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, FLT_MAX, FLT_MAX, FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, p, r, -1, true);
 	}
 
-	void BaseApp::Client_onUpdateData_y_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_y_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1429,7 +1427,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, FLT_MAX, FLT_MAX, FLT_MAX, y, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, -1, true);
 	}
 
-	void BaseApp::Client_onUpdateData_p_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_p_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1438,7 +1436,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, FLT_MAX, FLT_MAX, FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, p, KBEDATATYPE_BASE::KBE_FLT_MAX, -1, true);
 	}
 
-	void BaseApp::Client_onUpdateData_r_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_r_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1447,196 +1445,220 @@ namespace KBEngine
 		UpdateVolatileData(eid, FLT_MAX, FLT_MAX, FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, r, -1, true);
 	}
 
-	void BaseApp::Client_onUpdateData_xz_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_xz_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
-		FVector2D xz = stream.ReadPackXZ();
+		uint8 packedXZ[3];
+		stream.Read(packedXZ, sizeof(packedXZ));
 
-		UpdateVolatileData(eid, xz[0], FLT_MAX, xz[1], KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, 1, true);
+		UpdatePackedVolatileData(eid, packedXZ, nullptr, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, 1);
 	}
 
-	void BaseApp::Client_onUpdateData_xz_ypr_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_xz_ypr_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
-		FVector2D xz = stream.ReadPackXZ();
+		uint8 packedXZ[3];
+		stream.Read(packedXZ, sizeof(packedXZ));
 
 		int8 y = stream.ReadInt8();
 		int8 p = stream.ReadInt8();
 		int8 r = stream.ReadInt8();
 
-		UpdateVolatileData(eid, xz[0], FLT_MAX, xz[1], y, p, r, 1, true);
+		UpdatePackedVolatileData(eid, packedXZ, nullptr, y, p, r, 1);
 	}
 
-	void BaseApp::Client_onUpdateData_xz_yp_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_xz_yp_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
-		FVector2D xz = stream.ReadPackXZ();
+		uint8 packedXZ[3];
+		stream.Read(packedXZ, sizeof(packedXZ));
 
 		int8 y = stream.ReadInt8();
 		int8 p = stream.ReadInt8();
 
-		UpdateVolatileData(eid, xz[0], FLT_MAX, xz[1], y, p, KBEDATATYPE_BASE::KBE_FLT_MAX, 1, true);
+		UpdatePackedVolatileData(eid, packedXZ, nullptr, y, p, KBEDATATYPE_BASE::KBE_FLT_MAX, 1);
 	}
 
-	void BaseApp::Client_onUpdateData_xz_yr_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_xz_yr_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
-		FVector2D xz = stream.ReadPackXZ();
+		uint8 packedXZ[3];
+		stream.Read(packedXZ, sizeof(packedXZ));
 
 		int8 y = stream.ReadInt8();
 		int8 r = stream.ReadInt8();
 
-		UpdateVolatileData(eid, xz[0], FLT_MAX, xz[1], y, KBEDATATYPE_BASE::KBE_FLT_MAX, r, 1, true);
+		UpdatePackedVolatileData(eid, packedXZ, nullptr, y, KBEDATATYPE_BASE::KBE_FLT_MAX, r, 1);
 	}
 
-	void BaseApp::Client_onUpdateData_xz_pr_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_xz_pr_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
-		FVector2D xz = stream.ReadPackXZ();
+		uint8 packedXZ[3];
+		stream.Read(packedXZ, sizeof(packedXZ));
 
 		int8 p = stream.ReadInt8();
 		int8 r = stream.ReadInt8();
 
-		UpdateVolatileData(eid, xz[0], FLT_MAX, xz[1], KBEDATATYPE_BASE::KBE_FLT_MAX, p, r, 1, true);
+		UpdatePackedVolatileData(eid, packedXZ, nullptr, KBEDATATYPE_BASE::KBE_FLT_MAX, p, r, 1);
 	}
 
-	void BaseApp::Client_onUpdateData_xz_y_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_xz_y_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
-		FVector2D xz = stream.ReadPackXZ();
+		uint8 packedXZ[3];
+		stream.Read(packedXZ, sizeof(packedXZ));
 		int8 yaw = stream.ReadInt8();
-		UpdateVolatileData(eid, xz[0], FLT_MAX, xz[1], yaw, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, 1, true);
+		UpdatePackedVolatileData(eid, packedXZ, nullptr, yaw, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, 1);
 	}
 
-	void BaseApp::Client_onUpdateData_xz_p_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_xz_p_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
-		FVector2D xz = stream.ReadPackXZ();
+		uint8 packedXZ[3];
+		stream.Read(packedXZ, sizeof(packedXZ));
 
 		int8 p = stream.ReadInt8();
 
-		UpdateVolatileData(eid, xz[0], FLT_MAX, xz[1], KBEDATATYPE_BASE::KBE_FLT_MAX, p, KBEDATATYPE_BASE::KBE_FLT_MAX, 1, true);
+		UpdatePackedVolatileData(eid, packedXZ, nullptr, KBEDATATYPE_BASE::KBE_FLT_MAX, p, KBEDATATYPE_BASE::KBE_FLT_MAX, 1);
 	}
 
-	void BaseApp::Client_onUpdateData_xz_r_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_xz_r_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
-		FVector2D xz = stream.ReadPackXZ();
+		uint8 packedXZ[3];
+		stream.Read(packedXZ, sizeof(packedXZ));
 
 		int8 r = stream.ReadInt8();
 
-		UpdateVolatileData(eid, xz[0], FLT_MAX, xz[1], KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, r, 1, true);
+		UpdatePackedVolatileData(eid, packedXZ, nullptr, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, r, 1);
 	}
 
-	void BaseApp::Client_onUpdateData_xyz_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_xyz_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
-		FVector2D xz = stream.ReadPackXZ();
-		float y = stream.ReadPackY();
+		uint8 packedXZ[3];
+		stream.Read(packedXZ, sizeof(packedXZ));
+		uint8 packedY[2];
+		stream.Read(packedY, sizeof(packedY));
 
-		UpdateVolatileData(eid, xz[0], y, xz[1], KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, 0, true);
+		UpdatePackedVolatileData(eid, packedXZ, packedY, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, 0);
 	}
 
-	void BaseApp::Client_onUpdateData_xyz_ypr_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_xyz_ypr_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
-		FVector2D xz = stream.ReadPackXZ();
-		float y = stream.ReadPackY();
+		uint8 packedXZ[3];
+		stream.Read(packedXZ, sizeof(packedXZ));
+		uint8 packedY[2];
+		stream.Read(packedY, sizeof(packedY));
 
 		int8 yaw = stream.ReadInt8();
 		int8 p = stream.ReadInt8();
 		int8 r = stream.ReadInt8();
 
-		UpdateVolatileData(eid, xz[0], y, xz[1], yaw, p, r, 0, true);
+		UpdatePackedVolatileData(eid, packedXZ, packedY, yaw, p, r, 0);
 	}
 
-	void BaseApp::Client_onUpdateData_xyz_yp_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_xyz_yp_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
-		FVector2D xz = stream.ReadPackXZ();
-		float y = stream.ReadPackY();
+		uint8 packedXZ[3];
+		stream.Read(packedXZ, sizeof(packedXZ));
+		uint8 packedY[2];
+		stream.Read(packedY, sizeof(packedY));
 
 		int8 yaw = stream.ReadInt8();
 		int8 p = stream.ReadInt8();
 
-		UpdateVolatileData(eid, xz[0], y, xz[1], yaw, p, KBEDATATYPE_BASE::KBE_FLT_MAX, 0, true);
+		UpdatePackedVolatileData(eid, packedXZ, packedY, yaw, p, KBEDATATYPE_BASE::KBE_FLT_MAX, 0);
 	}
 
-	void BaseApp::Client_onUpdateData_xyz_yr_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_xyz_yr_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
-		FVector2D xz = stream.ReadPackXZ();
-		float y = stream.ReadPackY();
+		uint8 packedXZ[3];
+		stream.Read(packedXZ, sizeof(packedXZ));
+		uint8 packedY[2];
+		stream.Read(packedY, sizeof(packedY));
 
 		int8 yaw = stream.ReadInt8();
 		int8 r = stream.ReadInt8();
 
-		UpdateVolatileData(eid, xz[0], y, xz[1], yaw, KBEDATATYPE_BASE::KBE_FLT_MAX, r, 0, true);
+		UpdatePackedVolatileData(eid, packedXZ, packedY, yaw, KBEDATATYPE_BASE::KBE_FLT_MAX, r, 0);
 	}
 
-	void BaseApp::Client_onUpdateData_xyz_pr_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_xyz_pr_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
-		FVector2D xz = stream.ReadPackXZ();
-		float y = stream.ReadPackY();
+		uint8 packedXZ[3];
+		stream.Read(packedXZ, sizeof(packedXZ));
+		uint8 packedY[2];
+		stream.Read(packedY, sizeof(packedY));
 
 		int8 p = stream.ReadInt8();
 		int8 r = stream.ReadInt8();
 
-		UpdateVolatileData(eid, xz[0], y, xz[1], KBEDATATYPE_BASE::KBE_FLT_MAX, p, r, 0, true);
+		UpdatePackedVolatileData(eid, packedXZ, packedY, KBEDATATYPE_BASE::KBE_FLT_MAX, p, r, 0);
 	}
 
-	void BaseApp::Client_onUpdateData_xyz_y_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_xyz_y_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
-		FVector2D xz = stream.ReadPackXZ();
-		float y = stream.ReadPackY();
+		uint8 packedXZ[3];
+		stream.Read(packedXZ, sizeof(packedXZ));
+		uint8 packedY[2];
+		stream.Read(packedY, sizeof(packedY));
 
 		int8 yaw = stream.ReadInt8();
-		UpdateVolatileData(eid, xz[0], y, xz[1], yaw, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, 0, true);
+		UpdatePackedVolatileData(eid, packedXZ, packedY, yaw, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, 0);
 	}
 
-	void BaseApp::Client_onUpdateData_xyz_p_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_xyz_p_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
-		FVector2D xz = stream.ReadPackXZ();
-		float y = stream.ReadPackY();
+		uint8 packedXZ[3];
+		stream.Read(packedXZ, sizeof(packedXZ));
+		uint8 packedY[2];
+		stream.Read(packedY, sizeof(packedY));
 
 		int8 p = stream.ReadInt8();
 
-		UpdateVolatileData(eid, xz[0], y, xz[1], KBEDATATYPE_BASE::KBE_FLT_MAX, p, KBEDATATYPE_BASE::KBE_FLT_MAX, 0, true);
+		UpdatePackedVolatileData(eid, packedXZ, packedY, KBEDATATYPE_BASE::KBE_FLT_MAX, p, KBEDATATYPE_BASE::KBE_FLT_MAX, 0);
 	}
 
-	void BaseApp::Client_onUpdateData_xyz_r_optimized(MemoryStream &stream)
+	void BaseApp::Client_onUpdateData_xyz_r_optimized(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
-		FVector2D xz = stream.ReadPackXZ();
-		float y = stream.ReadPackY();
+		uint8 packedXZ[3];
+		stream.Read(packedXZ, sizeof(packedXZ));
+		uint8 packedY[2];
+		stream.Read(packedY, sizeof(packedY));
 
 		int8 r = stream.ReadInt8();
 
-		UpdateVolatileData(eid, xz[0], y, xz[1], KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, r, 0, true);
+		UpdatePackedVolatileData(eid, packedXZ, packedY, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, r, 0);
 	}
 
 
 
 
-	void BaseApp::Client_onUpdateData_ypr(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_ypr(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1647,7 +1669,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, FLT_MAX, FLT_MAX, FLT_MAX, y, p, r, -1, false);
 	}
 
-	void BaseApp::Client_onUpdateData_yp(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_yp(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1657,7 +1679,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, FLT_MAX, FLT_MAX, FLT_MAX, y, p, KBEDATATYPE_BASE::KBE_FLT_MAX, -1, false);
 	}
 
-	void BaseApp::Client_onUpdateData_yr(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_yr(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1667,7 +1689,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, FLT_MAX, FLT_MAX, FLT_MAX, y, KBEDATATYPE_BASE::KBE_FLT_MAX, r, -1, false);
 	}
 
-	void BaseApp::Client_onUpdateData_pr(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_pr(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1677,7 +1699,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, FLT_MAX, FLT_MAX, FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, p, r, -1, false);
 	}
 
-	void BaseApp::Client_onUpdateData_y(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_y(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1686,7 +1708,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, FLT_MAX, FLT_MAX, FLT_MAX, y, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, -1, false);
 	}
 
-	void BaseApp::Client_onUpdateData_p(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_p(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1695,7 +1717,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, FLT_MAX, FLT_MAX, FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, p, KBEDATATYPE_BASE::KBE_FLT_MAX, -1, false);
 	}
 
-	void BaseApp::Client_onUpdateData_r(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_r(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1704,7 +1726,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, FLT_MAX, FLT_MAX, FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, r, -1, false);
 	}
 
-	void BaseApp::Client_onUpdateData_xz(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_xz(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1714,7 +1736,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, x, FLT_MAX, z, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, 1, false);
 	}
 
-	void BaseApp::Client_onUpdateData_xz_ypr(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_xz_ypr(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1728,7 +1750,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, x, FLT_MAX, z, y, p, r, 1, false);
 	}
 
-	void BaseApp::Client_onUpdateData_xz_yp(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_xz_yp(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1741,7 +1763,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, x, FLT_MAX, z, y, p, KBEDATATYPE_BASE::KBE_FLT_MAX, 1, false);
 	}
 
-	void BaseApp::Client_onUpdateData_xz_yr(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_xz_yr(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1754,7 +1776,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, x, FLT_MAX, z, y, KBEDATATYPE_BASE::KBE_FLT_MAX, r, 1, false);
 	}
 
-	void BaseApp::Client_onUpdateData_xz_pr(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_xz_pr(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1767,7 +1789,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, x, FLT_MAX, z, KBEDATATYPE_BASE::KBE_FLT_MAX, p, r, 1, false);
 	}
 
-	void BaseApp::Client_onUpdateData_xz_y(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_xz_y(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1779,7 +1801,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, x, FLT_MAX, z, y, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, 1, false);
 	}
 
-	void BaseApp::Client_onUpdateData_xz_p(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_xz_p(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1791,7 +1813,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, x, FLT_MAX, z, KBEDATATYPE_BASE::KBE_FLT_MAX, p, KBEDATATYPE_BASE::KBE_FLT_MAX, 1, false);
 	}
 
-	void BaseApp::Client_onUpdateData_xz_r(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_xz_r(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1803,7 +1825,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, x, FLT_MAX, z, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, r, 1, false);
 	}
 
-	void BaseApp::Client_onUpdateData_xyz(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_xyz(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1814,7 +1836,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, x, y, z, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, 0, false);
 	}
 
-	void BaseApp::Client_onUpdateData_xyz_ypr(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_xyz_ypr(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1829,7 +1851,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, x, y, z, yaw, p, r, 0, false);
 	}
 
-	void BaseApp::Client_onUpdateData_xyz_yp(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_xyz_yp(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1843,7 +1865,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, x, y, z, yaw, p, KBEDATATYPE_BASE::KBE_FLT_MAX, 0, false);
 	}
 
-	void BaseApp::Client_onUpdateData_xyz_yr(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_xyz_yr(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1857,7 +1879,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, x, y, z, yaw, KBEDATATYPE_BASE::KBE_FLT_MAX, r, 0, false);
 	}
 
-	void BaseApp::Client_onUpdateData_xyz_pr(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_xyz_pr(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1871,7 +1893,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, x, y, z, KBEDATATYPE_BASE::KBE_FLT_MAX, p, r, 0, false);
 	}
 
-	void BaseApp::Client_onUpdateData_xyz_y(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_xyz_y(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1884,7 +1906,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, x, y, z, yaw, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, 0, false);
 	}
 
-	void BaseApp::Client_onUpdateData_xyz_p(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_xyz_p(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1897,7 +1919,7 @@ namespace KBEngine
 		UpdateVolatileData(eid, x, y, z, KBEDATATYPE_BASE::KBE_FLT_MAX, p, KBEDATATYPE_BASE::KBE_FLT_MAX, 0, false);
 	}
 
-	void BaseApp::Client_onUpdateData_xyz_r(MemoryStream& stream)
+	void BaseApp::Client_onUpdateData_xyz_r(MemoryStreamView &stream)
 	{
 		int32 eid = GetAoiEntityIDFromStream(stream);
 
@@ -1910,72 +1932,142 @@ namespace KBEngine
 		UpdateVolatileData(eid, x, y, z, KBEDATATYPE_BASE::KBE_FLT_MAX, KBEDATATYPE_BASE::KBE_FLT_MAX, r, 0, false);
 	}
 
-	void BaseApp::UpdateVolatileData(int32 entityID, float x, float y, float z, float yaw, float pitch, float roll, int8 isOnGround, bool isOptimized)
+	uint8 BaseApp::DecodeVolatileAngles(float yaw, float pitch, float roll, bool isOptimized, FVector& angles)
 	{
-		Entity* entity = FindEntity(entityID);
-		if (!entity)
-		{
-			// Ϊ0ҿͻһص½ҷentityڶڼһֱ״̬
-			// Ժ, ΪcellappһֱbaseappͬϢ ͻʱδ
-			// ˳ʼ迪ʼյͬϢ, ʱͻ
-			KBE_ERROR(TEXT("BaseApp::UpdateVolatileData: entity(%d) not found!"), entityID);
-			return;
-		}
-
-		// С0
-		if (isOnGround >= 0)
-		{
-			entity->IsOnGround(isOnGround > 0);
-		}
-
-		bool changeDirection = false;
-		FVector direction = KBEMath::Unreal2KBEngineDirection(entity->localDirection_);
+		uint8 flags = 0;
+		angles = FVector(0.0);
 
 		if (roll != KBEDATATYPE_BASE::KBE_FLT_MAX)
 		{
-			changeDirection = true;
+			flags |= VolatileDataBatch::HAS_ROLL;
 			if (isOptimized) 
 			{
-				direction.X = KBEMath::int82angle((int8)roll, false);
+				angles.X = KBEMath::int82angle((int8)roll, false);
 			}
 			else 
 			{
-				direction.X = roll;
+				angles.X = roll;
 			}
 		}
 
 		if (pitch != KBEDATATYPE_BASE::KBE_FLT_MAX)
 		{
-			changeDirection = true;
+			flags |= VolatileDataBatch::HAS_PITCH;
 			if (isOptimized)
 			{
-				direction.Y = KBEMath::int82angle((int8)pitch, false);
+				angles.Y = KBEMath::int82angle((int8)pitch, false);
 			}
 			else
 			{
-				direction.Y = pitch;
+				angles.Y = pitch;
 			}
 		}
 
 		if (yaw != KBEDATATYPE_BASE::KBE_FLT_MAX)
 		{
-			changeDirection = true;
+			flags |= VolatileDataBatch::HAS_YAW;
 			if (isOptimized)
 			{
-				direction.Z = KBEMath::int82angle((int8)yaw, false);
+				angles.Z = KBEMath::int82angle((int8)yaw, false);
 			}
 			else
 			{
-				direction.Z = yaw;
+				angles.Z = yaw;
 			}
 		}
 
-		direction = KBEMath::KBEngine2UnrealDirection(direction);
+		return flags;
+	}
+
+	void BaseApp::UpdateVolatileData(int32 entityID, float x, float y, float z, float yaw, float pitch, float roll, int8 isOnGround, bool isOptimized)
+	{
+		FVector angles;
+		uint8 flags = DecodeVolatileAngles(yaw, pitch, roll, isOptimized, angles);
+
+		if (x != FLT_MAX || y != FLT_MAX || z != FLT_MAX)
+			flags |= VolatileDataBatch::HAS_POSITION;
+
+		if (x == FLT_MAX) x = 0.0;
+		if (y == FLT_MAX) y = 0.0;
+		if (z == FLT_MAX) z = 0.0;
+
+		FVector pos = KBEMath::KBEngine2UnrealPosition(FVector(x, y, z));
+
+		// 没有父类时以主角为中心计算世界坐标，这里记下当前主角的服务器坐标
+		FVector posOffset = isOptimized ? entityServerPos_ : FVector::ZeroVector;
+
+		if (app_->UseVolatileDataBatch())
+		{
+			volatileDataBatch_.Add(entityID, flags, pos, posOffset, angles, isOnGround);
+			return;
+		}
+
+		Entity* entity = FindEntity(entityID);
+		if (!entity)
+		{
+			// 如果为0且客户端上一步是重登陆或者重连操作并且服务端entity在断线期间一直处于在线状态
+			// 则可以忽略这个错误, 因为cellapp可能一直在向baseapp发送同步消息， 当客户端重连上时未等
+			// 服务端初始化步骤开始则收到同步信息, 此时这里就会出错。
+			KBE_ERROR(TEXT("BaseApp::UpdateVolatileData: entity(%d) not found!"), entityID);
+			return;
+		}
+
+		ApplyVolatileData(entity, flags, pos, posOffset, angles, isOnGround);
+	}
+
+	void BaseApp::UpdatePackedVolatileData(int32 entityID, const uint8* packedXZ, const uint8* packedY, float yaw, float pitch, float roll, int8 isOnGround)
+	{
+		// 批量应用时保留压缩的原始数据，在ApplyVolatileDataBatch中与本帧其它实体的坐标一起批量解码
+		if (app_->UseVolatileDataBatch())
+		{
+			FVector angles;
+			uint8 flags = DecodeVolatileAngles(yaw, pitch, roll, true, angles);
+			volatileDataBatch_.AddPacked(entityID, flags, packedXZ, packedY, entityServerPos_, angles, isOnGround);
+			return;
+		}
+
+		float x, z;
+		PackedFloat::DecodeXZ(PackedFloat::LoadXZ(packedXZ), x, z);
+
+		float y = FLT_MAX;
+		if (packedY)
+		{
+			uint16 data;
+			FMemory::Memcpy(&data, packedY, sizeof(data));
+			y = PackedFloat::DecodeY(data);
+		}
+
+		UpdateVolatileData(entityID, x, y, z, yaw, pitch, roll, isOnGround, true);
+	}
 
-		// и븸мõ糯
+	bool BaseApp::ApplyVolatileData(Entity* entity, uint8 flags, FVector pos, const FVector& posOffset, const FVector& angles, int8 isOnGround)
+	{
+		// 小于0不设置
+		if (isOnGround >= 0)
+		{
+			entity->IsOnGround(isOnGround > 0);
+		}
+
+		bool changeDirection = (flags & VolatileDataBatch::HAS_DIRECTION) != 0;
+		FVector direction;
+
+		// 如果有父类则与父类进行计算得到世界朝向
 		if (changeDirection)
 		{
-			// Ǹ±س˲Ƿи󣬶ȸ±س
+			direction = KBEMath::Unreal2KBEngineDirection(entity->localDirection_);
+
+			if (flags & VolatileDataBatch::HAS_ROLL)
+				direction.X = angles.X;
+
+			if (flags & VolatileDataBatch::HAS_PITCH)
+				direction.Y = angles.Y;
+
+			if (flags & VolatileDataBatch::HAS_YAW)
+				direction.Z = angles.Z;
+
+			direction = KBEMath::KBEngine2UnrealDirection(direction);
+
+			// 服务器总是更新本地朝向，因此不管是否有父对象，都先更新本地朝向
 			entity->localDirection_ = direction;
 
 			if (entity->ParentID() > 0)
@@ -1983,7 +2075,7 @@ namespace KBEngine
 				if (entity->Parent())
 					direction = entity->Parent()->DirectionLocalToWorld(direction);
 				else
-					changeDirection = false;  // parentIDҲparent entityֱӷ
+					changeDirection = false;  // 有parentID但找不到parent entity了则直接放弃
 			}
 		}
 
@@ -1994,31 +2086,23 @@ namespace KBEngine
 			done = true;
 		}
 		
-		bool positionChanged = x != FLT_MAX || y != FLT_MAX || z != FLT_MAX;
-		if (x == FLT_MAX) x = 0.0;
-		if (y == FLT_MAX) y = 0.0;
-		if (z == FLT_MAX) z = 0.0;
-
-		FVector pos(x, y, z);
-		pos = KBEMath::KBEngine2UnrealPosition(pos);
-
+		bool positionChanged = (flags & VolatileDataBatch::HAS_POSITION) != 0;
 		if (positionChanged)
 		{
 			if (entity->ParentID() > 0)
 			{
 				entity->localPosition_ = pos;
 				if (entity->Parent())
-					// и븸мõ糯
+					// 如果有父对象则与父对象进行计算得到世界朝向
 					pos = entity->Parent()->PositionLocalToWorld(entity->localPosition_);
 				else
-					// Ҳֱӷ
+					// 找不到父对象则直接放弃
 					positionChanged = false;
 			}
 			else
 			{
-				// ûиΪļ糯
-				if(isOptimized)
-					pos += entityServerPos_;
+				// 没有父类则以主角为中心计算世界朝向
+				pos += posOffset;
 				entity->localPosition_ = pos;
 			}
 		}
@@ -2031,9 +2115,63 @@ namespace KBEngine
 
 		if (done)
 		{
+			// 有父对象的实体随父对象移动，不做插值
+			if (app_->UseInterpolation() && entity->ParentID() == 0 && !entity->IsPlayer())
+			{
+				entity->AddSnapshot(FPlatformTime::Seconds(), app_->InterpolationDelay() / 1000.0);
+			}
+
 			entity->SyncVolatileDataToChildren(!changeDirection);
 			entity->OnUpdateVolatileData();
 		}
+
+		return done;
+	}
+
+	void BaseApp::ApplyVolatileDataBatch()
+	{
+		if (volatileDataBatch_.Num() == 0)
+			return;
+
+		volatileDataBatch_.DecodePackedPositions();
+		volatileUpdatedEntities_.Reset();
+
+		for (int32 i = 0; i < volatileDataBatch_.Num(); ++i)
+		{
+			int32 entityID = volatileDataBatch_.entityIDs[i];
+			Entity* entity = FindEntity(entityID);
+			if (!entity)
+			{
+				KBE_ERROR(TEXT("BaseApp::ApplyVolatileDataBatch: entity(%d) not found!"), entityID);
+				continue;
+			}
+
+			if (ApplyVolatileData(entity, volatileDataBatch_.flags[i], volatileDataBatch_.positions[i],
+				volatileDataBatch_.positionOffsets[i], volatileDataBatch_.angles[i], volatileDataBatch_.onGrounds[i]))
+			{
+				volatileUpdatedEntities_.Add(entity);
+			}
+		}
+
+		volatileDataBatch_.Reset();
+
+		if (volatileUpdatedEntities_.Num() > 0 && KBEPersonality::Instance())
+			KBEPersonality::Instance()->OnVolatileDataBatchApplied(volatileUpdatedEntities_);
+	}
+
+	void BaseApp::InterpolateEntities()
+	{
+		double renderTime = FPlatformTime::Seconds() - app_->InterpolationDelay() / 1000.0;
+		double maxExtrapolation = FMath::Max(app_->MaxExtrapolationTime(), 0) / 1000.0;
+
+		for (auto& item : entities_)
+		{
+			Entity* entity = item.Value;
+			if (entity->snapshots_.Num() == 0)
+				continue;
+
+			entity->snapshots_.Evaluate(renderTime, maxExtrapolation, entity->smoothedPosition_, entity->smoothedDirection_);
+		}
 	}
 
 	void BaseApp::Client_onAppActiveTickCB()
@@ -2049,7 +2187,7 @@ namespace KBEngine
 			KBEPersonality::Instance()->OnStreamDataStarted(id, datasize, descr);
 	}
 
-	void BaseApp::Client_onStreamDataRecv(MemoryStream &stream)
+	void BaseApp::Client_onStreamDataRecv(MemoryStreamView &stream)
 	{
 		if (KBEPersonality::Instance())
 			KBEPersonality::Instance()->OnStreamDataRecv(stream);
@@ -2070,20 +2208,32 @@ namespace KBEngine
 			return;
 		}
 
+		// 不再等待原来的父对象
+		if (!ent->parent_ && ent->parentID_ > 0)
+			RemovePendingChild(ent->parentID_, eid);
+
 		if (parentID <= 0)
 		{
 			ent->SetParent(nullptr);
+			ent->parentID_ = 0;
 			return;
 		}
 
 		Entity* parentEnt = FindEntity(parentID);
 		if (!parentEnt)
+		{
+			// 父对象为等待状态时，仍然需要先解除与当前父对象的关系
+			ent->SetParent(nullptr);
 			ent->parentID_ = parentID;
+			AddPendingChild(parentID, eid);
+		}
 		else
+		{
 			ent->SetParent(parentEnt);
+		}
 	}
 
-	void BaseApp::Client_acrossServerReady(MemoryStream & stream)
+	void BaseApp::Client_acrossServerReady(MemoryStreamView &stream)
 	{
 		UINT64 loginKey = stream.ReadUint64();
 		FString baseappHost = stream.ReadString();
@@ -2100,352 +2250,261 @@ namespace KBEngine
 		if (networkInterface_)
 		{
 			networkInterface_->Process();
-			messageReader_->Process();
 		}
 
+		// 本帧收到的易变数据在这里一次性应用
+		ApplyVolatileDataBatch();
+
+		if (app_->UseInterpolation())
+			InterpolateEntities();
+
+		bufferedCreateEntityMessage_.Tick();
+
 		if (networkInterface_ && networkInterface_->Valid())
 		{
 			UpdatePlayerToServer();
 			SendTick();
+
+			if (frameBundle_ && frameBundle_->PendingLength() > 0)
+			{
+				int32 maxLatency = app_->FrameBundleMaxLatency();
+				if (maxLatency <= 0 || (FPlatformTime::Seconds() - frameBundleStartTime_) * 1000.0 >= maxLatency)
+					FlushFrameBundle();
+			}
 		}
 	}
 
-
-	void BaseApp::HandleMessage(const FString &name, MemoryStream *stream)
+	void BaseApp::SendBundle(Bundle* bundle)
 	{
-		//KBE_ERROR(TEXT("shufeng--->>>BaseApp::HandleMessage MemoryStream *stream 1111:  message name (%s)! at time :%s: %d"), 
-		//	*name, *FDateTime::UtcNow().ToString(), FDateTime::UtcNow().GetMillisecond());
-		if (name == "Client_onHelloCB") {
-			Client_onHelloCB(*stream);
-		}
-		else if (name == "Client_onScriptVersionNotMatch") {
-			Client_onScriptVersionNotMatch(*stream);
-		}
-		else if (name == "Client_onVersionNotMatch") {
-			Client_onVersionNotMatch(*stream);
-		}
-		else if (name == "Client_onImportClientMessages") {
-			Client_onImportClientMessages(*stream);
-		}
-		else if (name == "Client_onImportClientEntityDef") {
-
-			Client_onImportClientEntityDef(*stream);
-		}
-		else if (name == "Client_onLoginBaseappSuccessfully") {
-
-			Client_onLoginBaseappSuccessfully(*stream);
-		}
-		else if (name == "Client_onReloginBaseappSuccessfully") {
-
-			Client_onReloginBaseappSuccessfully(*stream);
-		}
-		else if (name == "Client_onUpdatePropertysOptimized") {
-
-			Client_onUpdatePropertysOptimized(*stream);
-		}
-		else if (name == "Client_onUpdatePropertys") {
-
-			Client_onUpdatePropertys(*stream);
-		}
-		else if (name == "Client_onRemoteMethodCallOptimized") {
-
-			Client_onRemoteMethodCallOptimized(*stream);
-		}
-		else if (name == "Client_onRemoteMethodCall") {
-
-			Client_onRemoteMethodCall(*stream);
-		}
-		else if (name == "Client_onEntityEnterWorld") {
-
-			Client_onEntityEnterWorld(*stream);
-		}
-		else if (name == "Client_onEntityLeaveWorldOptimized") {
-
-			Client_onEntityLeaveWorldOptimized(*stream);
-		}
-		else if (name == "Client_onEntityEnterSpace") {
-
-			Client_onEntityEnterSpace(*stream);
-		}
-		else if (name == "Client_initSpaceData") {
-
-			Client_initSpaceData(*stream);
-		}
-		else if (name == "Client_onUpdateData") {
-
-			Client_onUpdateData(*stream);
-		}
-		else if (name == "Client_onSetEntityPosAndDir") {
-
-			Client_onSetEntityPosAndDir(*stream);
-		}
-		else if (name == "Client_onUpdateData_ypr") {
-
-			Client_onUpdateData_ypr(*stream);
-		}
-		else if (name == "Client_onUpdateData_yp") {
-
-			Client_onUpdateData_yp(*stream);
-		}
-		else if (name == "Client_onUpdateData_yr") {
-
-			Client_onUpdateData_yr(*stream);
-		}
-		else if (name == "Client_onUpdateData_pr") {
-
-			Client_onUpdateData_pr(*stream);
-		}
-		else if (name == "Client_onUpdateData_y") {
-
-			Client_onUpdateData_y(*stream);
-		}
-		else if (name == "Client_onUpdateData_p") {
-
-			Client_onUpdateData_p(*stream);
-		}
-		else if (name == "Client_onUpdateData_r") {
-
-			Client_onUpdateData_r(*stream);
-		}
-		else if (name == "Client_onUpdateData_xz") {
-
-			Client_onUpdateData_xz(*stream);
-		}
-		else if (name == "Client_onUpdateData_xz_ypr") {
-
-			Client_onUpdateData_xz_ypr(*stream);
-		}
-		else if (name == "Client_onUpdateData_xz_yp") {
-
-			Client_onUpdateData_xz_yp(*stream);
-		}
-		else if (name == "Client_onUpdateData_xz_yr") {
-
-			Client_onUpdateData_xz_yr(*stream);
-		}
-		else if (name == "Client_onUpdateData_xz_pr") {
-
-			Client_onUpdateData_xz_pr(*stream);
-		}
-		else if (name == "Client_onUpdateData_xz_y") {
-
-			Client_onUpdateData_xz_y(*stream);
-		}
-		else if (name == "Client_onUpdateData_xz_p") {
-
-			Client_onUpdateData_xz_p(*stream);
-		}
-		else if (name == "Client_onUpdateData_xz_r") {
-
-			Client_onUpdateData_xz_r(*stream);
-		}
-		else if (name == "Client_onUpdateData_xyz") {
-
-			Client_onUpdateData_xyz(*stream);
-		}
-		else if (name == "Client_onUpdateData_xyz_ypr") {
-
-			Client_onUpdateData_xyz_ypr(*stream);
-		}
-		else if (name == "Client_onUpdateData_xyz_yp") {
-
-			Client_onUpdateData_xyz_yp(*stream);
-		}
-		else if (name == "Client_onUpdateData_xyz_yr") {
-
-			Client_onUpdateData_xyz_yr(*stream);
-		}
-		else if (name == "Client_onUpdateData_xyz_pr") {
-
-			Client_onUpdateData_xyz_pr(*stream);
-		}
-		else if (name == "Client_onUpdateData_xyz_y") {
-
-			Client_onUpdateData_xyz_y(*stream);
-		}
-		else if (name == "Client_onUpdateData_xyz_p") {
-
-			Client_onUpdateData_xyz_p(*stream);
-		}
-		else if (name == "Client_onUpdateData_xyz_r") {
-
-			Client_onUpdateData_xyz_r(*stream);
-		}
-		else if (name == "Client_onUpdateData_ypr_optimized") {
-
-			Client_onUpdateData_ypr_optimized(*stream);
-		}
-		else if (name == "Client_onUpdateData_yp_optimized") {
-
-			Client_onUpdateData_yp_optimized(*stream);
-		}
-		else if (name == "Client_onUpdateData_yr_optimized") {
-
-			Client_onUpdateData_yr_optimized(*stream);
-		}
-		else if (name == "Client_onUpdateData_pr_optimized") {
-
-			Client_onUpdateData_pr_optimized(*stream);
-		}
-		else if (name == "Client_onUpdateData_y_optimized") {
-
-			Client_onUpdateData_y_optimized(*stream);
-		}
-		else if (name == "Client_onUpdateData_p_optimized") {
-
-			Client_onUpdateData_p_optimized(*stream);
-		}
-		else if (name == "Client_onUpdateData_r_optimized") {
-
-			Client_onUpdateData_r_optimized(*stream);
-		}
-		else if (name == "Client_onUpdateData_xz_optimized") {
-
-			Client_onUpdateData_xz_optimized(*stream);
-		}
-		else if (name == "Client_onUpdateData_xz_ypr_optimized") {
-
-			Client_onUpdateData_xz_ypr_optimized(*stream);
-		}
-		else if (name == "Client_onUpdateData_xz_yp_optimized") {
+		if (!app_->UseFrameBundle())
+		{
+			// 之前积攒的消息要先发出，以保证消息的顺序
+			if (frameBundle_ && frameBundle_->PendingLength() > 0)
+				FlushFrameBundle();
 
-			Client_onUpdateData_xz_yp_optimized(*stream);
+			bundle->Send(networkInterface_);
+			return;
 		}
-		else if (name == "Client_onUpdateData_xz_yr_optimized") {
 
-			Client_onUpdateData_xz_yr_optimized(*stream);
-		}
-		else if (name == "Client_onUpdateData_xz_pr_optimized") {
+		if (!frameBundle_)
+			frameBundle_ = new Bundle();
 
-			Client_onUpdateData_xz_pr_optimized(*stream);
-		}
-		else if (name == "Client_onUpdateData_xz_y_optimized") {
+		if (frameBundle_->PendingLength() == 0)
+			frameBundleStartTime_ = FPlatformTime::Seconds();
 
-			Client_onUpdateData_xz_y_optimized(*stream);
-		}
-		else if (name == "Client_onUpdateData_xz_p_optimized") {
+		frameBundle_->Absorb(bundle);
 
-			Client_onUpdateData_xz_p_optimized(*stream);
-		}
-		else if (name == "Client_onUpdateData_xz_r_optimized") {
-
-			Client_onUpdateData_xz_r_optimized(*stream);
-		}
-		else if (name == "Client_onUpdateData_xyz_optimized") {
-
-			Client_onUpdateData_xyz_optimized(*stream);
-		}
-		else if (name == "Client_onUpdateData_xyz_ypr_optimized") {
+		if (frameBundle_->PendingLength() >= app_->FrameBundleMaxBytes())
+			FlushFrameBundle();
+	}
 
-			Client_onUpdateData_xyz_ypr_optimized(*stream);
-		}
-		else if (name == "Client_onUpdateData_xyz_yp_optimized") {
+	void BaseApp::FlushFrameBundle()
+	{
+		if (!frameBundle_ || frameBundle_->PendingLength() == 0)
+			return;
 
-			Client_onUpdateData_xyz_yp_optimized(*stream);
+		if (!networkInterface_)
+		{
+			frameBundle_->Discard();
+			return;
 		}
-		else if (name == "Client_onUpdateData_xyz_yr_optimized") {
 
-			Client_onUpdateData_xyz_yr_optimized(*stream);
-		}
-		else if (name == "Client_onUpdateData_xyz_pr_optimized") {
+		frameBundle_->Send(networkInterface_);
+	}
+
+
+	const BaseApp::DispatchTable::HandlerMap& BaseApp::MessageHandlers()
+	{
+		// 只在第一次使用时构建，之后所有BaseApp实例共享
+		static const DispatchTable::HandlerMap handlers = []()
+		{
+			DispatchTable::HandlerMap handlers;
+
+			// 参数为原始数据流的消息
+			handlers.Add(TEXT("Client_onHelloCB"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onHelloCB>));
+			handlers.Add(TEXT("Client_onScriptVersionNotMatch"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onScriptVersionNotMatch>));
+			handlers.Add(TEXT("Client_onVersionNotMatch"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onVersionNotMatch>));
+			handlers.Add(TEXT("Client_onImportClientMessages"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onImportClientMessages>));
+			handlers.Add(TEXT("Client_onImportClientEntityDef"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onImportClientEntityDef>));
+			handlers.Add(TEXT("Client_onLoginBaseappSuccessfully"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onLoginBaseappSuccessfully>));
+			handlers.Add(TEXT("Client_onReloginBaseappSuccessfully"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onReloginBaseappSuccessfully>));
+			handlers.Add(TEXT("Client_onUpdatePropertysOptimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdatePropertysOptimized>));
+			handlers.Add(TEXT("Client_onUpdatePropertys"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdatePropertys>));
+			handlers.Add(TEXT("Client_onRemoteMethodCallOptimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onRemoteMethodCallOptimized>));
+			handlers.Add(TEXT("Client_onRemoteMethodCall"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onRemoteMethodCall>));
+			handlers.Add(TEXT("Client_onEntityEnterWorld"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onEntityEnterWorld>));
+			handlers.Add(TEXT("Client_onEntityLeaveWorldOptimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onEntityLeaveWorldOptimized>));
+			handlers.Add(TEXT("Client_onEntityEnterSpace"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onEntityEnterSpace>));
+			handlers.Add(TEXT("Client_initSpaceData"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_initSpaceData>));
+			handlers.Add(TEXT("Client_onUpdateData"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData>));
+			handlers.Add(TEXT("Client_onSetEntityPosAndDir"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onSetEntityPosAndDir>));
+			handlers.Add(TEXT("Client_onUpdateData_ypr"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_ypr>));
+			handlers.Add(TEXT("Client_onUpdateData_yp"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_yp>));
+			handlers.Add(TEXT("Client_onUpdateData_yr"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_yr>));
+			handlers.Add(TEXT("Client_onUpdateData_pr"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_pr>));
+			handlers.Add(TEXT("Client_onUpdateData_y"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_y>));
+			handlers.Add(TEXT("Client_onUpdateData_p"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_p>));
+			handlers.Add(TEXT("Client_onUpdateData_r"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_r>));
+			handlers.Add(TEXT("Client_onUpdateData_xz"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xz>));
+			handlers.Add(TEXT("Client_onUpdateData_xz_ypr"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xz_ypr>));
+			handlers.Add(TEXT("Client_onUpdateData_xz_yp"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xz_yp>));
+			handlers.Add(TEXT("Client_onUpdateData_xz_yr"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xz_yr>));
+			handlers.Add(TEXT("Client_onUpdateData_xz_pr"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xz_pr>));
+			handlers.Add(TEXT("Client_onUpdateData_xz_y"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xz_y>));
+			handlers.Add(TEXT("Client_onUpdateData_xz_p"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xz_p>));
+			handlers.Add(TEXT("Client_onUpdateData_xz_r"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xz_r>));
+			handlers.Add(TEXT("Client_onUpdateData_xyz"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xyz>));
+			handlers.Add(TEXT("Client_onUpdateData_xyz_ypr"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xyz_ypr>));
+			handlers.Add(TEXT("Client_onUpdateData_xyz_yp"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xyz_yp>));
+			handlers.Add(TEXT("Client_onUpdateData_xyz_yr"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xyz_yr>));
+			handlers.Add(TEXT("Client_onUpdateData_xyz_pr"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xyz_pr>));
+			handlers.Add(TEXT("Client_onUpdateData_xyz_y"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xyz_y>));
+			handlers.Add(TEXT("Client_onUpdateData_xyz_p"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xyz_p>));
+			handlers.Add(TEXT("Client_onUpdateData_xyz_r"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xyz_r>));
+			handlers.Add(TEXT("Client_onUpdateData_ypr_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_ypr_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_yp_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_yp_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_yr_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_yr_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_pr_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_pr_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_y_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_y_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_p_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_p_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_r_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_r_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_xz_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xz_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_xz_ypr_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xz_ypr_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_xz_yp_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xz_yp_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_xz_yr_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xz_yr_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_xz_pr_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xz_pr_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_xz_y_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xz_y_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_xz_p_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xz_p_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_xz_r_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xz_r_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_xyz_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xyz_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_xyz_ypr_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xyz_ypr_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_xyz_yp_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xyz_yp_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_xyz_yr_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xyz_yr_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_xyz_pr_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xyz_pr_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_xyz_y_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xyz_y_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_xyz_p_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xyz_p_optimized>));
+			handlers.Add(TEXT("Client_onUpdateData_xyz_r_optimized"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onUpdateData_xyz_r_optimized>));
+			handlers.Add(TEXT("Client_onStreamDataRecv"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_onStreamDataRecv>));
+			handlers.Add(TEXT("Client_onAppActiveTickCB"), DispatchTable::MakeEntry([](BaseApp* handler, MemoryStreamView&) { handler->Client_onAppActiveTickCB(); }));
+			handlers.Add(TEXT("Client_acrossServerReady"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&BaseApp::Client_acrossServerReady>));
+
+			// 参数已经被反序列化的消息
+			handlers.Add(TEXT("Client_onCreatedProxies"), DispatchTable::MakeEntry([](BaseApp* handler, const TArray<FVariant>& args) {
+				uint64 rndUUID = args[0].GetValue<uint64>();
+				int32 eid = args[1].GetValue<int32>();
+				FString entityType = args[2].GetValue<FString>();
+				handler->Client_onCreatedProxies(rndUUID, eid, entityType);
+			}));
+			handlers.Add(TEXT("Client_onEntityLeaveWorld"), DispatchTable::MakeEntry([](BaseApp* handler, const TArray<FVariant>& args) {
+				handler->Client_onEntityLeaveWorld(args[0].GetValue<int32>());
+			}));
+			handlers.Add(TEXT("Client_onEntityLeaveSpace"), DispatchTable::MakeEntry([](BaseApp* handler, const TArray<FVariant>& args) {
+				handler->Client_onEntityLeaveSpace(args[0].GetValue<int32>());
+			}));
+			handlers.Add(TEXT("Client_setSpaceData"), DispatchTable::MakeEntry([](BaseApp* handler, const TArray<FVariant>& args) {
+				handler->Client_setSpaceData(args[0].GetValue<uint32>(), args[1].GetValue<FString>(), args[2].GetValue<FString>());
+			}));
+			handlers.Add(TEXT("Client_delSpaceData"), DispatchTable::MakeEntry([](BaseApp* handler, const TArray<FVariant>& args) {
+				handler->Client_delSpaceData(args[0].GetValue<uint32>(), args[1].GetValue<FString>());
+			}));
+			handlers.Add(TEXT("Client_onControlEntity"), DispatchTable::MakeEntry([](BaseApp* handler, const TArray<FVariant>& args) {
+				handler->Client_onControlEntity(args[0].GetValue<int32>(), args[1].GetValue<int8>());
+			}));
+			handlers.Add(TEXT("Client_onStreamDataStarted"), DispatchTable::MakeEntry([](BaseApp* handler, const TArray<FVariant>& args) {
+				handler->Client_onStreamDataStarted(args[0].GetValue<int16>(), args[1].GetValue<uint32>(), args[2].GetValue<FString>());
+			}));
+			handlers.Add(TEXT("Client_onStreamDataCompleted"), DispatchTable::MakeEntry([](BaseApp* handler, const TArray<FVariant>& args) {
+				handler->Client_onStreamDataCompleted(args[0].GetValue<int16>());
+			}));
+			handlers.Add(TEXT("Client_onKicked"), DispatchTable::MakeEntry([](BaseApp* handler, const TArray<FVariant>& args) {
+				handler->Client_onKicked(args[0].GetValue<uint16>());
+			}));
+			handlers.Add(TEXT("Client_onUpdateBasePos"), DispatchTable::MakeEntry([](BaseApp* handler, const TArray<FVariant>& args) {
+				handler->Client_onUpdateBasePos(args[0].GetValue<float>(), args[1].GetValue<float>(), args[2].GetValue<float>());
+			}));
+			handlers.Add(TEXT("Client_onUpdateBasePosXZ"), DispatchTable::MakeEntry([](BaseApp* handler, const TArray<FVariant>& args) {
+				handler->Client_onUpdateBasePosXZ(args[0].GetValue<float>(), args[1].GetValue<float>());
+			}));
+			handlers.Add(TEXT("Client_onLoginBaseappFailed"), DispatchTable::MakeEntry([](BaseApp* handler, const TArray<FVariant>& args) {
+				handler->Client_onLoginBaseappFailed(args[0].GetValue<uint16>());
+			}));
+			handlers.Add(TEXT("Client_onReloginBaseappFailed"), DispatchTable::MakeEntry([](BaseApp* handler, const TArray<FVariant>& args) {
+				handler->Client_onReloginBaseappFailed(args[0].GetValue<uint16>());
+			}));
+			handlers.Add(TEXT("Client_onEntityDestroyed"), DispatchTable::MakeEntry([](BaseApp* handler, const TArray<FVariant>& args) {
+				handler->Client_onEntityDestroyed(args[0].GetValue<int32>());
+			}));
+			handlers.Add(TEXT("Client_onParentChanged"), DispatchTable::MakeEntry([](BaseApp* handler, const TArray<FVariant>& args) {
+				handler->Client_onParentChanged(args[0].GetValue<int32>(), args[1].GetValue<int32>());
+			}));
+
+			return handlers;
+		}();
+
+		return handlers;
+	}
+
+	void BaseApp::BindMessage(const Message& msg)
+	{
+		if (!dispatchTable_.Bind(msg.ID(), msg.Handler(), MessageHandlers()))
+			return;
 
-			Client_onUpdateData_xyz_pr_optimized(*stream);
-		}
-		else if (name == "Client_onUpdateData_xyz_y_optimized") {
+		static const TSet<FString> volatileFlushHandlers = {
+			TEXT("Client_onEntityEnterWorld"),
+			TEXT("Client_onEntityLeaveWorld"),
+			TEXT("Client_onEntityLeaveWorldOptimized"),
+			TEXT("Client_onEntityEnterSpace"),
+			TEXT("Client_onEntityLeaveSpace"),
+			TEXT("Client_onEntityDestroyed"),
+			TEXT("Client_onSetEntityPosAndDir"),
+			TEXT("Client_onUpdateBasePos"),
+			TEXT("Client_onUpdateBasePosXZ"),
+			TEXT("Client_onParentChanged"),
+		};
 
-			Client_onUpdateData_xyz_y_optimized(*stream);
-		}
-		else if (name == "Client_onUpdateData_xyz_p_optimized") {
+		if (volatileFlushHandlers.Contains(msg.Handler()))
+		{
+			if (volatileFlushMessages_.Num() <= msg.ID())
+				volatileFlushMessages_.SetNumZeroed(msg.ID() + 1);
 
-			Client_onUpdateData_xyz_p_optimized(*stream);
+			volatileFlushMessages_[msg.ID()] = true;
 		}
-		else if (name == "Client_onUpdateData_xyz_r_optimized") {
+	}
 
-			Client_onUpdateData_xyz_r_optimized(*stream);
-		}
-		else if (name == "Client_onStreamDataRecv") {
+	void BaseApp::UnbindMessages()
+	{
+		dispatchTable_.Clear();
+		volatileFlushMessages_.Reset();
+	}
 
-			Client_onStreamDataRecv(*stream);
-		}
-		else if (name == "Client_onStreamDataRecv") {
+	void BaseApp::HandleMessage(const Message& msg, MemoryStreamView *stream)
+	{
+		// 这些消息依赖实体当前的坐标与朝向（或者改变它们、创建与销毁实体），因此先应用之前积攒的易变数据，以保证顺序
+		if (volatileDataBatch_.Num() > 0 && IsVolatileFlushMessage(msg.ID()))
+			ApplyVolatileDataBatch();
 
-			Client_onStreamDataRecv(*stream);
-		}
-		else if (name == "Client_onAppActiveTickCB") {
-			Client_onAppActiveTickCB();
-		}
-		else if (name == "Client_acrossServerReady") {
-			Client_acrossServerReady(*stream);
-		}
-		else
+		auto handler = dispatchTable_.FindStreamHandler(msg.ID());
+		if (!handler)
 		{
-			KBE_ERROR(TEXT("BaseApp::HandleMessage: 1 - unknown message '%s'"), *name);
+			KBE_ERROR(TEXT("BaseApp::HandleMessage: 1 - unknown message '%s'"), *msg.Handler());
+			return;
 		}
 
+		handler(this, *stream);
 	}
 
-	void BaseApp::HandleMessage(const FString &name, const TArray<FVariant> &args)
+	void BaseApp::HandleMessage(const Message& msg, const TArray<FVariant> &args)
 	{
-		//KBE_ERROR(TEXT("shufeng--->>>BaseApp::HandleMessage TArray<FVariant> 2222:  message name (%s) at time(%s:%d)!"), 
-		//	*name, *FDateTime::UtcNow().ToString(), FDateTime::UtcNow().GetMillisecond());
+		if (volatileDataBatch_.Num() > 0 && IsVolatileFlushMessage(msg.ID()))
+			ApplyVolatileDataBatch();
 
-		if (name == "Client_onCreatedProxies") {
-			uint64 rndUUID = args[0].GetValue<uint64>();
-			int32 eid = args[1].GetValue<int32>();
-			FString entityType = args[2].GetValue<FString>();
-
-			Client_onCreatedProxies(rndUUID, eid, entityType);
-		}
-		else if (name == "Client_onEntityLeaveWorld") {
-			Client_onEntityLeaveWorld(args[0].GetValue<int32>());
-		}
-		else if (name == "Client_onEntityLeaveSpace") {
-			Client_onEntityLeaveSpace(args[0].GetValue<int32>());
-		}
-		else if (name == "Client_setSpaceData") {
-
-			Client_setSpaceData(args[0].GetValue<uint32>(), args[1].GetValue<FString>(), args[2].GetValue<FString>());
-		}
-		else if (name == "Client_delSpaceData") {
-
-			Client_delSpaceData(args[0].GetValue<uint32>(), args[1].GetValue<FString>());
-		}
-		else if (name == "Client_onControlEntity")
+		auto handler = dispatchTable_.FindArgsHandler(msg.ID());
+		if (!handler)
 		{
-			Client_onControlEntity(args[0].GetValue<int32>(), args[1].GetValue<int8>());
-		}
-		else if (name == "Client_onStreamDataStarted") {
-			Client_onStreamDataStarted(args[0].GetValue<int16>(), args[1].GetValue<uint32>(), args[2].GetValue<FString>());
-		}
-		else if (name == "Client_onStreamDataCompleted") {
-			Client_onStreamDataCompleted(args[0].GetValue<int16>());
-		}
-		else if (name == "Client_onKicked") {
-			Client_onKicked(args[0].GetValue<uint16>());
-		}
-		else if (name == "Client_onUpdateBasePos") {
-
-			Client_onUpdateBasePos(args[0].GetValue<float>(), args[1].GetValue<float>(), args[2].GetValue<float>());
+			KBE_ERROR(TEXT("BaseApp::HandleMessage: 2 - unknown message '%s'"), *msg.Handler());
+			return;
 		}
-		else if (name == "Client_onUpdateBasePosXZ") {
 
-			Client_onUpdateBasePosXZ(args[0].GetValue<float>(), args[1].GetValue<float>());
-		}
-		else if (name == "Client_onLoginBaseappFailed") {
-			Client_onLoginBaseappFailed(args[0].GetValue<uint16>());
-		}
-		else if (name == "Client_onReloginBaseappFailed") {
-			Client_onReloginBaseappFailed(args[0].GetValue<uint16>());
-		}
-		else if (name == "Client_onEntityDestroyed") {
-			Client_onEntityDestroyed(args[0].GetValue<int32>());
-		}
-		else if (name == "Client_onParentChanged") {
-			Client_onParentChanged(args[0].GetValue<int32>(), args[1].GetValue<int32>());
-		}
-		else
-		{
-			KBE_ERROR(TEXT("BaseApp::HandleMessage: 2 - unknown message '%s'"), *name);
-		}
+		handler(this, args);
 	}
 }
@@ -1,19 +1,22 @@
 #include "Bundle.h"
 #include "KBEnginePrivatePCH.h"
 #include "NetworkInterfaceBase.h"
+#include "MemoryStreamPool.h"
 
 namespace KBEngine
 {
 	Bundle::Bundle()
 	{
-		stream_ = new MemoryStream();
+		stream_ = MemoryStreamPool::Acquire();
 	}
 
 	Bundle::~Bundle()
 	{
-		SAFE_DELETE(stream_);
+		MemoryStreamPool::Release(stream_);
+		stream_ = nullptr;
+
 		for (auto s : streamList_)
-			delete s;
+			MemoryStreamPool::Release(s);
 	}
 
 	void Bundle::NewMessage(const Message *mt)
@@ -42,7 +45,7 @@ namespace KBEngine
 			WriteMsgLength();
 
 			streamList_.Add(stream_);
-			stream_ = new MemoryStream();
+			stream_ = MemoryStreamPool::Acquire();
 		}
 
 		if (issend)
@@ -73,7 +76,7 @@ namespace KBEngine
 		if (v > stream_->Space())
 		{
 			streamList_.Add(stream_);
-			stream_ = new MemoryStream();
+			stream_ = MemoryStreamPool::Acquire();
 			++curMsgStreamIndex_;
 		}
 
@@ -86,11 +89,19 @@ namespace KBEngine
 
 		if (networkInterface->Valid())
 		{
+			// 所有的数据流块一次性提交给发送者
+			SendSpanArray spans;
+			spans.Reserve(streamList_.Num());
+
 			for (int i = 0; i<streamList_.Num(); i++)
 			{
 				auto mstream = streamList_[i];
-				networkInterface->Send(mstream->Data() + mstream->RPos(), mstream->Length());
+				if (mstream->Length() > 0)
+					spans.Add({ mstream->Data() + mstream->RPos(), (uint32)mstream->Length() });
 			}
+
+			if (spans.Num() > 0)
+				networkInterface->SendV(spans);
 		}
 		else
 		{
@@ -98,10 +109,42 @@ namespace KBEngine
 		}
 
 		for (auto s : streamList_) {
-			delete s;
+			MemoryStreamPool::Release(s);
 		}
 		streamList_.Empty(0);
 		stream_->Clear();
+		pendingLength_ = 0;
+	}
+
+	void Bundle::Absorb(Bundle *other)
+	{
+		KBE_ASSERT(other && other != this);
+
+		// 本Bundle不能有正在写的消息，否则消息会被打乱
+		KBE_ASSERT(numMessage_ == 0);
+
+		other->Fini(true);
+
+		for (auto s : other->streamList_)
+		{
+			pendingLength_ += s->Length();
+			streamList_.Add(s);
+		}
+
+		other->streamList_.Reset();
+		other->pendingLength_ = 0;
+	}
+
+	void Bundle::Discard()
+	{
+		Fini(true);
+
+		for (auto s : streamList_)
+			MemoryStreamPool::Release(s);
+
+		streamList_.Reset();
+		stream_->Clear();
+		pendingLength_ = 0;
 	}
 
 }
@@ -0,0 +1,111 @@
+#include "DataTypePlan.h"
+#include "KBEnginePrivatePCH.h"
+#include "DataTypes.h"
+
+namespace KBEngine
+{
+	void DataTypePlan::Compile(KBEDATATYPE_BASE* type)
+	{
+		ops_.Reset();
+
+		if (type)
+			type->CompilePlan(*this);
+	}
+
+	int32 DataTypePlan::Add(EKBEPlanOp code, KBEDATATYPE_BASE* type, int32 arg)
+	{
+		Op op;
+		op.code = code;
+		op.type = type;
+		op.arg = arg;
+		return ops_.Add(op);
+	}
+
+	FVariant DataTypePlan::Decode(MemoryStreamView& stream) const
+	{
+		KBE_ASSERT(IsValid());
+
+		int32 pc = 0;
+		return Run(pc, stream);
+	}
+
+	FVariant DataTypePlan::Run(int32& pc, MemoryStreamView& stream) const
+	{
+		const Op& op = ops_[pc++];
+
+		switch (op.code)
+		{
+		case EKBEPlanOp::Int8:    return FVariant(TKBEPrimitiveCodec<int8>::Read(stream));
+		case EKBEPlanOp::Int16:   return FVariant(TKBEPrimitiveCodec<int16>::Read(stream));
+		case EKBEPlanOp::Int32:   return FVariant(TKBEPrimitiveCodec<int32>::Read(stream));
+		case EKBEPlanOp::Int64:   return FVariant(TKBEPrimitiveCodec<int64>::Read(stream));
+		case EKBEPlanOp::UInt8:   return FVariant(TKBEPrimitiveCodec<uint8>::Read(stream));
+		case EKBEPlanOp::UInt16:  return FVariant(TKBEPrimitiveCodec<uint16>::Read(stream));
+		case EKBEPlanOp::UInt32:  return FVariant(TKBEPrimitiveCodec<uint32>::Read(stream));
+		case EKBEPlanOp::UInt64:  return FVariant(TKBEPrimitiveCodec<uint64>::Read(stream));
+		case EKBEPlanOp::Float:   return FVariant(TKBEPrimitiveCodec<float>::Read(stream));
+		case EKBEPlanOp::Double:  return FVariant(TKBEPrimitiveCodec<double>::Read(stream));
+		case EKBEPlanOp::Vector2: return FVariant(TKBEVectorCodec<2>::Read(stream));
+		case EKBEPlanOp::Vector3: return FVariant(TKBEVectorCodec<3>::Read(stream));
+		case EKBEPlanOp::Vector4: return FVariant(TKBEVectorCodec<4>::Read(stream));
+		case EKBEPlanOp::String:  return FVariant(stream.ReadString());
+		case EKBEPlanOp::Unicode: return FVariant(stream.ReadUTF8());
+
+		case EKBEPlanOp::Blob:
+		{
+			TArray<uint8> bytes;
+			stream.ReadBlob(bytes);
+			return FVariant(bytes);
+		}
+
+		case EKBEPlanOp::Array:
+		{
+			uint32 size = stream.ReadUint32();
+
+			FVariantArray data;
+			data.Reserve(FMath::Min<uint32>(size, stream.Length()));
+
+			// 每个元素都从子计划的开头执行，结束后跳过整个子计划
+			int32 body = pc;
+			while (size > 0)
+			{
+				size--;
+				pc = body;
+				data.Add(Run(pc, stream));
+			}
+
+			pc = body + op.arg;
+			return data;
+		}
+
+		case EKBEPlanOp::FixedDict:
+		{
+			const KBEDATATYPE_FIXED_DICT* dictType = static_cast<const KBEDATATYPE_FIXED_DICT*>(op.type);
+
+			if (KBEDATATYPE_FIXED_DICT::DecodeAsStruct())
+			{
+				FVariantFixedDict data(dictType->Schema());
+				data.values.Reserve(op.arg);
+
+				for (int32 i = 0; i < op.arg; ++i)
+					data.values.Add(Run(pc, stream));
+
+				return data;
+			}
+
+			const auto& fields = dictType->Fields();
+
+			FVariantMap data;
+			data.Reserve(op.arg);
+
+			for (int32 i = 0; i < op.arg; ++i)
+				data.Add(fields[i].name, Run(pc, stream));
+
+			return data;
+		}
+
+		default:
+			return op.type->CreateFromStream(&stream);
+		}
+	}
+}
@@ -1,6 +1,7 @@
 #include "DataTypes.h"
 #include "KBEnginePrivatePCH.h"
 #include "EntityDef.h"
+#include "KBEngineApp.h"
 
 namespace KBEngine
 {
@@ -63,6 +64,103 @@ namespace KBEngine
 		return 0;
 	}
 
+	bool KBEDATATYPE_BASE::ToInteger(const FVariant &v, uint64 &bits, bool &negative)
+	{
+		int64 n = 0;
+
+		switch (v.GetType())
+		{
+		case EVariantTypes::Int8:
+			n = v.GetValue<int8>();
+			break;
+		case EVariantTypes::UInt8:
+			n = v.GetValue<uint8>();
+			break;
+		case EVariantTypes::Int16:
+			n = v.GetValue<int16>();
+			break;
+		case EVariantTypes::UInt16:
+			n = v.GetValue<uint16>();
+			break;
+		case EVariantTypes::Int32:
+			n = v.GetValue<int32>();
+			break;
+		case EVariantTypes::UInt32:
+			n = v.GetValue<uint32>();
+			break;
+		case EVariantTypes::Int64:
+			n = v.GetValue<int64>();
+			break;
+		case EVariantTypes::UInt64:
+			bits = v.GetValue<uint64>();
+			negative = false;
+			return true;
+		case EVariantTypes::Ansichar:
+			n = v.GetValue<ANSICHAR>();
+			break;
+		case EVariantTypes::Widechar:
+			n = v.GetValue<WIDECHAR>();
+			break;
+		case EVariantTypes::Bool:
+			n = v.GetValue<bool>();
+			break;
+		default:
+			return false;
+		}
+
+		bits = (uint64)n;
+		negative = n < 0;
+		return true;
+	}
+
+
+	template <class T>
+	static void ReadPrimitiveArray(MemoryStreamView *stream, uint32 size, FVariantArray& data)
+	{
+		TArray<T> values;
+		stream->ReadArray(values, size);
+
+		data.Reserve(values.Num());
+		for (const T& value : values)
+			data.Add(FVariant(value));
+	}
+
+	template <class T>
+	static void WritePrimitiveArray(Bundle *stream, const FVariantArray& data)
+	{
+		TArray<T> values;
+		values.SetNumUninitialized(data.Num());
+
+		for (int32 i = 0; i < data.Num(); ++i)
+			values[i] = data[i].GetValue<T>();
+
+		stream->WriteArray(values.GetData(), values.Num());
+	}
+
+	template <class T>
+	static bool WritePrimitiveArrayChecked(Bundle *stream, const FVariantArray& data, KBEDATATYPE_BASE* elementType)
+	{
+		TArray<T> values;
+		values.SetNumUninitialized(data.Num());
+
+		for (int32 i = 0; i < data.Num(); ++i)
+		{
+			const FVariant& value = data[i];
+			if (value.GetType() == TVariantTraits<T>::GetType())
+			{
+				values[i] = value.GetValue<T>();
+			}
+			else
+			{
+				// IsSameType按元素类型的规则检查（例如浮点数元素只接受浮点数），转换不经过double
+				if (!elementType->IsSameType(value) || !KBEDATATYPE_BASE::ConvertNumber(value, values[i]))
+					return false;
+			}
+		}
+
+		stream->WriteArray(values.GetData(), values.Num());
+		return true;
+	}
 
 	void KBEDATATYPE_ARRAY::Bind()
 	{
@@ -74,20 +172,54 @@ namespace KBEngine
 		{
 			vtypeObject_ = EntityDef::GetDataType(vtype_);
 		}
+
+		elementType_ = vtypeObject_ ? vtypeObject_->PrimitiveType() : EVariantTypes::Empty;
 	}
 
-	FVariant KBEDATATYPE_ARRAY::CreateFromStream(MemoryStream *stream)
+	void KBEDATATYPE_ARRAY::CompilePlan(DataTypePlan& plan)
+	{
+		// 数值数组整块读取更快，直接交给CreateFromStream
+		if (!vtypeObject_ || elementType_ != EVariantTypes::Empty)
+		{
+			plan.Add(EKBEPlanOp::Generic, this);
+			return;
+		}
+
+		int32 index = plan.Add(EKBEPlanOp::Array, this);
+		vtypeObject_->CompilePlan(plan);
+		plan[index].arg = plan.Num() - index - 1;
+	}
+
+	FVariant KBEDATATYPE_ARRAY::CreateFromStream(MemoryStreamView *stream)
 	{
 		KBE_ASSERT(vtypeObject_);
 
 		uint32 size = stream->ReadUint32();
 		FVariantArray data;
 
-		while (size > 0)
+		switch (elementType_)
 		{
-			size--;
-			data.Add(vtypeObject_->CreateFromStream(stream));
-		};
+		case EVariantTypes::Int8:   ReadPrimitiveArray<int8>(stream, size, data); break;
+		case EVariantTypes::Int16:  ReadPrimitiveArray<int16>(stream, size, data); break;
+		case EVariantTypes::Int32:  ReadPrimitiveArray<int32>(stream, size, data); break;
+		case EVariantTypes::Int64:  ReadPrimitiveArray<int64>(stream, size, data); break;
+		case EVariantTypes::UInt8:  ReadPrimitiveArray<uint8>(stream, size, data); break;
+		case EVariantTypes::UInt16: ReadPrimitiveArray<uint16>(stream, size, data); break;
+		case EVariantTypes::UInt32: ReadPrimitiveArray<uint32>(stream, size, data); break;
+		case EVariantTypes::UInt64: ReadPrimitiveArray<uint64>(stream, size, data); break;
+		case EVariantTypes::Float:  ReadPrimitiveArray<float>(stream, size, data); break;
+		case EVariantTypes::Double: ReadPrimitiveArray<double>(stream, size, data); break;
+		default:
+			// 每个元素至少占1个字节，以此限制预分配的大小
+			data.Reserve(FMath::Min<uint32>(size, stream->Length()));
+
+			while (size > 0)
+			{
+				size--;
+				data.Add(vtypeObject_->CreateFromStream(stream));
+			};
+			break;
+		}
 
 		return data;
 	}
@@ -98,10 +230,61 @@ namespace KBEngine
 
 		const auto a = v.GetValue<FVariantArray>();
 		stream->WriteUint32((uint32)a.Num());
+
+		switch (elementType_)
+		{
+		case EVariantTypes::Int8:   WritePrimitiveArray<int8>(stream, a); break;
+		case EVariantTypes::Int16:  WritePrimitiveArray<int16>(stream, a); break;
+		case EVariantTypes::Int32:  WritePrimitiveArray<int32>(stream, a); break;
+		case EVariantTypes::Int64:  WritePrimitiveArray<int64>(stream, a); break;
+		case EVariantTypes::UInt8:  WritePrimitiveArray<uint8>(stream, a); break;
+		case EVariantTypes::UInt16: WritePrimitiveArray<uint16>(stream, a); break;
+		case EVariantTypes::UInt32: WritePrimitiveArray<uint32>(stream, a); break;
+		case EVariantTypes::UInt64: WritePrimitiveArray<uint64>(stream, a); break;
+		case EVariantTypes::Float:  WritePrimitiveArray<float>(stream, a); break;
+		case EVariantTypes::Double: WritePrimitiveArray<double>(stream, a); break;
+		default:
+			for (int i = 0; i<a.Num(); i++)
+			{
+				vtypeObject_->AddToStream(stream, a[i]);
+			}
+			break;
+		}
+	}
+
+	bool KBEDATATYPE_ARRAY::AddToStreamChecked(Bundle *stream, const FVariant &v)
+	{
+		KBE_ASSERT(vtypeObject_);
+
+		if (v.GetType() != static_cast<EVariantTypes>(EKBEVariantTypes::VariantArray))
+			return false;
+
+		const auto a = v.GetValue<FVariantArray>();
+		stream->WriteUint32((uint32)a.Num());
+
+		switch (elementType_)
+		{
+		case EVariantTypes::Int8:   return WritePrimitiveArrayChecked<int8>(stream, a, vtypeObject_);
+		case EVariantTypes::Int16:  return WritePrimitiveArrayChecked<int16>(stream, a, vtypeObject_);
+		case EVariantTypes::Int32:  return WritePrimitiveArrayChecked<int32>(stream, a, vtypeObject_);
+		case EVariantTypes::Int64:  return WritePrimitiveArrayChecked<int64>(stream, a, vtypeObject_);
+		case EVariantTypes::UInt8:  return WritePrimitiveArrayChecked<uint8>(stream, a, vtypeObject_);
+		case EVariantTypes::UInt16: return WritePrimitiveArrayChecked<uint16>(stream, a, vtypeObject_);
+		case EVariantTypes::UInt32: return WritePrimitiveArrayChecked<uint32>(stream, a, vtypeObject_);
+		case EVariantTypes::UInt64: return WritePrimitiveArrayChecked<uint64>(stream, a, vtypeObject_);
+		case EVariantTypes::Float:  return WritePrimitiveArrayChecked<float>(stream, a, vtypeObject_);
+		case EVariantTypes::Double: return WritePrimitiveArrayChecked<double>(stream, a, vtypeObject_);
+		default:
+			break;
+		}
+
 		for (int i = 0; i<a.Num(); i++)
 		{
-			vtypeObject_->AddToStream(stream, a[i]);
+			if (!vtypeObject_->AddToStreamChecked(stream, a[i]))
+				return false;
 		}
+
+		return true;
 	}
 
 	FVariant KBEDATATYPE_ARRAY::ParseDefaultValStr(const FString& s)
@@ -134,39 +317,164 @@ namespace KBEngine
 		return true;
 	}
 
-	void KBEDATATYPE_FIXED_DICT::Bind()
+	TArray<FVariantFixedDictSchema*> FVariantFixedDictSchema::schemas_;
+
+	int32 FVariantFixedDictSchema::FieldIndex(const FString& name) const
+	{
+		return names.IndexOfByKey(name);
+	}
+
+	const FVariantFixedDictSchema* FVariantFixedDictSchema::Intern(const TArray<FString>& names)
+	{
+		for (const FVariantFixedDictSchema* schema : schemas_)
+		{
+			if (schema->names == names)
+				return schema;
+		}
+
+		FVariantFixedDictSchema* schema = new FVariantFixedDictSchema();
+		schema->names = names;
+		schemas_.Add(schema);
+		schema->id = (uint32)schemas_.Num();
+		return schema;
+	}
+
+	const FVariantFixedDictSchema* FVariantFixedDictSchema::Find(uint32 id)
+	{
+		return id > 0 && id <= (uint32)schemas_.Num() ? schemas_[id - 1] : nullptr;
+	}
+
+	int32 FVariantFixedDict::FieldIndex(const FString& name) const
+	{
+		return schema ? schema->FieldIndex(name) : INDEX_NONE;
+	}
+
+	const FVariant* FVariantFixedDict::Find(const FString& name) const
+	{
+		int32 index = FieldIndex(name);
+		return values.IsValidIndex(index) ? &values[index] : nullptr;
+	}
+
+	FVariant* FVariantFixedDict::Find(const FString& name)
+	{
+		int32 index = FieldIndex(name);
+		return values.IsValidIndex(index) ? &values[index] : nullptr;
+	}
+
+	FVariantMap FVariantFixedDict::ToMap() const
 	{
-		for (auto it = dictType_.CreateIterator(); it; ++it)
+		FVariantMap data;
+		if (!schema)
+			return data;
+
+		const auto& names = schema->names;
+		data.Reserve(names.Num());
+
+		for (int32 i = 0; i < names.Num() && i < values.Num(); ++i)
+			data.Add(names[i], values[i]);
+
+		return data;
+	}
+
+	bool KBEDATATYPE_FIXED_DICT::DecodeAsStruct()
+	{
+		return KBEngineApp::app && KBEngineApp::app->FixedDictAsStruct();
+	}
+
+	void KBEDATATYPE_FIXED_DICT::AddSubType(const FString& key, uint16 type)
+	{
+		Field field;
+		field.name = key;
+		field.utype = type;
+		fields_.Add(field);
+
+		schema_ = nullptr;
+	}
+
+	const FVariantFixedDictSchema* KBEDATATYPE_FIXED_DICT::Schema() const
+	{
+		if (!schema_)
+		{
+			TArray<FString> names;
+			names.Reserve(fields_.Num());
+
+			for (const auto& field : fields_)
+				names.Add(field.name);
+
+			schema_ = FVariantFixedDictSchema::Intern(names);
+		}
+
+		return schema_;
+	}
+
+	int32 KBEDATATYPE_FIXED_DICT::FieldIndex(const FString& name) const
+	{
+		for (int32 i = 0; i < fields_.Num(); ++i)
+		{
+			if (fields_[i].name == name)
+				return i;
+		}
+
+		return INDEX_NONE;
+	}
+
+	void KBEDATATYPE_FIXED_DICT::CompilePlan(DataTypePlan& plan)
+	{
+		for (const auto& field : fields_)
 		{
-			FString itemkey = it.Key();
+			if (!field.type)
+			{
+				plan.Add(EKBEPlanOp::Generic, this);
+				return;
+			}
+		}
 
-			auto** p = dictTypeObjects_.Find(itemkey);
-			KBEDATATYPE_BASE *typeObject = p ? *p : nullptr;
-			if (typeObject)
+		plan.Add(EKBEPlanOp::FixedDict, this, fields_.Num());
+
+		for (const auto& field : fields_)
+			field.type->CompilePlan(plan);
+	}
+
+	void KBEDATATYPE_FIXED_DICT::Bind()
+	{
+		for (auto& field : fields_)
+		{
+			if (field.type)
 			{
-				typeObject->Bind();
+				field.type->Bind();
 			}
 			else
 			{
-				typeObject = EntityDef::GetDataType(it.Value());
-				if (typeObject)
-					dictTypeObjects_.Add(itemkey, typeObject);
+				field.type = EntityDef::GetDataType(field.utype);
 			}
 		}
 	}
 
-	FVariant KBEDATATYPE_FIXED_DICT::CreateFromStream(MemoryStream *stream)
+	FVariant KBEDATATYPE_FIXED_DICT::CreateFromStream(MemoryStreamView *stream)
 	{
-		FVariantMap data;
+		KBE_ASSERT(fields_.Num());
 
-		KBE_ASSERT(dictTypeObjects_.Num());
-		for (auto it = dictTypeObjects_.CreateIterator(); it; ++it)
+		if (DecodeAsStruct())
 		{
-			FString itemkey = it.Key();
-			KBEDATATYPE_BASE *typeObject = it.Value();
-			check(typeObject);
+			FVariantFixedDict data(Schema());
+			data.values.Reserve(fields_.Num());
+
+			for (const auto& field : fields_)
+			{
+				check(field.type);
+				data.values.Add(field.type->CreateFromStream(stream));
+			}
+
+			return data;
+		}
 
-			data.Add(itemkey, typeObject->CreateFromStream(stream));
+		FVariantMap data;
+		data.Reserve(fields_.Num());
+
+		for (const auto& field : fields_)
+		{
+			check(field.type);
+			data.Add(field.name, field.type->CreateFromStream(stream));
 		}
 
 		return data;
@@ -174,31 +482,94 @@ namespace KBEngine
 
 	void KBEDATATYPE_FIXED_DICT::AddToStream(Bundle *stream, const FVariant &v)
 	{
+		KBE_ASSERT(fields_.Num());
+
+		if (v.GetType() == static_cast<EVariantTypes>(EKBEVariantTypes::VariantFixedDict))
+		{
+			// 值已经按字段顺序排列，直接按下标写入
+			const auto data = v.GetValue<FVariantFixedDict>();
+			KBE_ASSERT(data.values.Num() == fields_.Num());
+
+			for (int32 i = 0; i < fields_.Num(); ++i)
+			{
+				check(fields_[i].type);
+				fields_[i].type->AddToStream(stream, data.values[i]);
+			}
+
+			return;
+		}
+
 		const auto data = v.GetValue<FVariantMap>();
 
-		KBE_ASSERT(dictTypeObjects_.Num());
-		for (auto it = dictTypeObjects_.CreateIterator(); it; ++it)
+		for (const auto& field : fields_)
 		{
-			FString itemkey = it.Key();
-			KBEDATATYPE_BASE *typeObject = it.Value();
-			check(typeObject);
+			check(field.type);
+			field.type->AddToStream(stream, data[field.name]);
+		}
+	}
 
-			typeObject->AddToStream(stream, data[itemkey]);
+	bool KBEDATATYPE_FIXED_DICT::AddToStreamChecked(Bundle *stream, const FVariant &v)
+	{
+		KBE_ASSERT(fields_.Num());
+
+		if (v.GetType() == static_cast<EVariantTypes>(EKBEVariantTypes::VariantFixedDict))
+		{
+			const auto data = v.GetValue<FVariantFixedDict>();
+			if (data.values.Num() != fields_.Num())
+				return false;
+
+			for (int32 i = 0; i < fields_.Num(); ++i)
+			{
+				check(fields_[i].type);
+				if (!fields_[i].type->AddToStreamChecked(stream, data.values[i]))
+					return false;
+			}
+
+			return true;
 		}
+
+		if (v.GetType() != static_cast<EVariantTypes>(EKBEVariantTypes::VariantMap))
+			return false;
+
+		const auto data = v.GetValue<FVariantMap>();
+
+		for (const auto& field : fields_)
+		{
+			check(field.type);
+
+			auto* value = data.Find(field.name);
+			if (!value || !field.type->AddToStreamChecked(stream, *value))
+				return false;
+		}
+
+		return true;
 	}
 
 	FVariant KBEDATATYPE_FIXED_DICT::ParseDefaultValStr(const FString& s)
 	{
-		FVariantMap data;
+		KBE_ASSERT(fields_.Num());
 
-		KBE_ASSERT(dictTypeObjects_.Num());
-		for (auto it = dictTypeObjects_.CreateIterator(); it; ++it)
+		if (DecodeAsStruct())
 		{
-			FString itemkey = it.Key();
-			KBEDATATYPE_BASE *typeObject = it.Value();
-			check(typeObject);
+			FVariantFixedDict data(Schema());
+			data.values.Reserve(fields_.Num());
+
+			for (const auto& field : fields_)
+			{
+				check(field.type);
+				data.values.Add(field.type->ParseDefaultValStr(FString()));
+			}
+
+			return data;
+		}
+
+		FVariantMap data;
+		data.Reserve(fields_.Num());
 
-			data.Add(itemkey, typeObject->ParseDefaultValStr(FString()));
+		for (const auto& field : fields_)
+		{
+			check(field.type);
+			data.Add(field.name, field.type->ParseDefaultValStr(FString()));
 		}
 
 		return data;
@@ -206,22 +577,37 @@ namespace KBEngine
 	
 	bool KBEDATATYPE_FIXED_DICT::IsSameType(const FVariant &v)
 	{
+		KBE_ASSERT(fields_.Num());
+
+		if (v.GetType() == static_cast<EVariantTypes>(EKBEVariantTypes::VariantFixedDict))
+		{
+			const auto data = v.GetValue<FVariantFixedDict>();
+			if (data.values.Num() != fields_.Num())
+				return false;
+
+			for (int32 i = 0; i < fields_.Num(); ++i)
+			{
+				check(fields_[i].type);
+				if (!fields_[i].type->IsSameType(data.values[i]))
+					return false;
+			}
+
+			return true;
+		}
+
 		if (v.GetType() != static_cast<EVariantTypes>(EKBEVariantTypes::VariantMap))
 			return false;
 
 		const auto data = v.GetValue<FVariantMap>();
 
-		KBE_ASSERT(dictTypeObjects_.Num());
-		for (auto it = dictTypeObjects_.CreateIterator(); it; ++it)
+		for (const auto& field : fields_)
 		{
-			FString itemkey = it.Key();
-			KBEDATATYPE_BASE *typeObject = it.Value();
-			check(typeObject);
+			check(field.type);
 
-			auto* value = data.Find(itemkey);
+			auto* value = data.Find(field.name);
 			if (value)
 			{
-				if (!typeObject->IsSameType(*value))
+				if (!field.type->IsSameType(*value))
 				{
 					return false;
 				}
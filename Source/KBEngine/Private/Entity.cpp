@@ -19,13 +19,6 @@ namespace KBEngine
 	{
 		KBE_DEBUG(TEXT("Entity::~Entity(), %d"), id_);
 
-		// delete properties
-		for (auto it = defpropertys_.CreateIterator(); it; ++it) {
-			delete it.Value();
-		}
-		defpropertys_.Empty(0);
-		iddefpropertys_.Empty(0);
-
 		SAFE_DELETE(baseMailbox_);
 		SAFE_DELETE(cellMailbox_);
 
@@ -38,7 +31,8 @@ namespace KBEngine
 
 	void Entity::InitProperties(ScriptModule& scriptModule)
 	{
-		scriptModule.ClonePropertyTo(defpropertys_, iddefpropertys_);
+		scriptModule_ = &scriptModule;
+		propertyValues_ = scriptModule.DefaultValues();
 	}
 
 	void Entity::RemoteMethodCall(const FString &name, const TArray<FVariant> &args)
@@ -50,11 +44,44 @@ namespace KBEngine
 	void Entity::OnRemoteMethodCall(const FString &name, const TArray<FVariant> &args)
 	{
 		//KBE_ERROR(TEXT("Entity::OnRemoteMethodCall: Entity (id: %d) has no method '%s' to bound!"), id_, *name);
-		// wsf:ڴ˺Զ̷õĴԱⲿʹ߿Ըп
-		// ĳһʱԶϢ̫²̴ãǻĳֲƽ
+		// wsf:在此函数进行远程方法调用的处理，以便外部使用者可以根据需求进行控制
+		// 例如在某一时刻远程消息太多的情况下不立刻触发调用，而是缓存起来根据某种策略平滑处理
+		ScriptModule* scriptModule = EntityDef::GetScriptModule(className_);
+		Method* method = scriptModule ? scriptModule->GetMethod(name) : nullptr;
+		if (method && method->proxy)
+			method->proxy->Do(this, args);
+	}
+
+	void Entity::RemoteMethodCall(const Method &method, MemoryStreamView &stream)
+	{
+		OnRemoteMethodCall(method, stream);
+	}
+
+	void Entity::OnRemoteMethodCall(const Method &method, MemoryStreamView &stream)
+	{
+		// 重载了FVariant版本的实体类仍然由它处理，以保持原有的行为
+		if (method.proxy && !UsesVariantRemoteMethodCall())
+		{
+			method.proxy->DoFromStream(this, method, stream);
+			return;
+		}
+
+		FVariantArray args;
+		args.SetNum(method.args.Num());
+
+		for (int i = 0; i < method.args.Num(); i++)
+		{
+			args[i] = method.args[i]->CreateFromStream(&stream);
+		}
+
+		OnRemoteMethodCall(method.name, args);
+	}
+
+	EntityMethodProxy* Entity::FindMethodProxy(const FString &name) const
+	{
 		auto map = GetMethodMap();
 		if (!map)
-			return;
+			return nullptr;
 
 		do
 		{
@@ -64,10 +91,7 @@ namespace KBEngine
 				while (!(*pEntries).name.IsEmpty())
 				{
 					if ((*pEntries).name == name)
-					{
-						(*pEntries).pMethodProxy->Do(this, args);
-						return;
-					}
+						return (*pEntries).pMethodProxy.get();
 
 					pEntries++;
 				}
@@ -76,6 +100,8 @@ namespace KBEngine
 			map = map->pfnGetBaseMap();
 
 		} while (map);
+
+		return nullptr;
 	}
 
 	bool Entity::IsPlayer()
@@ -88,57 +114,67 @@ namespace KBEngine
 
 	void Entity::AddDefinedProperty(FString name, const FVariant &v)
 	{
-		PrintString(name);
-		Property *newp = new Property();
-		newp->name = name;
-		newp->properUtype = 0;
-		newp->val = v;
-		newp->setmethod = NULL;
-		defpropertys_.Add(name, newp);
+		Property *obj = scriptModule_ ? scriptModule_->GetProperty(name) : nullptr;
+		if (obj)
+		{
+			propertyValues_[obj->slot] = v;
+			return;
+		}
+
+		extraPropertys_.Add(name, v);
 	}
 
 	FVariant Entity::GetDefinedProperty(FString name)
 	{
-		auto** p = defpropertys_.Find(name);
-		Property *obj = p ? *p : nullptr;
+		Property *obj = scriptModule_ ? scriptModule_->GetProperty(name) : nullptr;
+		if (!obj)
+		{
+			FVariant* extra = extraPropertys_.Find(name);
+			KBE_ASSERT(extra);
+			return *extra;
+		}
 
-		KBE_ASSERT(obj);
-		return obj->val;
+		return propertyValues_[obj->slot];
 	}
 
 	void Entity::SetDefinedProperty(FString name, const FVariant &val)
 	{
-		auto** p = defpropertys_.Find(name);
-		Property *obj = p ? *p : nullptr;
-		
-		KBE_ASSERT(obj);
-		obj->val = val;
+		Property *obj = scriptModule_ ? scriptModule_->GetProperty(name) : nullptr;
+		if (!obj)
+		{
+			FVariant* extra = extraPropertys_.Find(name);
+			KBE_ASSERT(extra);
+			*extra = val;
+			return;
+		}
+
+		propertyValues_[obj->slot] = val;
 	}
 
 	FVariant Entity::GetDefinedPropertyByUType(uint16 utype)
 	{
-		auto** p = iddefpropertys_.Find(utype);
-		Property *obj = p ? *p : nullptr;
+		Property *obj = scriptModule_ ? scriptModule_->GetPropertyByUType(utype) : nullptr;
 
 		KBE_ASSERT(obj);
-		return obj->val;
+		return propertyValues_[obj->slot];
 	}
 
 	void Entity::SetDefinedPropertyByUType(uint16 utype, const FVariant &val)
 	{
-		auto** p = iddefpropertys_.Find(utype);
-		Property *obj = p ? *p : nullptr;
+		Property *obj = scriptModule_ ? scriptModule_->GetPropertyByUType(utype) : nullptr;
 
 		KBE_ASSERT(obj);
-		obj->val = val;
+		propertyValues_[obj->slot] = val;
 	}
 
 	void Entity::CallPropertysSetMethods()
 	{
-		for (auto it = iddefpropertys_.CreateIterator(); it; ++it)
+		if (!scriptModule_)
+			return;
+
+		for (Property *prop : scriptModule_->SlotPropertys())
 		{
-			Property *prop = it.Value();
-			FVariant oldval = GetDefinedPropertyByUType(prop->properUtype);
+			FVariant oldval = propertyValues_[prop->slot];
 			PropertyHandler setmethod = prop->setmethod;
 
 			//if (setmethod != NULL)
@@ -149,7 +185,7 @@ namespace KBEngine
 					{
 						//Dbg.DEBUG_MSG(className + "::callPropertysSetMethods(" + prop.name + ")"); 
 						//setmethod(this, oldval);
-						OnUpdateProperty(prop->name, oldval, oldval);
+						OnUpdateProperty(*prop, oldval, oldval);
 					}
 				}
 				else
@@ -160,7 +196,7 @@ namespace KBEngine
 						if (prop->IsOwnerOnly() && !IsPlayer())
 							continue;
 						//setmethod(this, oldval);
-						OnUpdateProperty(prop->name, oldval, oldval);
+						OnUpdateProperty(*prop, oldval, oldval);
 					}
 				}
 			}
@@ -171,6 +207,27 @@ namespace KBEngine
 		}
 	}
 
+	// 写入远程调用的参数，类型不符时丢弃写了一半的消息并抛出异常
+	static void AddCallArgsToStream(Mailbox* mailbox, Bundle* bundle, Method* method, const FVariantArray &arguments)
+	{
+		if (!KBEngineApp::app->ValidateEntityCallArgs())
+		{
+			for (int i = 0; i<method->args.Num(); i++)
+				method->args[i]->AddToStream(bundle, arguments[i]);
+
+			return;
+		}
+
+		for (int i = 0; i<method->args.Num(); i++)
+		{
+			if (!method->args[i]->AddToStreamChecked(bundle, arguments[i]))
+			{
+				mailbox->DiscardMail();
+				throw FString::Printf(TEXT("arg%d: %s"), i, method->args[i]->TypeString());
+			}
+		}
+	}
+
 	void Entity::BaseCall(const FString &methodname, const FVariantArray &arguments)
 	{
 		if (!KBEngineApp::app->pBaseApp())
@@ -179,7 +236,7 @@ namespace KBEngine
 			return;
 		}
 
-		ScriptModule* scriptModule = EntityDef::GetScriptModule(className_);
+		ScriptModule* scriptModule = scriptModule_ ? scriptModule_ : EntityDef::GetScriptModule(className_);
 		Method *method = scriptModule->GetBaseMethod(methodname);
 		if (!method)
 		{
@@ -205,21 +262,12 @@ namespace KBEngine
 		auto* bundle = baseMailbox_->NewMail();
 		bundle->WriteUint16(methodID);
 
-		for (int i = 0; i<method->args.Num(); i++)
-		{
-			if (method->args[i]->IsSameType(arguments[i]))
-			{
-				method->args[i]->AddToStream(bundle, arguments[i]);
-			}
-			else
-			{
-				throw FString::Printf(TEXT("arg%d: %s"), i, method->args[i]->TypeString());
-			}
-		}
+		AddCallArgsToStream(baseMailbox_, bundle, method, arguments);
 
 		if (!EntityCallEnable())
 		{
 			KBE_ERROR(TEXT("%s::BaseCall(%s), but entity call is disable!"), *className_, *methodname);
+			baseMailbox_->DiscardMail();
 			return;
 		}
 
@@ -234,7 +282,7 @@ namespace KBEngine
 			return;
 		}
 
-		ScriptModule* scriptModule = EntityDef::GetScriptModule(className_);
+		ScriptModule* scriptModule = scriptModule_ ? scriptModule_ : EntityDef::GetScriptModule(className_);
 		Method *method = scriptModule->GetCellMethod(methodname);
 		if (!method)
 		{
@@ -266,17 +314,7 @@ namespace KBEngine
 		auto* bundle = cellMailbox_->NewMail();
 		bundle->WriteUint16(methodID);
 
-		for (int i = 0; i<method->args.Num(); i++)
-		{
-			if (method->args[i]->IsSameType(arguments[i]))
-			{
-				method->args[i]->AddToStream(bundle, arguments[i]);
-			}
-			else
-			{
-				throw FString::Printf(TEXT("arg%d: %s"), i, method->args[i]->TypeString());
-			}
-		}
+		AddCallArgsToStream(cellMailbox_, bundle, method, arguments);
 
 		cellMailbox_->PostMail(KBEngineApp::app->pBaseApp()->pNetworkInterface());
 	}
@@ -321,6 +359,14 @@ namespace KBEngine
 			localPosition_ = position_;
 		SyncVolatileDataToChildren(true);
 
+		// 服务器直接设置的坐标不做插值
+		if (snapshots_.Num() > 0)
+		{
+			snapshots_.Reset(FPlatformTime::Seconds(), position_, direction_);
+			smoothedPosition_ = position_;
+			smoothedDirection_ = direction_;
+		}
+
 		Set_Position(old);
 	}
 
@@ -335,6 +381,13 @@ namespace KBEngine
 			localDirection_ = direction_;
 		SyncVolatileDataToChildren(false);
 
+		if (snapshots_.Num() > 0)
+		{
+			snapshots_.Reset(FPlatformTime::Seconds(), position_, direction_);
+			smoothedPosition_ = position_;
+			smoothedDirection_ = direction_;
+		}
+
 		Set_Direction(old);
 	}
 
@@ -351,14 +404,30 @@ namespace KBEngine
 
 	void Entity::OnUpdateProperty(const FString &name, const FVariant &newVal, const FVariant &oldVal)
 	{
-		FVariantArray args;
-		args.Add(name);
-		args.Add(newVal);
-		args.Add(oldVal);
+		Property *prop = scriptModule_ ? scriptModule_->GetProperty(name) : nullptr;
+
+		if (prop && prop->proxy)
+			prop->proxy->Do(this, newVal, oldVal);
+
+		//KBE_ERROR(TEXT("Entity::onUpdateProperty: Entity (id: %d) has no property method '%s' to bound!"), id, *name);
+	}
+
+	void Entity::OnUpdateProperty(const Property &prop, const FVariant &newVal, const FVariant &oldVal)
+	{
+		if (prop.proxy)
+		{
+			prop.proxy->Do(this, newVal, oldVal);
+			return;
+		}
+
+		OnUpdateProperty(prop.name, newVal, oldVal);
+	}
 
+	EntityPropertyProxy* Entity::FindPropertyProxy(const FString &name) const
+	{
 		auto map = GetPropertyMap();
 		if (!map)
-			return;
+			return nullptr;
 
 		do
 		{
@@ -368,10 +437,7 @@ namespace KBEngine
 				while (!(*pEntries).name.IsEmpty())
 				{
 					if ((*pEntries).name == name)
-					{
-						(*pEntries).pPropertyProxy->Do(this, newVal, oldVal);
-						return;
-					}
+						return (*pEntries).pPropertyProxy.get();
 
 					pEntries++;
 				}
@@ -381,7 +447,7 @@ namespace KBEngine
 
 		} while (map);
 
-		//KBE_ERROR(TEXT("Entity::onUpdateProperty: Entity (id: %d) has no property method '%s' to bound!"), id, *name);
+		return nullptr;
 	}
 
 	void Entity::SetControlled(bool yes)
@@ -394,20 +460,76 @@ namespace KBEngine
 	{
 		OnDestroy();
 
-		// ֻԼˣԷûи
-		// ֻı丸ָ򣬵parentIDֵȻ
+		// 销毁自身只代表自己不见了，不代表对方没有父了
+		// 因此这里只改变父对象的指向，但parentID的值仍然保留
 		for (auto iter : children_)
 			iter.Value->parent_ = nullptr;
 		children_.Reset();
 
-		// 
+		// 解引用
 		if (parent_)
 		{
 			parent_->RemoveChild(this);
 			parent_ = nullptr;
 		}
 
-		delete this;
+		if (scriptModule_)
+			scriptModule_->ReleaseEntity(this);
+		else
+			delete this;
+	}
+
+	void Entity::AddSnapshot(double time, double interpolationDelay)
+	{
+		// 没有快照时SmoothedPosition返回的是position_，这里不设置的话，在下一次插值之前它会返回原点
+		bool first = snapshots_.Num() == 0;
+		snapshots_.Add(time, position_, direction_, interpolationDelay);
+
+		if (first)
+		{
+			smoothedPosition_ = position_;
+			smoothedDirection_ = direction_;
+		}
+	}
+
+	void Entity::Recycle()
+	{
+		if (actor_)
+		{
+			actor_->Destroy();
+			actor_ = nullptr;
+		}
+
+		lastSyncPos_ = FVector::ZeroVector;
+		lastSyncDir_ = FVector::ZeroVector;
+		lastSyncLocalPos_ = FVector::ZeroVector;
+		lastSyncLocalDir_ = FVector::ZeroVector;
+		lastSyncTime_ = 0.0;
+
+		inWorld_ = false;
+		inited_ = false;
+		entityCallEnable_ = true;
+
+		id_ = 0;
+		position_ = FVector::ZeroVector;
+		direction_ = FVector::ZeroVector;
+		isOnGround_ = true;
+
+		snapshots_.Clear();
+		smoothedPosition_ = FVector::ZeroVector;
+		smoothedDirection_ = FVector::ZeroVector;
+		isControlled_ = false;
+
+		localPosition_ = FVector::ZeroVector;
+		localDirection_ = FVector::ZeroVector;
+
+		parentID_ = 0;
+		parent_ = nullptr;
+		children_.Reset();
+
+		extraPropertys_.Reset();
+
+		OnRecycle();
 	}
 
 	void Entity::SetParent(Entity* ent)
@@ -430,6 +552,9 @@ namespace KBEngine
 
 		if (parent_)
 		{
+			// 有父对象时随父对象移动，之前的快照不再有效
+			snapshots_.Clear();
+
 			parentID_ = ent->ID();
 			parent_->AddChild(this);
 			localPosition_ = parent_->PositionWorldToLocal(position_);
@@ -458,19 +583,19 @@ namespace KBEngine
 
 			ent->position_ = PositionLocalToWorld(ent->LocalPosition());
 
-			// ֵԱⱻ
+			// 设置最后更新值，以避免被控制者向服务器发送世界坐标或朝向
 			ent->lastSyncPos_ = ent->position_;
 
 			if (!positionOnly)
 			{
 				ent->direction_ = DirectionLocalToWorld(ent->LocalDirection());
 			
-				// ֵԱⱻ
+				// 设置最后更新值，以避免被控制者向服务器发送世界坐标或朝向
 				ent->lastSyncDir_ = ent->direction_;
 			}
 
-			// ѻ򱻱Ƶentityԣ򸸶ƶƶ
-			// 겻Ҫ֪ͨΪÿͻ˶ͬĴҲм㡣
+			// 对于玩家自已或被本机控制的entity而言，因父对象的移动而移动，
+			// 新坐标不需要通知服务器，因为每个客户端都会做同样的处理，服务器也会自行计算。
 			if (ent->IsPlayer() || ent->isControlled_)
 			{
 				ent->lastSyncPos_ = ent->position_;
@@ -516,7 +641,7 @@ namespace KBEngine
 		}
 
 		if (dirChanged)
-			SyncVolatileDataToChildren(false);  // ĳıͬʱӶĳλãҪж
+			SyncVolatileDataToChildren(false);  // 父的朝向改变会同时计算子对象的朝向和位置，所以需要先判断
 		else if (posChanged)
 			SyncVolatileDataToChildren(true);
 	}
@@ -15,12 +15,13 @@ namespace KBEngine
 	TMap<uint16, ScriptModule *> EntityDef::idmoduledefs_;
 
 	bool EntityDef::entityDefImported_ = false;
+	uint32 EntityDef::generation_ = 1;
 
 	void EntityDef::Clear()
 	{
 		KBE_DEBUG(TEXT("EntityDef::Clear"));
 
-		// ڻпܻᱻã˵ַͬʵֻܱһ
+		// 由于基础数据类型有可能会被二次引用，因此地址相同的实例只能保留一份
 		TSet<KBEDATATYPE_BASE *> dataTypeSet;
 		for (auto it : datatypes_)
 			dataTypeSet.Add(it.Value);
@@ -28,7 +29,7 @@ namespace KBEngine
 		for (auto dt : dataTypeSet)
 			delete dt;
 
-		// עScriptModuleEntityDef
+		// 注册进来的ScriptModule由EntityDef来清理
 		for (auto md : moduledefs_)
 			delete md.Value;
 
@@ -39,6 +40,7 @@ namespace KBEngine
 		moduledefs_.Empty(0);
 		idmoduledefs_.Empty(0);
 		entityDefImported_ = false;
+		generation_++;
 	}
 
 	void EntityDef::Init()
@@ -236,11 +238,11 @@ namespace KBEngine
 		id2datatypes_.Add(17, datatypes_["VECTOR4"]);
 
 		datatype2id_.Add("FIXED_DICT", 18);
-		// ﲻҪ󶨣FIXED_DICTҪݲͬʵ̬õid
+		// 这里不需要绑定，FIXED_DICT需要根据不同类型实例化动态得到id
 		//id2datatypes_[18] = datatypes_["FIXED_DICT"];
 
 		datatype2id_.Add("ARRAY", 19);
-		// ﲻҪ󶨣ARRAYҪݲͬʵ̬õid
+		// 这里不需要绑定，ARRAY需要根据不同类型实例化动态得到id
 		//id2datatypes_[19] = datatypes_["ARRAY"];
 
 		datatype2id_.Add("ENTITYCALL", 20);
@@ -248,14 +250,14 @@ namespace KBEngine
 		id2datatypes_.Add(20, datatypes_["ENTITYCALL"]);
 	}
 
-	void EntityDef::CreateDataTypeFromStream(MemoryStream &stream)
+	void EntityDef::CreateDataTypeFromStream(MemoryStreamView &stream)
 	{
 		uint16 utype = stream.ReadUint16();
 		FString name = stream.ReadString();
 		FString valname = stream.ReadString();
 
-		/* һЩͣҪṩһΨһƷŵdatatypes
-		磺
+		/* 有一些匿名类型，我们需要提供一个唯一名称放到datatypes中
+		如：
 		<onRemoveAvatar>
 		<Arg>	ARRAY <of> INT8 </of>		</Arg>
 		</onRemoveAvatar>
@@ -295,7 +297,7 @@ namespace KBEngine
 		}
 	}
 
-	void EntityDef::CreateDataTypesFromStream(MemoryStream &stream)
+	void EntityDef::CreateDataTypesFromStream(MemoryStreamView &stream)
 	{
 		uint16 aliassize = stream.ReadUint16();
 		KBE_DEBUG(TEXT("EntityDef::CreateDataTypesFromStream: importAlias(size=%d)!"), aliassize);
@@ -306,14 +308,14 @@ namespace KBEngine
 			CreateDataTypeFromStream(stream);
 		};
 
-		// °󶨸֮ǰùϵ
+		// 重新绑定各数据类型之前的引用关系
 		BindAllDataType();
 	}
 
-	bool EntityDef::ImportEntityDefFromStream(MemoryStream &stream)
+	bool EntityDef::ImportEntityDefFromStream(MemoryStreamView &stream)
 	{
-		// @TODO(penghuawei): ﵱǰûжЧԽн飬
-		// ԱҷǷͽпܵ¿ͻ˳δ֪
+		// @TODO(penghuawei): 这里当前没有对数据流的有效性进行较验，
+		// 所以如果数据流来自本地且非法，就将有可能导致客户端出现未知的问题
 
 
 		CreateDataTypesFromStream(stream);
@@ -384,6 +386,7 @@ namespace KBEngine
 		}
 
 		entityDefImported_ = true;
+		generation_++;
 		return true;
 	}
 }
@@ -0,0 +1,173 @@
+#include "EntityMessageBuffer.h"
+#include "KBEnginePrivatePCH.h"
+
+namespace KBEngine
+{
+	EntityMessageBuffer::EntityMessageBuffer(uint32 maxBytes, int32 maxAge) :
+		maxBytes_(maxBytes),
+		maxAge_(maxAge)
+	{
+	}
+
+	bool EntityMessageBuffer::Add(int32 entityID, const uint8* datas, uint32 length)
+	{
+		if (records_.Contains(entityID))
+			return false;
+
+		if (length > maxBytes_)
+		{
+			KBE_ERROR(TEXT("EntityMessageBuffer::Add: entity(%d) message is too large(%u > %u)!"), entityID, length, maxBytes_);
+			return false;
+		}
+
+		if ((uint32)arena_.Num() + length > maxBytes_)
+		{
+			Compact();
+
+			while ((uint32)arena_.Num() + length > maxBytes_ && records_.Num() > 0)
+			{
+				EvictOldest();
+				Compact();
+			}
+		}
+
+		Record record;
+		record.offset = arena_.Num();
+		record.length = length;
+		record.time = FPlatformTime::Seconds();
+
+		arena_.Append(datas, length);
+		records_.Add(entityID, record);
+
+		bufferedThisFrame_++;
+		stats_.totalBuffered++;
+		stats_.count = records_.Num();
+		stats_.usedBytes += length;
+		stats_.arenaBytes = arena_.Max();
+		return true;
+	}
+
+	bool EntityMessageBuffer::Find(int32 entityID, MemoryStreamView& out) const
+	{
+		const Record* record = records_.Find(entityID);
+		if (!record)
+			return false;
+
+		out = MemoryStreamView(arena_.GetData() + record->offset, record->length);
+		return true;
+	}
+
+	void EntityMessageBuffer::Remove(int32 entityID)
+	{
+		// 这里不移动数据，调用者可能还持有Find取得的视图
+		Record record;
+		if (!records_.RemoveAndCopyValue(entityID, record))
+			return;
+
+		garbageBytes_ += record.length;
+		stats_.count = records_.Num();
+		stats_.usedBytes -= record.length;
+	}
+
+	void EntityMessageBuffer::Clear()
+	{
+		arena_.Empty();
+		records_.Empty();
+		garbageBytes_ = 0;
+
+		stats_.count = 0;
+		stats_.usedBytes = 0;
+		stats_.arenaBytes = 0;
+	}
+
+	void EntityMessageBuffer::Tick()
+	{
+		stats_.bufferedLastFrame = bufferedThisFrame_;
+		if (bufferedThisFrame_ > stats_.peakBufferedPerFrame)
+			stats_.peakBufferedPerFrame = bufferedThisFrame_;
+		bufferedThisFrame_ = 0;
+
+		if (records_.Num() == 0)
+		{
+			// 没有缓存时只需要归零，保留已分配的空间供下一次使用
+			arena_.Reset();
+			garbageBytes_ = 0;
+			return;
+		}
+
+		if (maxAge_ > 0)
+		{
+			double expired = FPlatformTime::Seconds() - maxAge_;
+
+			TArray<int32> staleIDs;
+			for (auto& it : records_)
+			{
+				if (it.Value.time < expired)
+					staleIDs.Add(it.Key);
+			}
+
+			for (int32 entityID : staleIDs)
+			{
+				KBE_WARNING(TEXT("EntityMessageBuffer::Tick: entity(%d) has not entered world in %d seconds, discard its buffered message!"), entityID, maxAge_);
+				Evict(entityID);
+			}
+		}
+
+		// 废弃的数据超过一半时整理缓冲区
+		if (garbageBytes_ > (uint32)arena_.Num() / 2)
+			Compact();
+
+		stats_.arenaBytes = arena_.Max();
+	}
+
+	void EntityMessageBuffer::Evict(int32 entityID)
+	{
+		Remove(entityID);
+		stats_.evicted++;
+	}
+
+	void EntityMessageBuffer::EvictOldest()
+	{
+		int32 oldestID = 0;
+		double oldestTime = DBL_MAX;
+
+		for (auto& it : records_)
+		{
+			if (it.Value.time < oldestTime)
+			{
+				oldestTime = it.Value.time;
+				oldestID = it.Key;
+			}
+		}
+
+		KBE_WARNING(TEXT("EntityMessageBuffer::EvictOldest: buffer is full(%u bytes), discard entity(%d) buffered message!"), maxBytes_, oldestID);
+		Evict(oldestID);
+	}
+
+	void EntityMessageBuffer::Compact()
+	{
+		if (garbageBytes_ == 0)
+			return;
+
+		// 按偏移排序后依次前移，数据只会向前移动，不会互相覆盖
+		TArray<Record*> records;
+		records.Reserve(records_.Num());
+		for (auto& it : records_)
+			records.Add(&it.Value);
+
+		records.Sort([](const Record& a, const Record& b) { return a.offset < b.offset; });
+
+		uint32 offset = 0;
+		for (Record* record : records)
+		{
+			if (record->offset != offset)
+				FMemory::Memmove(arena_.GetData() + offset, arena_.GetData() + record->offset, record->length);
+
+			record->offset = offset;
+			offset += record->length;
+		}
+
+		arena_.SetNum(offset, false);
+		garbageBytes_ = 0;
+	}
+}
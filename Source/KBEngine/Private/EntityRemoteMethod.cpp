@@ -0,0 +1,103 @@
+#include "EntityRemoteMethod.h"
+#include "KBEnginePrivatePCH.h"
+#include "Entity.h"
+#include "EntityDef.h"
+#include "ScriptModule.h"
+#include "KBEngineApp.h"
+#include "BaseApp.h"
+
+namespace KBEngine
+{
+	EntityRemoteMethod::EntityRemoteMethod(const FString& methodName, Mailbox::MAILBOX_TYPE type) :
+		methodName_(methodName),
+		type_(type)
+	{
+	}
+
+	Method* EntityRemoteMethod::Resolve(Entity* entity)
+	{
+		ScriptModule* scriptModule = entity->GetScriptModule();
+		if (scriptModule && scriptModule == scriptModule_ && generation_ == EntityDef::Generation())
+			return method_;
+
+		// 实体的属性还没有初始化时按类名查找，不缓存结果
+		if (!scriptModule)
+		{
+			ScriptModule* module = EntityDef::GetScriptModule(entity->ClassName());
+			if (!module)
+				return nullptr;
+
+			return type_ == Mailbox::MAILBOX_TYPE::MAILBOX_TYPE_BASE ? module->GetBaseMethod(methodName_) : module->GetCellMethod(methodName_);
+		}
+
+		scriptModule_ = scriptModule;
+		generation_ = EntityDef::Generation();
+		method_ = type_ == Mailbox::MAILBOX_TYPE::MAILBOX_TYPE_BASE ? scriptModule->GetBaseMethod(methodName_) : scriptModule->GetCellMethod(methodName_);
+		return method_;
+	}
+
+	bool EntityRemoteMethod::WriteArg(Bundle* bundle, KBEDATATYPE_BASE* type, const FVariant& v)
+	{
+		if (!KBEngineApp::app->ValidateEntityCallArgs())
+		{
+			type->AddToStream(bundle, v);
+			return true;
+		}
+
+		return type->AddToStreamChecked(bundle, v);
+	}
+
+	Mailbox* EntityRemoteMethod::Prepare(Entity* entity, int32 numArgs, Method*& method)
+	{
+		const TCHAR* callName = type_ == Mailbox::MAILBOX_TYPE::MAILBOX_TYPE_BASE ? TEXT("BaseCall") : TEXT("CellCall");
+
+		if (!KBEngineApp::app->pBaseApp())
+		{
+			KBE_ERROR(TEXT("%s::%s(%s), but no baseapp found!"), *entity->ClassName(), callName, *methodName_);
+			return nullptr;
+		}
+
+		method = Resolve(entity);
+		if (!method)
+		{
+			KBE_ERROR(TEXT("%s::%s(%s), not found method!"), *entity->ClassName(), callName, *methodName_);
+			return nullptr;
+		}
+
+		if (numArgs != method->args.Num())
+		{
+			KBE_ERROR(TEXT("%s::%s(%s): args(%d!=%d) size is error!"),
+				*entity->ClassName(), callName, *methodName_, numArgs, method->args.Num());
+			return nullptr;
+		}
+
+		Mailbox* mailbox = type_ == Mailbox::MAILBOX_TYPE::MAILBOX_TYPE_BASE ? entity->BaseMailbox() : entity->CellMailbox();
+		if (!mailbox)
+		{
+			KBE_ERROR(TEXT("%s::%s(%s): no %s!"), *entity->ClassName(), callName, *methodName_,
+				type_ == Mailbox::MAILBOX_TYPE::MAILBOX_TYPE_BASE ? TEXT("base") : TEXT("cell"));
+			return nullptr;
+		}
+
+		if (!entity->EntityCallEnable())
+		{
+			KBE_ERROR(TEXT("%s::%s(%s), but entity call is disable!"), *entity->ClassName(), callName, *methodName_);
+			return nullptr;
+		}
+
+		return mailbox;
+	}
+
+	bool EntityRemoteMethod::Finish(Entity* entity, Method* method, Mailbox* mailbox, int32 failedArg)
+	{
+		if (failedArg >= 0)
+		{
+			KBE_ERROR(TEXT("%s::%s: arg%d: %s"), *entity->ClassName(), *methodName_, failedArg, method->args[failedArg]->TypeString());
+			mailbox->DiscardMail();
+			return false;
+		}
+
+		mailbox->PostMail(KBEngineApp::app->pBaseApp()->pNetworkInterface());
+		return true;
+	}
+}
@@ -0,0 +1,116 @@
+#include "EntitySnapshotBuffer.h"
+#include "KBEnginePrivatePCH.h"
+
+namespace KBEngine
+{
+	const double EntitySnapshotBuffer::MAX_SNAPSHOT_GAP = 1.0;
+
+	static FVector LerpDirection(const FVector& from, const FVector& to, float alpha)
+	{
+		return FVector(
+			from.X + FMath::FindDeltaAngleDegrees(from.X, to.X) * alpha,
+			from.Y + FMath::FindDeltaAngleDegrees(from.Y, to.Y) * alpha,
+			from.Z + FMath::FindDeltaAngleDegrees(from.Z, to.Z) * alpha);
+	}
+
+	void EntitySnapshotBuffer::Push(double time, const FVector& position, const FVector& direction)
+	{
+		if (count_ == CAPACITY)
+		{
+			head_ = (head_ + 1) % CAPACITY;
+			--count_;
+		}
+
+		Snapshot& snapshot = snapshots_[(head_ + count_) % CAPACITY];
+		snapshot.time = time;
+		snapshot.position = position;
+		snapshot.direction = direction;
+		++count_;
+	}
+
+	void EntitySnapshotBuffer::Add(double time, const FVector& position, const FVector& direction, double interpolationDelay)
+	{
+		if (count_ > 0)
+		{
+			if (time - At(count_ - 1).time > MAX_SNAPSHOT_GAP)
+			{
+				Snapshot last = At(count_ - 1);
+				Reset(time - interpolationDelay, last.position, last.direction);
+			}
+
+			// 时间戳必须严格递增，同一时刻收到的多个快照只保留最后一个
+			Snapshot& newest = snapshots_[(head_ + count_ - 1) % CAPACITY];
+			if (time <= newest.time)
+			{
+				newest.position = position;
+				newest.direction = direction;
+				return;
+			}
+		}
+
+		Push(time, position, direction);
+	}
+
+	void EntitySnapshotBuffer::Reset(double time, const FVector& position, const FVector& direction)
+	{
+		Clear();
+		Push(time, position, direction);
+	}
+
+	void EntitySnapshotBuffer::Clear()
+	{
+		head_ = 0;
+		count_ = 0;
+	}
+
+	bool EntitySnapshotBuffer::Evaluate(double renderTime, double maxExtrapolation, FVector& outPosition, FVector& outDirection) const
+	{
+		if (count_ == 0)
+			return false;
+
+		const Snapshot& oldest = At(0);
+		if (count_ == 1 || renderTime <= oldest.time)
+		{
+			outPosition = oldest.position;
+			outDirection = oldest.direction;
+			return true;
+		}
+
+		const Snapshot& newest = At(count_ - 1);
+		if (renderTime >= newest.time)
+		{
+			const Snapshot& prev = At(count_ - 2);
+
+			outPosition = newest.position;
+			outDirection = newest.direction;
+
+			double extrapolation = FMath::Min(renderTime - newest.time, maxExtrapolation);
+			if (extrapolation > 0.0)
+			{
+				// 快照的时间戳严格递增，因此间隔总是大于0
+				float scale = (float)(extrapolation / (newest.time - prev.time));
+				outPosition += (newest.position - prev.position) * scale;
+			}
+
+			return true;
+		}
+
+		for (int32 i = count_ - 2; i >= 0; --i)
+		{
+			const Snapshot& from = At(i);
+			if (from.time > renderTime)
+				continue;
+
+			const Snapshot& to = At(i + 1);
+			float alpha = (float)((renderTime - from.time) / (to.time - from.time));
+
+			outPosition = FMath::Lerp(from.position, to.position, alpha);
+			outDirection = LerpDirection(from.direction, to.direction, alpha);
+			return true;
+		}
+
+		outPosition = oldest.position;
+		outDirection = oldest.direction;
+		return true;
+	}
+}
@@ -6,7 +6,7 @@
 //DEFINE_LOG_CATEGORY(KBELog)
 
 
-// 16ƴָλֽ
+// 以16进制从指定位置输出缓存的字节
 void hexlike(const uint8* buffer, uint32 startPos, uint32 size)
 {
 	uint32 j = 1, k = 1;
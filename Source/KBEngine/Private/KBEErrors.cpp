@@ -40,7 +40,7 @@ namespace KBEngine
 		}
 	}
 
-	bool KBEErrors::ImportServerErrorsDescr(MemoryStream &stream)
+	bool KBEErrors::ImportServerErrorsDescr(MemoryStreamView &stream)
 	{
 		// @TODO(penghuawei): 这里当前没有对数据流的有效性进行较验，
 		// 所以如果数据流来自本地且非法，就将有可能导致客户端出现未知的问题
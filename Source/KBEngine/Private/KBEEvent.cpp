@@ -78,8 +78,8 @@ namespace KBEngine
 	void KBEEvent::Fire(const FString& eventName, const FVariantArray &args)
 	{
 		EventFuncArray lst;
-		// һݺбԱصΪעбһ
-		// ҪΪ˱ڶ߳߳ظ
+		// 复制一份函数列表出来，以避免回调过程中因为注销问题而产生列表不一致
+		// 更重要的是为了避免在多线程下线程锁重复锁的问题
 		CopyEvent(lst, eventName);
 		if (lst.Num() == 0)
 		{
@@ -122,8 +122,8 @@ namespace KBEngine
 			EventObj eobj = doingEvents[i];
 
 			lst.Reset();
-			// һݺбԱصΪעбһ
-			// ҪΪ˱ڶ߳߳ظ
+			// 复制一份函数列表出来，以避免回调过程中因为注销问题而产生列表不一致
+			// 更重要的是为了避免在多线程下线程锁重复锁的问题
 			CopyEvent(lst, eobj.name);
 			if (lst.Num() == 0)
 			{
@@ -155,7 +155,7 @@ namespace KBEngine
 	{
 		MonitorEnter(cs_events_);
 
-		//  GetEvent()Աظ
+		// 不能用 GetEvent()，以避免重复锁
 		EventFuncArray** p = events_.Find(eventName);
 		EventFuncArray* lst = p ? *p : nullptr;
 		if (!lst)
@@ -97,6 +97,25 @@ void AKBEMain::InitKBEngine()
 
 	args->TCP_SEND_BUFFER_MAX = TCP_SEND_BUFFER_MAX;
 	args->TCP_RECV_BUFFER_MAX = TCP_RECV_BUFFER_MAX;
+	args->TCP_RECV_BUFFER_LIMIT = TCP_RECV_BUFFER_LIMIT;
+	args->STREAM_POOL_MAX = STREAM_POOL_MAX;
+
+	args->useFrameBundle = useFrameBundle;
+	args->frameBundleMaxBytes = (uint32)frameBundleMaxBytes;
+	args->frameBundleMaxLatency = frameBundleMaxLatency;
+
+	args->useVolatileDataBatch = useVolatileDataBatch;
+	args->entityPoolSize = entityPoolSize;
+
+	args->useInterpolation = useInterpolation;
+	args->interpolationDelay = interpolationDelay;
+	args->maxExtrapolationTime = maxExtrapolationTime;
+
+	args->playerSyncMaxInterval = playerSyncMaxInterval;
+	args->playerSyncDistance = playerSyncDistance;
+
+	args->fixedDictAsStruct = fixedDictAsStruct;
+	args->validateEntityCallArgs = validateEntityCallArgs;
 
 	args->forceDisableUDP = forceDisableUDP;
 	args->UDP_SEND_BUFFER_MAX = UDP_SEND_BUFFER_MAX;
@@ -117,8 +136,8 @@ void AKBEMain::TestResolveIPAddress()
 	TSharedPtr<FInternetAddr> remoteAddr = SocketSubsystem->CreateInternetAddr();
 	
 	bool bIsValid = false;
-	remoteAddr->SetIp(*host, bIsValid);	// ֤Ƿipַ
-	if (!bIsValid)						// ipַΪ
+	remoteAddr->SetIp(*host, bIsValid);	// 验证是否ip地址
+	if (!bIsValid)						// 不是ip地址，作为域名解析
 	{
 		ESocketErrors HostResolveError = SocketSubsystem->GetHostByName(TCHAR_TO_ANSI(*host), *remoteAddr);
 		if (HostResolveError == SE_NO_ERROR || HostResolveError == SE_EWOULDBLOCK)
@@ -127,7 +146,7 @@ void AKBEMain::TestResolveIPAddress()
 			KBE_WARNING(TEXT("AKBEMain::TestGetIPAddress:resolve ---> %s to %s."), *host, *outIP);
 		}
 
-		/* ½ʽᵼ±⣬δоԭ
+		/* 以下解析方式会导致崩溃问题，还未研究原因
 		FResolveInfo *resolvInfo = SocketSubsystem->GetHostByName(TCHAR_TO_ANSI(*host));
 		if (resolvInfo == NULL)
 		{
@@ -135,7 +154,7 @@ void AKBEMain::TestResolveIPAddress()
 			return;
 		}
 
-		FString outIP = resolvInfo->GetResolvedAddress().ToString(false);	// ˴
+		FString outIP = resolvInfo->GetResolvedAddress().ToString(false);	// 此处会崩
 		KBE_WARNING(TEXT("AKBEMain::TestGetIPAddress:resolve ------------------------> %s to %s."), *host, *outIP);
 		*/
 	}
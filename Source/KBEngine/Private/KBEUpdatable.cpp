@@ -1,4 +1,4 @@
-﻿#include "KBEUpdatable.h"
+#include "KBEUpdatable.h"
 #include "KBEnginePrivatePCH.h"
 
 
@@ -9,6 +9,7 @@
 #include "KBEErrors.h"
 #include "EntityDef.h"
 #include "KBEEvent.h"
+#include "MemoryStreamPool.h"
 
 namespace KBEngine
 {
@@ -26,8 +27,9 @@ namespace KBEngine
 		KBEErrors::InitLocalErrors();
 
 		args_ = args;
+		MemoryStreamPool::SetHighWaterMark(args_->STREAM_POOL_MAX);
 
-		// ־ûKBE(:Э飬entitydef)
+		// 允许持久化KBE(例如:协议，entitydef等)
 		if (args->persistentDataPath != "")
 			persistentInofs_ = new PersistentInofs(args_->persistentDataPath, ClientVersion(), ClientScriptVersion(), LoginappHost(), LoginappPort());
 	}
@@ -43,6 +45,7 @@ namespace KBEngine
 		CloseAcrossBaseApp();
 		KBEErrors::Clear();
 		EntityDef::Clear();
+		MemoryStreamPool::Clear();
 		KBEngineApp::app = nullptr;
 	}
 
@@ -104,7 +107,7 @@ namespace KBEngine
 			loseConnectedFromServer_ = false;
 		}
 
-		// 
+		// 处理额外任务
 		updatables_.Update();
 
 		if (loginApp_)
@@ -209,7 +212,7 @@ namespace KBEngine
 
 		baseApp_ = new BaseApp(this);
 		
-		// LoginAppΪʱ뻹LoginAppProcess()
+		// 不能在这里销毁LoginApp，因为此时代码还在LoginApp的Process()层次
 		//CloseLoginApp();
 
 		baseApp_->Connect(baseappHost, baseappTcpPort, baseappUdpPort, std::bind(&KBEngineApp::OnConnectToBaseappCB, this, std::placeholders::_1));
@@ -217,7 +220,7 @@ namespace KBEngine
 
 	void KBEngineApp::OnConnectToBaseappCB(int32 code)
 	{
-		// ΣLoginAppǰȫ
+		// 不管如何，在这里清理LoginApp是安全的
 		CloseLoginApp();
 
 		if (code != (int32)ERROR_TYPE::SUCCESS)
@@ -343,7 +346,7 @@ namespace KBEngine
 		acrossBaseappPort_ = port;
 		acrossLoginReadyTime_ = FDateTime::UtcNow();
 
-		// todo: ¼ڻƣ״̬ãݡ
+		// todo: 登录过期机制，状态设置，过期清理数据。
 
 		if (KBEPersonality::Instance())
 			KBEPersonality::Instance()->OnAcrossServerReady();
@@ -363,11 +366,11 @@ namespace KBEngine
 		KBE_ASSERT(!baseApp_);
 		KBE_ASSERT(!acrossBaseApp_);
 
-		//ָһ£Ȼ֮ΪѾʼassert
+		//恢复一下，不然之后会因为已经初始化而触发assert
 		pMessages()->BaseappMessageImported(false);
 		EntityDef::EntityDefImported(false);
 
-		// TODO(shufeng): ӿkcpЭ֧
+		// TODO(shufeng): 添加跨服kcp协议支持
 		uint16 udpPort = 0;
 
 		acrossBaseApp_ = new BaseApp(this);
@@ -417,11 +420,11 @@ namespace KBEngine
 
 		EntityDef::Init();
 
-		//ָһ£Ȼ֮ΪѾʼassert
+		//恢复一下，不然之后会因为已经初始化而触发assert
 		pMessages()->BaseappMessageImported(false);
 		EntityDef::EntityDefImported(false);
 
-		// TODO: ʹе˺½Դ
+		// TODO: 使用已有的账号密码登陆源服务器
 		loginApp_ = new LoginApp(this);
 		loginApp_->Connect(LoginappHost(), LoginappPort(), std::bind(&KBEngineApp::OnConnectToLoginappCB, this, std::placeholders::_1, TEXT("Login")));
 	}
@@ -15,13 +15,14 @@ namespace KBEngine
 	{
 		KBE_ASSERT(app_);
 		messages_ = app->pMessages();
-		messageReader_ = new MessageReader(this, messages_, KBEngineApp::app->GetTcpRecvBufferMax());
-
+		messageReader_ = new MessageReader(this, messages_);
+		messages_->RegisterHandler(this);
 	}
 
 	LoginApp::~LoginApp()
 	{
 		KBE_DEBUG(TEXT("LoginApp::~LoginApp()"));
+		messages_->UnregisterHandler(this);
 		ClearNetwork();
 		SAFE_DELETE(messageReader_);
 	}
@@ -40,11 +41,11 @@ namespace KBEngine
 
 		if (span.GetTotalSeconds() >= app_->TickInterval())
 		{
-			// phw: жϴҪkbe 0.8.10ϰ汾ķ֧
+			// phw: 心跳判断代码需要kbe 0.8.10以上版本的服务器支持
 			span = lastTickCBTime_ - lastTicktime_;
 
-			// صʱСʱ䣬˵ûյص
-			// ʱӦ֪ͨͻ˵
+			// 如果心跳回调接收时间小于心跳发送时间，说明没有收到回调
+			// 此时应该通知客户端掉线了
 			if (span.GetTotalSeconds() < 0)
 			{
 				KBE_ERROR(TEXT("LoginApp::SendTick: Receive appTick timeout!"));
@@ -95,8 +96,8 @@ namespace KBEngine
 	{
 		if (networkInterface_)
 		{
-			networkInterface_->Close();
-			delete networkInterface_;
+			// 可能是在这个网络的消息处理函数中调用的，由Destroy决定何时真正销毁
+			NetworkInterfaceBase::Destroy(networkInterface_);
 			networkInterface_ = nullptr;
 		}
 	}
@@ -129,7 +130,7 @@ namespace KBEngine
 		delete bundle;
 	}
 
-	void LoginApp::Client_onHelloCB(MemoryStream &stream)
+	void LoginApp::Client_onHelloCB(MemoryStreamView &stream)
 	{
 		FString serverVersion = stream.ReadString();
 		FString serverScriptVersion = stream.ReadString();
@@ -151,13 +152,13 @@ namespace KBEngine
 		bool success = digestMatch;
 		if (success)
 		{
-			// ԼرϢ
+			// 尝试加载本地消息定义
 			MemoryStream out;
 			success = app_->pPersistentInofs()->LoadLoginappMessages(out);
 			if (success)
 				success = messages_->ImportMessagesFromStream(out, SERVER_APP_TYPE::LoginApp);
 	
-			// Լرش
+			// 尝试加载本地错误定义
 			out.Clear();
 			if (success)
 				success = app_->pPersistentInofs()->LoadServerErrorsDescr(out);
@@ -166,19 +167,19 @@ namespace KBEngine
 				success = KBEErrors::ImportServerErrorsDescr(out);
 		}
 
-		// ʧ
+		// 加载失败则向服务器请求
 		if (!digestMatch || !success)
 		{
 			CmdImportClientMessages();
 		}
 		else
 		{
-			// ݶɣԽ¼
+			// 如果两种数据都加载完成，则可以结束登录流程
 			connectedCallbackFunc_((int)ERROR_TYPE::SUCCESS);
 		}
 	}
 
-	void LoginApp::Client_onVersionNotMatch(MemoryStream &stream)
+	void LoginApp::Client_onVersionNotMatch(MemoryStreamView &stream)
 	{
 		auto serverVersion = stream.ReadString();
 
@@ -191,7 +192,7 @@ namespace KBEngine
 		Disconnect();
 	}
 
-	void LoginApp::Client_onScriptVersionNotMatch(MemoryStream &stream)
+	void LoginApp::Client_onScriptVersionNotMatch(MemoryStreamView &stream)
 	{
 		auto serverScriptVersion = stream.ReadString();
 
@@ -214,12 +215,12 @@ namespace KBEngine
 		delete bundle;
 	}
 
-	void LoginApp::Client_onImportClientMessages(MemoryStream &stream)
+	void LoginApp::Client_onImportClientMessages(MemoryStreamView &stream)
 	{
 		KBE_DEBUG(TEXT("LoginApp::Client_onImportClientMessages: stream size: %d"), stream.Length());
 
-		// ȸһݳΪд׼
-		MemoryStream datas(stream);
+		// 先记下当前的读取位置，以为写入作准备（视图只借用内存，无需复制）
+		MemoryStreamView datas(stream);
 
 		messages_->ImportMessagesFromStream(stream, SERVER_APP_TYPE::LoginApp);
 
@@ -238,12 +239,12 @@ namespace KBEngine
 		delete bundle;
 	}
 
-	void LoginApp::Client_onImportServerErrorsDescr(MemoryStream &stream)
+	void LoginApp::Client_onImportServerErrorsDescr(MemoryStreamView &stream)
 	{
 		KBE_DEBUG(TEXT("LoginApp::Client_onImportServerErrorsDescr: stream size: %d"), stream.Length());
 
-		// ȸһݳΪд׼
-		MemoryStream datas(stream);
+		// 先记下当前的读取位置，以为写入作准备（视图只借用内存，无需复制）
+		MemoryStreamView datas(stream);
 
 		KBEErrors::ImportServerErrorsDescr(stream);
 
@@ -280,7 +281,7 @@ namespace KBEngine
 
 	}
 
-	void LoginApp::Client_onLoginFailed(MemoryStream &stream)
+	void LoginApp::Client_onLoginFailed(MemoryStreamView &stream)
 	{
 		uint16 failedcode = stream.ReadUint16();
 		TArray<uint8> serverDatas;
@@ -291,7 +292,7 @@ namespace KBEngine
 			connectedCallbackFunc_(failedcode);
 	}
 
-	void LoginApp::Client_onLoginSuccessfully(MemoryStream &stream)
+	void LoginApp::Client_onLoginSuccessfully(MemoryStreamView &stream)
 	{
 		baseappAccount_ = stream.ReadString();;
 		baseappHost_ = stream.ReadString();
@@ -355,7 +356,7 @@ namespace KBEngine
 		delete bundle;
 	}
 
-	void LoginApp::Client_onCreateAccountResult(MemoryStream &stream)
+	void LoginApp::Client_onCreateAccountResult(MemoryStreamView &stream)
 	{
 		uint16 retcode = stream.ReadUint16();
 		TArray<uint8> datas;
@@ -384,7 +385,6 @@ namespace KBEngine
 		if (networkInterface_)
 		{
 			networkInterface_->Process();
-			messageReader_->Process();
 		}
 
 		if (networkInterface_ && networkInterface_->Valid())
@@ -393,53 +393,67 @@ namespace KBEngine
 		}
 	}
 
-	void LoginApp::HandleMessage(const FString &name, MemoryStream *stream)
+	const LoginApp::DispatchTable::HandlerMap& LoginApp::MessageHandlers()
 	{
-		if (name == "Client_onHelloCB") {
-			Client_onHelloCB(*stream);
-		}
-		else if (name == "Client_onScriptVersionNotMatch") {
-			Client_onScriptVersionNotMatch(*stream);
-		}
-		else if (name == "Client_onVersionNotMatch") {
-			Client_onVersionNotMatch(*stream);
-		}
-		else if (name == "Client_onImportClientMessages") {
-			Client_onImportClientMessages(*stream);
-		}
-		else if (name == "Client_onImportServerErrorsDescr") {
+		// 只在第一次使用时构建，之后所有LoginApp实例共享
+		static const DispatchTable::HandlerMap handlers = []()
+		{
+			DispatchTable::HandlerMap handlers;
+
+			// 参数为原始数据流的消息
+			handlers.Add(TEXT("Client_onHelloCB"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&LoginApp::Client_onHelloCB>));
+			handlers.Add(TEXT("Client_onScriptVersionNotMatch"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&LoginApp::Client_onScriptVersionNotMatch>));
+			handlers.Add(TEXT("Client_onVersionNotMatch"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&LoginApp::Client_onVersionNotMatch>));
+			handlers.Add(TEXT("Client_onImportClientMessages"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&LoginApp::Client_onImportClientMessages>));
+			handlers.Add(TEXT("Client_onImportServerErrorsDescr"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&LoginApp::Client_onImportServerErrorsDescr>));
+			handlers.Add(TEXT("Client_onLoginFailed"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&LoginApp::Client_onLoginFailed>));
+			handlers.Add(TEXT("Client_onLoginSuccessfully"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&LoginApp::Client_onLoginSuccessfully>));
+			handlers.Add(TEXT("Client_onCreateAccountResult"), DispatchTable::MakeEntry(&DispatchTable::StreamThunk<&LoginApp::Client_onCreateAccountResult>));
+			handlers.Add(TEXT("Client_onAppActiveTickCB"), DispatchTable::MakeEntry([](LoginApp* handler, MemoryStreamView&) { handler->Client_onAppActiveTickCB(); }));
+
+			// 参数已经被反序列化的消息
+			handlers.Add(TEXT("Client_onReqAccountResetPasswordCB"), DispatchTable::MakeEntry([](LoginApp* handler, const TArray<FVariant>& args) {
+				handler->Client_onReqAccountResetPasswordCB(args[0].GetValue<uint16>());
+			}));
+
+			return handlers;
+		}();
+
+		return handlers;
+	}
 
-			Client_onImportServerErrorsDescr(*stream);
-		}
-		else if (name == "Client_onLoginFailed") {
+	void LoginApp::BindMessage(const Message& msg)
+	{
+		dispatchTable_.Bind(msg.ID(), msg.Handler(), MessageHandlers());
+	}
 
-			Client_onLoginFailed(*stream);
-		}
-		else if (name == "Client_onLoginSuccessfully") {
-			Client_onLoginSuccessfully(*stream);
-		}
-		else if (name == "Client_onCreateAccountResult") {
-			Client_onCreateAccountResult(*stream);
-		}
-		else if (name == "Client_onAppActiveTickCB") {
-			Client_onAppActiveTickCB();
-		}
-		else
+	void LoginApp::UnbindMessages()
+	{
+		dispatchTable_.Clear();
+	}
+
+	void LoginApp::HandleMessage(const Message& msg, MemoryStreamView *stream)
+	{
+		auto handler = dispatchTable_.FindStreamHandler(msg.ID());
+		if (!handler)
 		{
-			KBE_ERROR(TEXT("LoginApp::HandleMessage: 1 - unknown message '%s'"), *name);
+			KBE_ERROR(TEXT("LoginApp::HandleMessage: 1 - unknown message '%s'"), *msg.Handler());
+			return;
 		}
+
+		handler(this, *stream);
 	}
 
-	void LoginApp::HandleMessage(const FString &name, const TArray<FVariant> &args)
+	void LoginApp::HandleMessage(const Message& msg, const TArray<FVariant> &args)
 	{
-		if (name == "Client_onReqAccountResetPasswordCB") {
-			Client_onReqAccountResetPasswordCB(args[0].GetValue<uint16>());
-		}
-		else
+		auto handler = dispatchTable_.FindArgsHandler(msg.ID());
+		if (!handler)
 		{
-			KBE_ERROR(TEXT("LoginApp::HandleMessage: 2 - unknown message '%s'"), *name);
+			KBE_ERROR(TEXT("LoginApp::HandleMessage: 2 - unknown message '%s'"), *msg.Handler());
+			return;
 		}
 
+		handler(this, args);
 	}
 
 }
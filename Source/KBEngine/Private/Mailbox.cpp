@@ -4,6 +4,22 @@
 
 namespace KBEngine
 {
+	// 远程调用的消息描述，以MAILBOX_TYPE为下标；消息表变化后重新查找，避免每次调用都按名字查找
+	static const Message* RemoteCallMessage(Mailbox::MAILBOX_TYPE type)
+	{
+		static uint32 generation = 0;
+		static const Message* messages[2] = { nullptr, nullptr };
+
+		if (generation != Messages::Generation())
+		{
+			Messages* pMessages = KBEngineApp::app->pBaseApp()->pMessages();
+			messages[(int32)Mailbox::MAILBOX_TYPE::MAILBOX_TYPE_CELL] = pMessages->GetMessage("Baseapp_onRemoteCallCellMethodFromClient");
+			messages[(int32)Mailbox::MAILBOX_TYPE::MAILBOX_TYPE_BASE] = pMessages->GetMessage("Entity_onRemoteMethodCall");
+			generation = Messages::Generation();
+		}
+
+		return messages[(int32)type];
+	}
 
 	Mailbox::Mailbox(int32 entityID, const FString& entityType, MAILBOX_TYPE mbType) :
 		id_(entityID),
@@ -17,15 +33,20 @@ namespace KBEngine
 		SAFE_DELETE(bundle_);
 	}
 
+	void Mailbox::Reset(int32 entityID, const FString& entityType, MAILBOX_TYPE mbType)
+	{
+		id_ = entityID;
+		className_ = entityType;
+		type_ = mbType;
+		SAFE_DELETE(bundle_);
+	}
+
 	Bundle *Mailbox::NewMail()
 	{
 		if (bundle_ == NULL)
 			bundle_ = new Bundle();
 
-		if (type_ == MAILBOX_TYPE::MAILBOX_TYPE_CELL)
-			bundle_->NewMessage(KBEngineApp::app->pBaseApp()->pMessages()->GetMessage("Baseapp_onRemoteCallCellMethodFromClient"));
-		else
-			bundle_->NewMessage(KBEngineApp::app->pBaseApp()->pMessages()->GetMessage("Entity_onRemoteMethodCall"));
+		bundle_->NewMessage(RemoteCallMessage(type_));
 
 		bundle_->WriteInt32(id_);
 
@@ -36,9 +57,19 @@ namespace KBEngine
 	{
 		KBE_ASSERT(bundle_);
 
-		bundle_->Send(networkInterface);
+		// 经由BaseApp发送，以便参与帧合并
+		BaseApp* baseApp = KBEngineApp::app->pBaseApp();
+		if (baseApp && baseApp->pNetworkInterface() == networkInterface)
+			baseApp->SendBundle(bundle_);
+		else
+			bundle_->Send(networkInterface);
 
 		SAFE_DELETE(bundle_);
 	}
 
+	void Mailbox::DiscardMail()
+	{
+		SAFE_DELETE(bundle_);
+	}
+
 }
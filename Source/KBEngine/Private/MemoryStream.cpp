@@ -1,4 +1,5 @@
 #include "MemoryStream.h"
+#include "PackedFloat.h"
 #include "KBEnginePrivatePCH.h"
 #include <string>
 
@@ -20,7 +21,7 @@ namespace KBEngine
 
 
 
-	std::string MemoryStream::ReadStdString()
+	std::string MemoryStreamView::ReadStdString()
 	{
 		size_t offset = rpos_;
 		while (ReadUint8() != 0)
@@ -30,7 +31,7 @@ namespace KBEngine
 		return std::string((const char *)(Data() + offset), rpos_ - offset - 1);
 	}
 
-	FString MemoryStream::ReadString()	//ansi string
+	FString MemoryStreamView::ReadString()	//ansi string
 	{
 		size_t offset = rpos_;
 		while (ReadUint8() != 0)
@@ -41,7 +42,7 @@ namespace KBEngine
 		return FString(s.Length(), s.Get());
 	}
 
-	FString MemoryStream::ReadUTF8()		//utf-8 string
+	FString MemoryStreamView::ReadUTF8()		//utf-8 string
 	{
 		if (Length() <= 0)
 			return FString();
@@ -60,7 +61,7 @@ namespace KBEngine
 		return FString();
 	}
 
-	uint32 MemoryStream::ReadBlob(std::string &datas)
+	uint32 MemoryStreamView::ReadBlob(std::string &datas)
 	{
 		if (Length() <= 0)
 			return 0;
@@ -78,7 +79,7 @@ namespace KBEngine
 		return rsize;
 	}
 
-	uint32 MemoryStream::ReadBlob(TArray<uint8> &bytes)
+	uint32 MemoryStreamView::ReadBlob(TArray<uint8> &bytes)
 	{
 		if (Length() <= 0)
 			return 0;
@@ -97,61 +98,24 @@ namespace KBEngine
 		return rsize;
 	}
 
-	void MemoryStream::ReadPackXYZ(float& x, float&y, float& z, float minf)
+	void MemoryStreamView::ReadPackXYZ(float& x, float&y, float& z, float minf)
 	{
-		uint32 packed = ReadUint32();
-		x = ((packed & 0x7FF) << 21 >> 21) * 0.25f;
-		z = ((((packed >> 11) & 0x7FF) << 21) >> 21) * 0.25f;
-		y = ((packed >> 22 << 22) >> 22) * 0.25f;
-
-		x += minf;
-		y += minf / 2.f;
-		z += minf;
+		PackedFloat::DecodeXYZ(ReadUint32(), x, y, z, minf);
 	}
 
-	void MemoryStream::ReadPackXZ(float& x, float& z)
+	void MemoryStreamView::ReadPackXZ(float& x, float& z)
 	{
-		PackFloatXType & xPackData = (PackFloatXType&)x;
-		PackFloatXType & zPackData = (PackFloatXType&)z;
+		uint8 datas[3];
+		datas[0] = ReadUint8();
+		datas[1] = ReadUint8();
+		datas[2] = ReadUint8();
 
-		// 0x40000000 = 1000000000000000000000000000000.
-		xPackData.uv = 0x40000000;
-		zPackData.uv = 0x40000000;
-
-		uint8 tv;
-		uint32 data = 0;
-
-		tv = ReadUint8();
-		data |= (tv << 16);
-
-		tv = ReadUint8();
-		data |= (tv << 8);
-
-		tv = ReadUint8();
-		data |= tv;
-
-		// ָβ
-		xPackData.uv |= (data & 0x7ff000) << 3;
-		zPackData.uv |= (data & 0x0007ff) << 15;
-
-		xPackData.fv -= 2.0f;
-		zPackData.fv -= 2.0f;
-
-		// ñλ
-		xPackData.uv |= (data & 0x800000) << 8;
-		zPackData.uv |= (data & 0x000800) << 20;
+		PackedFloat::DecodeXZ(PackedFloat::LoadXZ(datas), x, z);
 	}
 
-	void MemoryStream::ReadPackY(float& y)
+	void MemoryStreamView::ReadPackY(float& y)
 	{
-		PackFloatXType yPackData;
-		yPackData.uv = 0x40000000;
-
-		uint16 data = ReadUint16();
-		yPackData.uv |= (data & 0x7fff) << 12;
-		yPackData.fv -= 2.f;
-		yPackData.uv |= (data & 0x8000) << 16;
-		y = yPackData.fv;
+		y = PackedFloat::DecodeY(ReadUint16());
 	}
 
 }
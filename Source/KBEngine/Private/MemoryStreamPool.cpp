@@ -0,0 +1,114 @@
+#include "MemoryStreamPool.h"
+#include "KBEnginePrivatePCH.h"
+
+namespace KBEngine
+{
+	FCriticalSection MemoryStreamPool::lock_;
+	TArray<MemoryStream*> MemoryStreamPool::freeStreams_;
+	int32 MemoryStreamPool::highWaterMark_ = MemoryStreamPool::DEFAULT_HIGH_WATER_MARK;
+	MemoryStreamPoolStats MemoryStreamPool::stats_;
+
+	MemoryStream* MemoryStreamPool::Acquire()
+	{
+		MemoryStream* stream = nullptr;
+
+		{
+			FScopeLock lock(&lock_);
+
+			if (freeStreams_.Num() > 0)
+			{
+				stream = freeStreams_.Pop(false);
+				stats_.hits += 1;
+			}
+			else
+			{
+				stats_.misses += 1;
+			}
+
+			stats_.usedCount += 1;
+			if (stats_.usedCount > stats_.peakUsedCount)
+				stats_.peakUsedCount = stats_.usedCount;
+		}
+
+		// 分配放到锁外进行
+		if (!stream)
+			stream = new MemoryStream();
+
+		return stream;
+	}
+
+	void MemoryStreamPool::Release(MemoryStream* stream)
+	{
+		if (!stream)
+			return;
+
+		stream->Clear();
+
+		{
+			FScopeLock lock(&lock_);
+			stats_.usedCount -= 1;
+
+			if (freeStreams_.Num() < highWaterMark_)
+			{
+				freeStreams_.Add(stream);
+				return;
+			}
+
+			stats_.discards += 1;
+		}
+
+		delete stream;
+	}
+
+	void MemoryStreamPool::SetHighWaterMark(int32 count)
+	{
+		TArray<MemoryStream*> discards;
+
+		{
+			FScopeLock lock(&lock_);
+			highWaterMark_ = FMath::Max(count, 0);
+
+			while (freeStreams_.Num() > highWaterMark_)
+				discards.Add(freeStreams_.Pop(false));
+		}
+
+		for (auto s : discards)
+			delete s;
+	}
+
+	int32 MemoryStreamPool::HighWaterMark()
+	{
+		FScopeLock lock(&lock_);
+		return highWaterMark_;
+	}
+
+	MemoryStreamPoolStats MemoryStreamPool::Stats()
+	{
+		FScopeLock lock(&lock_);
+		MemoryStreamPoolStats stats = stats_;
+		stats.freeCount = freeStreams_.Num();
+		return stats;
+	}
+
+	void MemoryStreamPool::ResetStats()
+	{
+		FScopeLock lock(&lock_);
+		stats_.hits = 0;
+		stats_.misses = 0;
+		stats_.discards = 0;
+		stats_.peakUsedCount = stats_.usedCount;
+	}
+
+	void MemoryStreamPool::Clear()
+	{
+		TArray<MemoryStream*> streams;
+
+		{
+			FScopeLock lock(&lock_);
+			Swap(streams, freeStreams_);
+		}
+
+		for (auto s : streams)
+			delete s;
+	}
+}
@@ -15,8 +15,8 @@ namespace KBEngine
 		handler_(msghandler),
 		argsType_(argstype)
 	{
-		// ԸϢв󶨷лķܹתΪҪֵ
-		// ڷ·Ϣʱõ
+		// 对该消息的所有参数绑定反序列化方法，改方法能够将二进制流转化为参数需要的值
+		// 在服务端下发消息数据时会用到
 		argTypes_.SetNumUninitialized(msgargtypes.Num());
 		for (int i = 0; i<msgargtypes.Num(); i++)
 		{
@@ -34,7 +34,7 @@ namespace KBEngine
 	{
 	}
 
-	void Message::CreateFromStream(MemoryStream *msgstream, TArray<FVariant> &out) const
+	void Message::CreateFromStream(MemoryStreamView *msgstream, TArray<FVariant> &out) const
 	{
 		if (argTypes_.Num() <= 0)
 		{
@@ -52,7 +52,7 @@ namespace KBEngine
 		return;
 	}
 
-	void Message::HandleMessage(MemoryStream *msgstream, MessagesHandler* handler) const
+	void Message::HandleMessage(MemoryStreamView *msgstream, MessagesHandler* handler) const
 	{
 		KBE_ASSERT(handler);
 		KBE_ASSERT(handler_.Len() > 0);
@@ -61,24 +61,26 @@ namespace KBEngine
 		{
 			if (argsType_ < 0)
 			{
-				handler->HandleMessage(handler_, msgstream);
+				handler->HandleMessage(*this, msgstream);
 			}
 			else
 			{
-				MemoryStream stream;
-				handler->HandleMessage(handler_, &stream);
+				MemoryStreamView stream;
+				handler->HandleMessage(*this, &stream);
 			}
 		}
 		else
 		{
 			TArray<FVariant> params;
 			CreateFromStream(msgstream, params);
-			handler->HandleMessage(handler_, params);
+			handler->HandleMessage(*this, params);
 		}
 	}
 
 
 	// for Messages ------------------------------------------------------------------------------------
+	uint32 Messages::generation_ = 1;
+
 	Messages::Messages()
 	{
 		BindFixedMessage();
@@ -87,77 +89,118 @@ namespace KBEngine
 	Messages::~Messages()
 	{
 		KBE_DEBUG(TEXT("Messages::~Messages()"));
+
+		generation_++;
+
+		for (auto msg : retiredMessages_)
+			delete msg;
+
+		for (auto msg : ownedMessages_)
+			delete msg;
 	}
 
 	void Messages::Reset()
 	{
+		generation_++;
+
 		messages_.Empty();
 		loginappMessages_.Empty();
 		baseappMessages_.Empty();
 		clientMessages_.Empty();
 
+		for (auto msg : retiredMessages_)
+			delete msg;
+
+		retiredMessages_ = MoveTemp(ownedMessages_);
+		ownedMessages_.Reset();
+
+		for (auto handler : handlers_)
+			handler->UnbindMessages();
+
 		BindFixedMessage();
 	}
 
 	void Messages::BindFixedMessage()
 	{
-		// Э˵μ: http://www.kbengine.org/cn/docs/programming/clientsdkprogramming.html
-		messages_.Add("Loginapp_importClientMessages", Message(5, "importClientMessages", 0, 0, TArray<uint8>(), ""));
-		messages_.Add("Loginapp_hello", Message(4, "hello", -1, -1, TArray<uint8>(), ""));
-
-		messages_.Add("Baseapp_importClientMessages", Message(207, "importClientMessages", 0, 0, TArray<uint8>(), ""));
-		messages_.Add("Baseapp_importClientEntityDef", Message(208, "importClientMessages", 0, 0, TArray<uint8>(), ""));
-		messages_.Add("Baseapp_hello", Message(200, "hello", -1, -1, TArray<uint8>(), ""));
+		// 引擎协议说明参见: http://www.kbengine.org/cn/docs/programming/clientsdkprogramming.html
+		AddMessage(TEXT("Loginapp_importClientMessages"), new Message(5, "importClientMessages", 0, 0, TArray<uint8>(), ""));
+		AddMessage(TEXT("Loginapp_hello"), new Message(4, "hello", -1, -1, TArray<uint8>(), ""));
+
+		AddMessage(TEXT("Baseapp_importClientMessages"), new Message(207, "importClientMessages", 0, 0, TArray<uint8>(), ""));
+		AddMessage(TEXT("Baseapp_importClientEntityDef"), new Message(208, "importClientMessages", 0, 0, TArray<uint8>(), ""));
+		AddMessage(TEXT("Baseapp_hello"), new Message(200, "hello", -1, -1, TArray<uint8>(), ""));
+
+		AddClientMessage(new Message(521, "Client_onHelloCB", -1, -1, TArray<uint8>(), "Client_onHelloCB"));
+		AddClientMessage(new Message(522, "Client_onScriptVersionNotMatch", -1, -1, TArray<uint8>(), "Client_onScriptVersionNotMatch"));
+		AddClientMessage(new Message(523, "Client_onVersionNotMatch", -1, -1, TArray<uint8>(), "Client_onVersionNotMatch"));
+		AddClientMessage(new Message(518, "Client_onImportClientMessages", -1, -1, TArray<uint8>(), "Client_onImportClientMessages"));
+	}
 
-		messages_.Add("Client_onHelloCB", Message(521, "Client_onHelloCB", -1, -1, TArray<uint8>(), "Client_onHelloCB"));
-		clientMessages_.Add(messages_["Client_onHelloCB"].ID(), messages_["Client_onHelloCB"]);
 
-		messages_.Add("Client_onScriptVersionNotMatch", Message(522, "Client_onScriptVersionNotMatch", -1, -1, TArray<uint8>(), "Client_onScriptVersionNotMatch"));
-		clientMessages_.Add(messages_["Client_onScriptVersionNotMatch"].ID(), messages_["Client_onScriptVersionNotMatch"]);
+	const Message* Messages::GetMessage(const FString& name)
+	{
+		const Message* const* msg = messages_.Find(name);
+		return msg ? *msg : nullptr;
+	}
 
-		messages_.Add("Client_onVersionNotMatch", Message(523, "Client_onVersionNotMatch", -1, -1, TArray<uint8>(), "Client_onVersionNotMatch"));
-		clientMessages_.Add(messages_["Client_onVersionNotMatch"].ID(), messages_["Client_onVersionNotMatch"]);
+	void Messages::AddMessage(const FString& name, Message* msg)
+	{
+		generation_++;
+		ownedMessages_.Add(msg);
 
-		messages_.Add("Client_onImportClientMessages", Message(518, "Client_onImportClientMessages", -1, -1, TArray<uint8>(), "Client_onImportClientMessages"));
-		clientMessages_.Add(messages_["Client_onImportClientMessages"].ID(), messages_["Client_onImportClientMessages"]);
+		if (name.Len() > 0)
+			messages_.Add(name, msg);
 	}
 
-
-	const Message* Messages::GetMessage(FString name)
+	void Messages::AddClientMessage(Message* msg)
 	{
-		return messages_.Find(name);
+		AddMessage(msg->name_, msg);
+
+		if (clientMessages_.Num() <= msg->id_)
+			clientMessages_.SetNumZeroed(msg->id_ + 1);
+
+		clientMessages_[msg->id_] = msg;
+
+		for (auto handler : handlers_)
+			handler->BindMessage(*msg);
 	}
 
-	const Message* Messages::GetClientMessage(MessageID id)
+	void Messages::AddLoginappMessage(Message* msg)
 	{
-		return clientMessages_.Find(id);
+		AddMessage(msg->name_, msg);
+		loginappMessages_.Add(msg->id_, msg);
 	}
 
-	void Messages::AddClientMessage(const Message& msg)
+	void Messages::AddBaseappMessage(Message* msg)
 	{
-		if (msg.name_.Len() > 0)
-			messages_.Add(msg.name_, msg);
-		clientMessages_.Add(msg.id_, msg);
+		AddMessage(msg->name_, msg);
+		baseappMessages_.Add(msg->id_, msg);
 	}
 
-	void Messages::AddLoginappMessage(const Message& msg)
+	void Messages::RegisterHandler(MessagesHandler* handler)
 	{
-		if (msg.name_.Len() > 0)
-			messages_.Add(msg.name_, msg);
-		loginappMessages_.Add(msg.id_, msg);
+		KBE_ASSERT(handler);
+		if (handlers_.Contains(handler))
+			return;
+
+		handlers_.Add(handler);
+
+		for (auto msg : clientMessages_)
+		{
+			if (msg)
+				handler->BindMessage(*msg);
+		}
 	}
 
-	void Messages::AddBaseappMessage(const Message& msg)
+	void Messages::UnregisterHandler(MessagesHandler* handler)
 	{
-		if (msg.name_.Len() > 0)
-			messages_.Add(msg.name_, msg);
-		baseappMessages_.Add(msg.id_, msg);
+		handlers_.Remove(handler);
 	}
 
-	bool Messages::ImportMessagesFromStream(MemoryStream& stream, SERVER_APP_TYPE fromApp)
+	bool Messages::ImportMessagesFromStream(MemoryStreamView& stream, SERVER_APP_TYPE fromApp)
 	{
-		// @TODO(penghuawei): ﵱǰûжЧԽн飬
-		// ԱҷǷͽпܵ¿ͻ˳δ֪
+		// @TODO(penghuawei): 这里当前没有对数据流的有效性进行较验，
+		// 所以如果数据流来自本地且非法，就将有可能导致客户端出现未知的问题
 
 
 		uint16 msgcount = stream.ReadUint16();
@@ -202,7 +245,7 @@ namespace KBEngine
 			//	}
 			//}
 
-			Message msg(msgid, msgname, msglen, argstype, argstypes, msgname);
+			Message* msg = new Message(msgid, msgname, msglen, argstype, argstypes, msgname);
 
 			if (isClientMethod)
 			{
@@ -4,227 +4,138 @@
 
 namespace KBEngine
 {
-	MessageReader::MessageReader(MessagesHandler* handler, Messages *messages, uint32 bufferLength) :
+	MessageReader::MessageReader(MessagesHandler* handler, Messages *messages) :
 		messagesHandler_(handler),
-		messages_(messages),
-		bufferLength_(bufferLength)
+		messages_(messages)
 	{
 		KBE_ASSERT(messages_);
 		KBE_ASSERT(messagesHandler_);
-		buffer_ = new uint8[bufferLength];
 	}
 
 
 	MessageReader::~MessageReader()
 	{
 		KBE_DEBUG(TEXT("MessageReader::~MessageReader()"));
-		if (buffer_)
-		{
-			delete buffer_;
-			buffer_ = nullptr;
-		}
 	}
 
 	void MessageReader::Reset()
 	{
 		stream.Clear();
-		rpos_ = 0;
-		wpos_ = 0;
+		msgid = 0;
+		msg_ = nullptr;
+		msglen = 0;
+		expectSize = 2;
+		state = READ_STATE::READ_STATE_MSGID;
+		stopped_ = false;
 	}
 
-	uint32 MessageReader::FreeSpace()
-	{
-		auto t_rpos = rpos_ % bufferLength_;
-		auto t_wpos = wpos_ % bufferLength_;
-		uint32 space = 0;
-
-		if (t_wpos >= t_rpos)
-			space = bufferLength_ - t_wpos;
-		else
-			// 1Ϊѭʱдλòȡλһ
-			space = t_rpos - t_wpos - 1;
-		return space;
-	}
-
-	uint32 MessageReader::Write(const uint8* datas, MessageLengthEx length)
+	void MessageReader::Process_(const uint8* datas, MessageLengthEx length)
 	{
-		KBE_ASSERT(length > 0);
-		auto t_length = length;
+		MessageLengthEx totallen = 0;
 
-		while (true)
+		while (length > 0 && expectSize > 0 && !stopped_)
 		{
-			auto space = FreeSpace();
-			if (space == 0)
-				break;
-
-			if (space >= t_length)
+			// 数据不足，暂存起来等待下一段数据
+			if (length < expectSize)
 			{
-				memcpy(&buffer_[wpos_], &datas[length - t_length], t_length);
-				wpos_ = (wpos_ + t_length) % bufferLength_;
-				t_length = 0;
+				stream.Append(&(datas[totallen]), length);
+				expectSize -= length;
 				break;
 			}
-			else
-			{
-				memcpy(&buffer_[wpos_], &datas[length - t_length], space);
-				wpos_ = (wpos_ + space) % bufferLength_;
-				t_length -= space;
-			}
-		}
-		if (length - t_length == 0)
-			KBE_ERROR(TEXT("MessageReader::Write: no space to write! rpos(%u), wpos(%u), message length(%u)"), rpos_, wpos_, length);
-		return length - t_length;
-	}
 
-	void MessageReader::Process()
-	{
-		KBE_ASSERT(rpos_ <= bufferLength_ && wpos_ <= bufferLength_);
-		while (true)
-		{
-			auto t_rpos = rpos_ % bufferLength_;
-			auto t_wpos = wpos_ % bufferLength_;
-
-			if (t_rpos == t_wpos)
-				return;
-
-			uint32 length = 0;
+			// 当前期望的内容完整地落在本段数据中，并且之前没有暂存的残余数据时，
+			// 直接在本段数据上读取，否则补齐暂存区后从暂存区读取
+			const uint8* field = &(datas[totallen]);
+			MessageLengthEx fieldLength = expectSize;
+			bool staged = stream.WPos() > 0;
 
-			if (t_wpos > t_rpos)
-				length = t_wpos - t_rpos;
-			else
-				length = bufferLength_ - t_rpos;
-
-			Process_(&buffer_[t_rpos], length);
-			rpos_ = (rpos_ + length) % bufferLength_;
-		}
-	}
+			if (staged)
+			{
+				stream.Append(field, expectSize);
+				field = stream.Data();
+				fieldLength = (MessageLengthEx)stream.WPos();
+			}
 
-	void MessageReader::Process_(const uint8* datas, MessageLengthEx length)
-	{
-		MessageLengthEx totallen = 0;
+			totallen += expectSize;
+			length -= expectSize;
 
-		while (length > 0 && expectSize > 0)
-		{
 			if (state == READ_STATE::READ_STATE_MSGID)
 			{
-				if (length >= expectSize)
+				memcpy(&msgid, field, sizeof(MessageID));
+				stream.Clear();
+
+				// 消息描述在消息头中取得一次，读取消息体时直接使用
+				const Message* msg = msg_ = messages_->GetClientMessage(msgid);
+				if (!msg)
 				{
-					stream.Append(&(datas[totallen]), expectSize);
-					totallen += expectSize;
-					length -= expectSize;
-					msgid = stream.ReadUint16();
-					stream.Clear();
-
-					auto* msg = messages_->GetClientMessage(msgid);
-					if (!msg)
-					{
-						KBE_ERROR(TEXT("MessageReader::Process_: unknown message(%d)!"), msgid);
-						KBE_ASSERT(msg);
-					}
-
-					if (msg->MsgLen() == -1)
-					{
-						state = READ_STATE::READ_STATE_MSGLEN;
-						expectSize = 2;
-					}
-					else if (msg->MsgLen() == 0)
-					{
-						// 0ϢôûкݿɶˣϢֱһϢ
-						msg->HandleMessage(&stream, messagesHandler_);
-						state = READ_STATE::READ_STATE_MSGID;
-						expectSize = 2;
-					}
-					else
-					{
-						expectSize = msg->MsgLen();
-						state = READ_STATE::READ_STATE_BODY;
-					}
+					KBE_ERROR(TEXT("MessageReader::Process_: unknown message(%d)!"), msgid);
+					KBE_ASSERT(msg);
+				}
+
+				if (msg->MsgLen() == -1)
+				{
+					state = READ_STATE::READ_STATE_MSGLEN;
+					expectSize = 2;
+				}
+				else if (msg->MsgLen() == 0)
+				{
+					// 如果是0个参数的消息，那么没有后续内容可读了，处理本条消息并且直接跳到下一条消息
+					MemoryStreamView emptyView;
+					msg_ = nullptr;
+					msg->HandleMessage(&emptyView, messagesHandler_);
+					state = READ_STATE::READ_STATE_MSGID;
+					expectSize = 2;
 				}
 				else
 				{
-					stream.Append(&(datas[totallen]), length);
-					expectSize -= length;
-					break;
+					expectSize = msg->MsgLen();
+					state = READ_STATE::READ_STATE_BODY;
 				}
 			}
 			else if (state == READ_STATE::READ_STATE_MSGLEN)
 			{
-				if (length >= expectSize)
+				memcpy(&msglen, field, sizeof(MessageLength));
+				stream.Clear();
+
+				// 长度扩展
+				if (msglen >= 65535)
 				{
-					stream.Append(&(datas[totallen]), expectSize);
-					totallen += expectSize;
-					length -= expectSize;
-
-					msglen = stream.ReadUint16();
-					stream.Clear();
-
-					// չ
-					if (msglen >= 65535)
-					{
-						state = READ_STATE::READ_STATE_MSGLEN_EX;
-						expectSize = 4;
-					}
-					else
-					{
-						state = READ_STATE::READ_STATE_BODY;
-						expectSize = msglen;
-					}
+					state = READ_STATE::READ_STATE_MSGLEN_EX;
+					expectSize = 4;
 				}
 				else
 				{
-					stream.Append(&(datas[totallen]), length);
-					expectSize -= length;
-					break;
+					state = READ_STATE::READ_STATE_BODY;
+					expectSize = msglen;
 				}
 			}
 			else if (state == READ_STATE::READ_STATE_MSGLEN_EX)
 			{
-				if (length >= expectSize)
-				{
-					stream.Append(&(datas[totallen]), expectSize);
-					totallen += expectSize;
-					length -= expectSize;
+				memcpy(&expectSize, field, sizeof(MessageLengthEx));
+				stream.Clear();
 
-					expectSize = stream.ReadUint32();
-					stream.Clear();
-
-					state = READ_STATE::READ_STATE_BODY;
-				}
-				else
-				{
-					stream.Append(&(datas[totallen]), length);
-					expectSize -= length;
-					break;
-				}
+				state = READ_STATE::READ_STATE_BODY;
 			}
 			else if (state == READ_STATE::READ_STATE_BODY)
 			{
-				if (length >= expectSize)
+				const Message* msg = msg_;
+				msg_ = nullptr;
+				KBE_ASSERT(msg);
+
+				if (staged)
 				{
-					stream.Append(&(datas[totallen]), expectSize);
-					totallen += expectSize;
-					length -= expectSize;
-
-					auto* msg = messages_->GetClientMessage(msgid);
-					if (!msg)
-					{
-						KBE_ERROR(TEXT("MessageReader::Process_: unknown message(%d)!"), msgid);
-						KBE_ASSERT(msg);
-					}
-					
 					msg->HandleMessage(&stream, messagesHandler_);
-
-					stream.Clear();
-
-					state = READ_STATE::READ_STATE_MSGID;
-					expectSize = 2;
 				}
 				else
 				{
-					stream.Append(&(datas[totallen]), length);
-					expectSize -= length;
-					break;
+					MemoryStreamView bodyView(field, fieldLength);
+					msg->HandleMessage(&bodyView, messagesHandler_);
 				}
+
+				stream.Clear();
+
+				state = READ_STATE::READ_STATE_MSGID;
+				expectSize = 2;
 			}
 		}
 	}
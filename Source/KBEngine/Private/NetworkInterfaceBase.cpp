@@ -37,11 +37,11 @@ namespace KBEngine
 		if (packetReceiver_)
 			packetReceiver_->WillClose();
 
-		// networkStatus_ٹرsocket_Ա֤߳µsocketҰָ
+		// 必须先销毁networkStatus_再关闭socket_，以保证多线程下的socket不会出现野指针
 		SAFE_DELETE(networkStatus_);
 
-		// socketȹرգPacketReceiver޷ֹ
-		// Ӷֿ
+		// 不把socket先关闭，后面PacketReceiver的阻塞将无法终止
+		// 从而出现卡机现象
 		if (socket_)
 			socket_->Close();
 
@@ -49,7 +49,7 @@ namespace KBEngine
 		SAFE_DELETE(packetReceiver_);
 		willClose_ = false;
 
-		// ҪΪУPacketSenderPacketReceiverܻ첽ʹЩ
+		// 这个要放最后，因为在这过程中，PacketSender和PacketReceiver可能还在异步使用这些变量
 		if (socket_)
 		{
 			socketSubsystem_->DestroySocket(socket_);
@@ -149,6 +149,38 @@ namespace KBEngine
 		return packetSender_->Send(datas, length);
 	}
 
+	bool NetworkInterfaceBase::SendV(const SendSpanArray& spans)
+	{
+		if (!Valid())
+		{
+			KBE_ERROR(TEXT("NetworkInterface::SendV: invalid socket!"));
+		}
+
+		if (!packetSender_)
+		{
+			InitPacketSender();
+		}
+
+		return packetSender_->SendV(spans);
+	}
+
+	void NetworkInterfaceBase::Destroy(NetworkInterfaceBase* networkInterface)
+	{
+		if (!networkInterface)
+			return;
+
+		if (networkInterface->processing_)
+		{
+			networkInterface->destroyPending_ = true;
+			networkInterface->messageReader_->Stop();
+			return;
+		}
+
+		networkInterface->Close();
+		networkInterface->messageReader_->Reset();
+		delete networkInterface;
+	}
+
 	void NetworkInterfaceBase::Process()
 	{
 		if (willClose_)
@@ -157,8 +189,20 @@ namespace KBEngine
 			return;
 		}
 
-		if (networkStatus_)
-			networkStatus_->MainThreadProcess(this);
+		if (!networkStatus_)
+			return;
+
+		processing_ = true;
+		networkStatus_->MainThreadProcess(this);
+		processing_ = false;
+
+		// 消息处理函数中要求销毁，此时调用栈上已经没有再使用本对象的代码
+		if (destroyPending_)
+		{
+			Close();
+			messageReader_->Reset();
+			delete this;
+		}
 	}
 
 	void NetworkInterfaceBase::ProcessMessage()
@@ -181,8 +225,8 @@ namespace KBEngine
 		TSharedPtr<FInternetAddr> remoteAddr = socketSubsystem->CreateInternetAddr();
 		FString outIP = ipAddress;
 		bool bIsValid = false;
-		remoteAddr->SetIp(*outIP, bIsValid);	// ֤Ƿipַ
-		if (!bIsValid)							// ipַΪ
+		remoteAddr->SetIp(*outIP, bIsValid);	// 验证是否ip地址
+		if (!bIsValid)							// 不是ip地址，作为域名解析
 		{
 			ESocketErrors hostResolveError = socketSubsystem->GetHostByName(TCHAR_TO_ANSI(*ipAddress), *remoteAddr);
 			if (hostResolveError == SE_NO_ERROR || hostResolveError == SE_EWOULDBLOCK)
@@ -22,7 +22,7 @@ void NetworkInterfaceKCP::Process()
 {
 	if (kcp_)
 	{
-		uint64 secs64 = FPlatformTime::Seconds() * 1000;	// Ϊ룬
+		uint64 secs64 = FPlatformTime::Seconds() * 1000;	// 变为毫秒，避免溢出
 		uint32 current = secs64 & 0xfffffffful;
 
 		if (current >= nextTickKcpUpdate_) 
@@ -9,7 +9,7 @@ namespace KBEngine
 
 PacketReceiverBase* NetworkInterfaceTCP::CreatePacketReceiver()
 {
-	return new PacketReceiverTCP(this, KBEngineApp::app->GetTcpRecvBufferMax());
+	return new PacketReceiverTCP(this, KBEngineApp::app->GetTcpRecvBufferMax(), KBEngineApp::app->GetTcpRecvBufferLimit());
 }
 
 void NetworkInterfaceTCP::InitPacketSender()
@@ -0,0 +1,173 @@
+#include "PackedFloat.h"
+#include "KBEnginePrivatePCH.h"
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define KBE_PACKED_FLOAT_NEON 1
+#include <arm_neon.h>
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define KBE_PACKED_FLOAT_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace KBEngine
+{
+	// 每次向量处理的数量
+	static const int32 PACKED_FLOAT_LANES = 4;
+
+	void PackedFloat::DecodeXZ(const uint8* src, int32 count, float* outX, float* outZ)
+	{
+		int32 i = 0;
+
+#if KBE_PACKED_FLOAT_SSE2 || KBE_PACKED_FLOAT_NEON
+		// 3字节的值无法直接装入向量，先逐个拼成32位，其余的位运算与浮点减法用向量完成
+		for (; i + PACKED_FLOAT_LANES <= count; i += PACKED_FLOAT_LANES)
+		{
+			alignas(16) uint32 datas[PACKED_FLOAT_LANES];
+			for (int32 n = 0; n < PACKED_FLOAT_LANES; ++n)
+				datas[n] = LoadXZ(src + (i + n) * 3);
+
+#if KBE_PACKED_FLOAT_SSE2
+			const __m128i base = _mm_set1_epi32(0x40000000);
+			const __m128 two = _mm_set1_ps(2.0f);
+
+			__m128i data = _mm_load_si128((const __m128i*)datas);
+
+			__m128i xbits = _mm_or_si128(base, _mm_slli_epi32(_mm_and_si128(data, _mm_set1_epi32(0x7ff000)), 3));
+			__m128i zbits = _mm_or_si128(base, _mm_slli_epi32(_mm_and_si128(data, _mm_set1_epi32(0x0007ff)), 15));
+
+			__m128 x = _mm_sub_ps(_mm_castsi128_ps(xbits), two);
+			__m128 z = _mm_sub_ps(_mm_castsi128_ps(zbits), two);
+
+			x = _mm_or_ps(x, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(data, _mm_set1_epi32(0x800000)), 8)));
+			z = _mm_or_ps(z, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(data, _mm_set1_epi32(0x000800)), 20)));
+
+			_mm_storeu_ps(outX + i, x);
+			_mm_storeu_ps(outZ + i, z);
+#else
+			const uint32x4_t base = vdupq_n_u32(0x40000000);
+			const float32x4_t two = vdupq_n_f32(2.0f);
+
+			uint32x4_t data = vld1q_u32(datas);
+
+			uint32x4_t xbits = vorrq_u32(base, vshlq_n_u32(vandq_u32(data, vdupq_n_u32(0x7ff000)), 3));
+			uint32x4_t zbits = vorrq_u32(base, vshlq_n_u32(vandq_u32(data, vdupq_n_u32(0x0007ff)), 15));
+
+			uint32x4_t x = vreinterpretq_u32_f32(vsubq_f32(vreinterpretq_f32_u32(xbits), two));
+			uint32x4_t z = vreinterpretq_u32_f32(vsubq_f32(vreinterpretq_f32_u32(zbits), two));
+
+			x = vorrq_u32(x, vshlq_n_u32(vandq_u32(data, vdupq_n_u32(0x800000)), 8));
+			z = vorrq_u32(z, vshlq_n_u32(vandq_u32(data, vdupq_n_u32(0x000800)), 20));
+
+			vst1q_f32(outX + i, vreinterpretq_f32_u32(x));
+			vst1q_f32(outZ + i, vreinterpretq_f32_u32(z));
+#endif
+		}
+#endif
+
+		for (; i < count; ++i)
+			DecodeXZ(LoadXZ(src + i * 3), outX[i], outZ[i]);
+	}
+
+	void PackedFloat::DecodeY(const uint8* src, int32 count, float* outY)
+	{
+		int32 i = 0;
+
+#if KBE_PACKED_FLOAT_SSE2
+		const __m128i base = _mm_set1_epi32(0x40000000);
+		const __m128i zero = _mm_setzero_si128();
+		const __m128 two = _mm_set1_ps(2.0f);
+
+		// 一次装入8个16位的值，展开成两组32位分别计算
+		for (; i + PACKED_FLOAT_LANES * 2 <= count; i += PACKED_FLOAT_LANES * 2)
+		{
+			__m128i packed = _mm_loadu_si128((const __m128i*)(src + i * 2));
+			__m128i halves[2] = { _mm_unpacklo_epi16(packed, zero), _mm_unpackhi_epi16(packed, zero) };
+
+			for (int32 n = 0; n < 2; ++n)
+			{
+				__m128i data = halves[n];
+				__m128i ybits = _mm_or_si128(base, _mm_slli_epi32(_mm_and_si128(data, _mm_set1_epi32(0x7fff)), 12));
+				__m128 y = _mm_sub_ps(_mm_castsi128_ps(ybits), two);
+				y = _mm_or_ps(y, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(data, _mm_set1_epi32(0x8000)), 16)));
+				_mm_storeu_ps(outY + i + n * PACKED_FLOAT_LANES, y);
+			}
+		}
+#elif KBE_PACKED_FLOAT_NEON
+		const uint32x4_t base = vdupq_n_u32(0x40000000);
+		const float32x4_t two = vdupq_n_f32(2.0f);
+
+		for (; i + PACKED_FLOAT_LANES * 2 <= count; i += PACKED_FLOAT_LANES * 2)
+		{
+			uint16x8_t packed = vld1q_u16((const uint16*)(src + i * 2));
+			uint32x4_t halves[2] = { vmovl_u16(vget_low_u16(packed)), vmovl_u16(vget_high_u16(packed)) };
+
+			for (int32 n = 0; n < 2; ++n)
+			{
+				uint32x4_t data = halves[n];
+				uint32x4_t ybits = vorrq_u32(base, vshlq_n_u32(vandq_u32(data, vdupq_n_u32(0x7fff)), 12));
+				uint32x4_t y = vreinterpretq_u32_f32(vsubq_f32(vreinterpretq_f32_u32(ybits), two));
+				y = vorrq_u32(y, vshlq_n_u32(vandq_u32(data, vdupq_n_u32(0x8000)), 16));
+				vst1q_f32(outY + i + n * PACKED_FLOAT_LANES, vreinterpretq_f32_u32(y));
+			}
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			uint16 data;
+			FMemory::Memcpy(&data, src + i * 2, sizeof(data));
+			outY[i] = DecodeY(data);
+		}
+	}
+
+	void PackedFloat::DecodeXYZ(const uint8* src, int32 count, float* outX, float* outY, float* outZ, float minf)
+	{
+		int32 i = 0;
+
+#if KBE_PACKED_FLOAT_SSE2
+		const __m128i mask = _mm_set1_epi32(0x7FF);
+		const __m128 quarter = _mm_set1_ps(0.25f);
+		const __m128 minxz = _mm_set1_ps(minf);
+		const __m128 miny = _mm_set1_ps(minf / 2.f);
+
+		for (; i + PACKED_FLOAT_LANES <= count; i += PACKED_FLOAT_LANES)
+		{
+			__m128i packed = _mm_loadu_si128((const __m128i*)(src + i * 4));
+
+			// 各分量都不超过11位，转换为浮点数与乘以0.25都是精确的，结果与逐个计算相同
+			__m128 x = _mm_cvtepi32_ps(_mm_and_si128(packed, mask));
+			__m128 z = _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(packed, 11), mask));
+			__m128 y = _mm_cvtepi32_ps(_mm_srli_epi32(packed, 22));
+
+			_mm_storeu_ps(outX + i, _mm_add_ps(_mm_mul_ps(x, quarter), minxz));
+			_mm_storeu_ps(outY + i, _mm_add_ps(_mm_mul_ps(y, quarter), miny));
+			_mm_storeu_ps(outZ + i, _mm_add_ps(_mm_mul_ps(z, quarter), minxz));
+		}
+#elif KBE_PACKED_FLOAT_NEON
+		const uint32x4_t mask = vdupq_n_u32(0x7FF);
+		const float32x4_t quarter = vdupq_n_f32(0.25f);
+		const float32x4_t minxz = vdupq_n_f32(minf);
+		const float32x4_t miny = vdupq_n_f32(minf / 2.f);
+
+		for (; i + PACKED_FLOAT_LANES <= count; i += PACKED_FLOAT_LANES)
+		{
+			uint32x4_t packed = vld1q_u32((const uint32*)(src + i * 4));
+
+			float32x4_t x = vcvtq_f32_u32(vandq_u32(packed, mask));
+			float32x4_t z = vcvtq_f32_u32(vandq_u32(vshrq_n_u32(packed, 11), mask));
+			float32x4_t y = vcvtq_f32_u32(vshrq_n_u32(packed, 22));
+
+			vst1q_f32(outX + i, vaddq_f32(vmulq_f32(x, quarter), minxz));
+			vst1q_f32(outY + i, vaddq_f32(vmulq_f32(y, quarter), miny));
+			vst1q_f32(outZ + i, vaddq_f32(vmulq_f32(z, quarter), minxz));
+		}
+#endif
+
+		for (; i < count; ++i)
+		{
+			uint32 packed;
+			FMemory::Memcpy(&packed, src + i * 4, sizeof(packed));
+			DecodeXYZ(packed, outX[i], outY[i], outZ[i], minf);
+		}
+	}
+}
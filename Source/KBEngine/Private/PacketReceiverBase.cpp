@@ -3,16 +3,19 @@
 #include "Core.h"
 #include "NetworkInterfaceBase.h"
 #include "MessageReader.h"
+#include "HAL/PlatformProcess.h"	// GetSynchEventFromPool
+#include "HAL/Event.h"
 #include "Windows/AllowWindowsPlatformTypes.h"
 #include "Windows/HideWindowsPlatformTypes.h"
 
 namespace KBEngine
 {
-	PacketReceiverBase::PacketReceiverBase(NetworkInterfaceBase* networkInterface, uint32 buffLength)
+	PacketReceiverBase::PacketReceiverBase(NetworkInterfaceBase* networkInterface, uint32 buffLength, uint32 buffLimit)
+		: networkInterface_(networkInterface),
+		buffer_(buffLength, buffLimit)
 	{
-		networkInterface_ = networkInterface;
-		buffer_ = new uint8[buffLength];
-		bufferLength_ = buffLength;
+		stats_.capacity = stats_.peakCapacity = buffer_.InitCapacity();
+		spaceEvent_ = FPlatformProcess::GetSynchEventFromPool(false);
 	}
 
 	PacketReceiverBase::~PacketReceiverBase()
@@ -20,55 +23,116 @@ namespace KBEngine
 		KBE_DEBUG(TEXT("PacketReceiverBase::~PacketReceiverBase()"));
 		StopBackgroundRecv();
 
-		if (buffer_)
-			delete buffer_;
+		FPlatformProcess::ReturnSynchEventToPool(spaceEvent_);
+		spaceEvent_ = nullptr;
 	}
 
 	void PacketReceiverBase::Process(MessageReader& messageReader)
 	{
-		// @TODO(penghuawei): Ҫֱ߳̾Ͱд뵽MessageReaderУԽʡһڴ渴Ƶ
+		// 直接在环形缓冲区上解析消息，完整落在缓冲区中的消息不会产生任何复制，
+		// 只有跨越缓冲区末尾的消息才会被MessageReader暂存拼接。
+		// 注意：必须在解析完成后才能CommitRead，否则子线程可能覆盖正在被读取的数据
+		// 数据回环时分为尾部与头部两段，缓冲区扩容过时还会跨越多个环
+		// 限制每次处理的段数，避免子线程持续写入时主线程一直停留在这里
+		for (int i = 0; i < 8; ++i)
+		{
+			uint8* datas = nullptr;
+			uint32 length = buffer_.GetReadSpan(datas);
+			if (length == 0)
+				break;
 
-		uint32 t_wpos = wpos_;
-		uint32 r = 0;
+			messageReader.ProcessData(datas, length);
+			buffer_.CommitRead(length);
 
-		if (rpos_ < t_wpos)
-		{
-			messageReader.Write(&buffer_[rpos_], t_wpos - rpos_);
-			rpos_ = t_wpos;
-		}
-		else if (t_wpos < rpos_)
-		{
-			messageReader.Write(&buffer_[rpos_], bufferLength_ - rpos_);
-			if (t_wpos > 0)
-				messageReader.Write(&buffer_[0], t_wpos);
-			rpos_ = t_wpos;
-		}
-		else
-		{
-			// ûпɶ
+			if (waitingForSpace_.load())
+				spaceEvent_->Trigger();
+
+			// 消息处理函数要求断开网络，剩下的数据不再处理
+			if (networkInterface_->DestroyPending())
+				break;
 		}
 	}
 
-	uint32 PacketReceiverBase::FreeWriteSpace()
+	uint32 PacketReceiverBase::AcquireWriteSpan(uint8*& datas)
 	{
-		uint32 t_rpos = rpos_;
+		// 突发过去、缓冲区已经被读空并且一段时间没有扩容，换回初始大小的缓冲区
+		if (buffer_.Capacity() > buffer_.InitCapacity() && FPlatformTime::Seconds() - lastGrowTime_ >= RECV_BUFFER_SHRINK_IDLE)
+		{
+			if (buffer_.Shrink())
+			{
+				FScopeLock lock(&statsLock_);
+				stats_.shrinkCount += 1;
+				stats_.capacity = buffer_.Capacity();
 
-		if (wpos_ == bufferLength_)
+				KBE_DEBUG(TEXT("PacketReceiverBase::AcquireWriteSpan(): shrink buffer to %u"), stats_.capacity);
+			}
+		}
+
+		uint32 oldCapacity = buffer_.Capacity();
+		uint32 space = buffer_.GetWriteSpan(datas);
+
+		if (space > 0)
 		{
-			if (t_rpos == 0)
+			uint32 capacity = buffer_.Capacity();
+			if (capacity != oldCapacity)
 			{
-				return 0;
+				lastGrowTime_ = FPlatformTime::Seconds();
+
+				FScopeLock lock(&statsLock_);
+				stats_.growCount += 1;
+				stats_.capacity = capacity;
+				stats_.peakCapacity = FMath::Max(stats_.peakCapacity, capacity);
+
+				KBE_DEBUG(TEXT("PacketReceiverBase::AcquireWriteSpan(): grow buffer %u -> %u"), oldCapacity, capacity);
 			}
 
-			wpos_ = 0;
+			return space;
 		}
 
-		if (t_rpos <= wpos_)
+		// 已经达到容量上限，不再断开连接，而是等待主线程处理掉一部分数据
+		double startTime = FPlatformTime::Seconds();
+
+		KBE_WARNING(TEXT("PacketReceiverBase::AcquireWriteSpan(): buffer is full(%u), waiting for main thread!"), buffer_.Capacity());
+
+		// 先声明正在等待再检查空间，主线程在这之后腾出的空间一定会触发事件；
+		// 等待设有超时，即使错过了唤醒也只是多等一会
+		waitingForSpace_.store(true);
+
+		while (!breakThread_)
+		{
+			space = buffer_.GetWriteSpan(datas);
+			if (space > 0)
+				break;
+
+			spaceEvent_->Wait(RECV_BUFFER_FULL_WAIT);
+		}
+
+		waitingForSpace_.store(false);
+
+		FScopeLock lock(&statsLock_);
+		stats_.fullCount += 1;
+		stats_.fullWaitTime += FPlatformTime::Seconds() - startTime;
+		return space;
+	}
+
+	void PacketReceiverBase::CommitWrite(uint32 count)
+	{
+		buffer_.CommitWrite(count);
+
+		uint32 pending = buffer_.Size();
+		if (pending > peakPending_)
 		{
-			return bufferLength_ - wpos_;
+			peakPending_ = pending;
+
+			FScopeLock lock(&statsLock_);
+			stats_.peakPending = pending;
 		}
+	}
 
-		return t_rpos - wpos_ - 1;
+	PacketReceiverStats PacketReceiverBase::GetStats()
+	{
+		FScopeLock lock(&statsLock_);
+		return stats_;
 	}
 
 	void PacketReceiverBase::StartBackgroundRecv()
@@ -82,7 +146,11 @@ namespace KBEngine
 		if (thread_)
 		{
 			breakThread_ = true;
-			// ȴ߳̽
+
+			// 唤醒可能正在等待缓冲区空间的接收线程
+			spaceEvent_->Trigger();
+
+			// 阻塞等待线程结束
 			thread_->WaitForCompletion();
 			delete thread_;
 			thread_ = nullptr;
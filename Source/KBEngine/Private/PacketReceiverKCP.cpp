@@ -14,7 +14,7 @@ PacketReceiverKCP::~PacketReceiverKCP()
 		delete udpBuffer_;
 }
 
-// 룬kcpʹö߳
+// 废弃代码，kcp无需使用多线程
 void PacketReceiverKCP::BackgroundRecv() 
 {
 	if (!networkInterface_ || !networkInterface_->Valid())
@@ -26,7 +26,7 @@ void PacketReceiverKCP::BackgroundRecv()
 	int32 bytesRead = 0;
 	if (!networkInterface_->Socket()->RecvFrom(udpBuffer_, UDP_PACKET_LENTH, bytesRead, *remoteAddr_))
 	{
-		KBE_ERROR(TEXT("PacketReceiverKCP::BackgroundRecv: RecvFrom is not success!wpos_(%d), rpos_(%d)"), wpos_, rpos_);
+		KBE_ERROR(TEXT("PacketReceiverKCP::BackgroundRecv: RecvFrom is not success!size(%u)"), buffer_.Size());
 		return;
 	}
 
@@ -36,7 +36,7 @@ void PacketReceiverKCP::BackgroundRecv()
 	if (result < 0)
 	{
 		KBE_ERROR(TEXT("PacketReceiverKCP::BackgroundRecv ikcp_input error %d"), result);
-		hexlike(buffer_, wpos_, bytesRead);
+		hexlike(udpBuffer_, 0, bytesRead);
 	}
 	else
 	{
@@ -45,37 +45,33 @@ void PacketReceiverKCP::BackgroundRecv()
 			result = ikcp_recv(networkInterfaceKCP->KCP(), (char*)(udpBuffer_), UDP_PACKET_LENTH);
 			if (result < 0)
 			{
-				//KBE_INFO(TEXT("PacketReceiverKCP::BackgroundRecv ikcp_recv result: %d, wpos_: %d, rpos_: %d"), result, wpos_, rpos_);
 				break;
 			}
 			else
 			{
-				//hexlike(buffer_, wpos_, bytesRead);
-				//KBE_DEBUG(TEXT("PacketReceiverKCP::BackgroundRecv ikcp_recv copy bytes %d, space:%d wpos_:%d at time(%s:%d)"),
-				//	result, CheckForSpace(), wpos_, *FDateTime::UtcNow().ToString(), FDateTime::UtcNow().GetMillisecond());
 
-				int startPos = 0;		// ʼֽڵλ
+				int startPos = 0;		// 开始复制字节的位置
 				while (result > 0)
 				{
-					int space = CheckForSpace();
+					uint8* datas = nullptr;
+					int space = CheckForSpace(datas);
 					if (space == 0)
 					{
-						KBE_ERROR(TEXT("PacketReceiverKCP::BackgroundRecv: no space!wpos_(%d), rpos_(%d)"), wpos_, rpos_);
+						KBE_ERROR(TEXT("PacketReceiverKCP::BackgroundRecv: no space!size(%u)"), buffer_.Size());
 						return;
 					}
 
-					int cpyBytes = result;		// Ѿ˶ֽڣһʼֽ
-					if (result > space)			// ռ䲻ֽ
+					int cpyBytes = result;		// 已经复制了多少字节，一开始期望所有字节
+					if (result > space)			// 空间不足容纳所有字节
 					{
-						cpyBytes = space;		// ֽ
+						cpyBytes = space;		// 复制字节数
 					}
 
-					memcpy(&buffer_[wpos_], &udpBuffer_[startPos], cpyBytes);
-					startPos += cpyBytes;		// ѸƵֽ
+					memcpy(datas, &udpBuffer_[startPos], cpyBytes);
+					CommitWrite(cpyBytes);
+					startPos += cpyBytes;		// 已复制的字节
 
-					wpos_ += cpyBytes;		   	// дλ
-
-					result -= cpyBytes;			// ʣֽڣûһѭ
+					result -= cpyBytes;			// 剩余字节，没读完下一循环继续
 				}
 			}
 		}
@@ -103,7 +99,7 @@ void PacketReceiverKCP::Process(MessageReader & messageReader)
 			if (result < 0)
 			{
 				KBE_ERROR(TEXT("PacketReceiverKCP::BackgroundRecv ikcp_input error %d"), result);
-				//hexlike(buffer_, wpos_, bytesRead);
+				//hexlike(udpBuffer_, 0, bytesRead);
 				continue;
 			}
 			else
@@ -113,13 +109,16 @@ void PacketReceiverKCP::Process(MessageReader & messageReader)
 					result = ikcp_recv(networkInterfaceKCP->KCP(), (char*)(udpBuffer_), UDP_PACKET_LENTH);
 					if (result < 0)
 					{
-						//KBE_INFO(TEXT("PacketReceiverKCP::BackgroundRecv ikcp_recv result: %d, wpos_: %d, rpos_: %d"), result, wpos_, rpos_);
 						break;
 					}
 
 					if (result > 0)
 					{
 						messageReader.ProcessData(udpBuffer_, result);
+
+						// 消息处理函数要求断开网络，剩下的数据不再处理
+						if (networkInterface_->DestroyPending())
+							return;
 					}
 				}
 			}
@@ -128,34 +127,10 @@ void PacketReceiverKCP::Process(MessageReader & messageReader)
 	//PacketReceiverBase::Process(messageReader);
 }
 
-uint32 PacketReceiverKCP::CheckForSpace()
+uint32 PacketReceiverKCP::CheckForSpace(uint8*& datas)
 {
-	int space = FreeWriteSpace();
-
-	// пռдֱ߳пռΪֹ
-	int retries = 0;
-	while (space == 0)
-	{
-		retries += 1;
-
-		if (retries > 10)
-		{
-			KBE_ERROR(TEXT("PacketReceiverKCP::CheckForSpace(): no space! disconnect to server!"));
-			breakThread_ = true;
-			if (!willClose_)
-				networkInterface_->WillClose();
-			return 0;
-		}
-
-		KBE_WARNING(TEXT("PacketReceiverKCP::CheckForSpace(): waiting for space, Please adjust 'UDP_RECV_BUFFER_MAX'! retries = %d, wpos_ = %d, rpos_ = %d"),
-			retries, wpos_, rpos_);
-
-		FPlatformProcess::Sleep(0.1);
-
-		space = FreeWriteSpace();
-	}
-
-	return space;
+	// 缓冲区满时会扩容，达到上限时等待主线程处理，只有线程被要求退出时才返回0
+	return AcquireWriteSpan(datas);
 }
 
 
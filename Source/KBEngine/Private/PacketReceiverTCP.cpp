@@ -6,28 +6,11 @@ namespace KBEngine
 
 void PacketReceiverTCP::BackgroundRecv() 
 {
-	// пռдֱ߳пռΪֹ
-	int retries = 0;
-	int space = FreeWriteSpace();
-
-	while (space == 0)
-	{
-		retries += 1;
-
-		if (retries > 10)
-		{
-			KBE_ERROR(TEXT("PacketReceiverTCP::OnBackgroundRecv(): no space! disconnect to server!"));
-			breakThread_ = true;
-			if (!willClose_)
-				networkInterface_->WillClose();
-			return;
-		}
-
-		KBE_WARNING(TEXT("PacketReceiverTCP::OnBackgroundRecv(): waiting for space, Please adjust 'TCP_RECV_BUFFER_MAX'! retries = %d"), retries);
-		FPlatformProcess::Sleep(0.1);
-
-		space = FreeWriteSpace();
-	}
+	// 必须有空间可写，缓冲区满时会扩容，达到上限时等待主线程处理
+	uint8* datas = nullptr;
+	uint32 space = AcquireWriteSpan(datas);
+	if (space == 0)
+		return;
 
 	int32 bytesRead = 0;
 	if (!networkInterface_ || !networkInterface_->Valid())
@@ -36,8 +19,8 @@ void PacketReceiverTCP::BackgroundRecv()
 		return;
 	}
 
-	// wsf:ע⣬UE4 SocketsBSD RecvbytesReadС0û޷õԭ
-	bool recvSuccess = networkInterface_->Socket()->Recv(&(buffer_[wpos_]), space, bytesRead);
+	// wsf:注意，UE4 SocketsBSD Recv限制bytesRead不会小于0，用户无法得到网络错误原因
+	bool recvSuccess = networkInterface_->Socket()->Recv(datas, space, bytesRead);
 	if (!recvSuccess)
 	{
 		KBE_ERROR(TEXT("PacketReceiverTCP::BackgroundRecv: Maybe lose connected from server!"));
@@ -49,8 +32,8 @@ void PacketReceiverTCP::BackgroundRecv()
 
 	if (bytesRead > 0)
 	{
-		// дλ
-		wpos_ += bytesRead;
+		// 发布写入的数据，主线程此后才能读到
+		CommitWrite(bytesRead);
 	}
 }
 
@@ -14,5 +14,16 @@ namespace KBEngine
 	{
 	}
 
+	bool PacketSenderBase::SendV(const SendSpanArray& spans)
+	{
+		for (auto& span : spans)
+		{
+			if (!Send(span.datas, span.length))
+				return false;
+		}
+
+		return true;
+	}
+
 }
 
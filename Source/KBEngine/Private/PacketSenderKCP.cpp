@@ -17,7 +17,30 @@ PacketSenderKCP::~PacketSenderKCP()
 {
 }
 
+uint32 PacketSenderKCP::MaxSendSize() const
+{
+	NetworkInterfaceKCP* networkInterface = (NetworkInterfaceKCP*)networkInterface_;
+	return KCP_MAX_FRAGMENTS * networkInterface->KCP()->mss;
+}
+
 bool PacketSenderKCP::Send(uint8* datas, uint32 length)
+{
+	// kcp传输的是连续的数据流，服务端按消息格式重新拼接，所以可以在任意位置切分
+	uint32 maxSize = MaxSendSize();
+
+	while (length > maxSize)
+	{
+		if (!SendChunk(datas, maxSize))
+			return false;
+
+		datas += maxSize;
+		length -= maxSize;
+	}
+
+	return SendChunk(datas, length);
+}
+
+bool PacketSenderKCP::SendChunk(const uint8* datas, uint32 length)
 {
 	NetworkInterfaceKCP* networkInterface = (NetworkInterfaceKCP*)networkInterface_;
 
@@ -38,4 +61,32 @@ bool PacketSenderKCP::Send(uint8* datas, uint32 length)
 	return true;
 }
 
+bool PacketSenderKCP::SendV(const SendSpanArray& spans)
+{
+	if (spans.Num() == 1)
+		return Send(spans[0].datas, spans[0].length);
+
+	uint32 maxSize = MaxSendSize();
+	gatherBuffer_.Reset();
+
+	for (auto& span : spans)
+	{
+		// 再合并就超过单次发送的上限时，先把已经合并的数据交给kcp
+		if (gatherBuffer_.Num() > 0 && (uint32)gatherBuffer_.Num() + span.length > maxSize)
+		{
+			if (!Send(gatherBuffer_.GetData(), gatherBuffer_.Num()))
+				return false;
+
+			gatherBuffer_.Reset();
+		}
+
+		gatherBuffer_.Append(span.datas, span.length);
+	}
+
+	if (gatherBuffer_.Num() == 0)
+		return true;
+
+	return Send(gatherBuffer_.GetData(), gatherBuffer_.Num());
+}
+
 }	// end namespace KBEngine
\ No newline at end of file
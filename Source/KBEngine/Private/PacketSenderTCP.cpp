@@ -1,11 +1,12 @@
 #include "PacketSenderTCP.h"
 #include "Containers/UnrealString.h"
 #include "KBEDebug.h"
-#include "GenericPlatform/GenericPlatformProcess.h"	// WritePipe
+#include "HAL/PlatformProcess.h"	// GetSynchEventFromPool
+#include "HAL/Event.h"
+#include "SocketSubsystem.h"
 
 #if PLATFORM_WINDOWS
 	#include "WinSock2.h"	// GetLastError(), WSANOTINITIALISED
-	#include "fileapi.h"	// ::ReadFile()
 #endif	// PLATFORM_WINDOWS
 
 namespace KBEngine
@@ -13,10 +14,9 @@ namespace KBEngine
 
 PacketSenderTCP::PacketSenderTCP(NetworkInterfaceBase* networkInterface, uint32 buffLength)
 	: PacketSenderBase(networkInterface),
-	buffer_(new uint8[buffLength]),
-	bufferLength_(buffLength)
+	buffer_(buffLength)
 {
-	InitPipe();
+	InitWakeEvent();
 	StartBackgroundSend();
 }
 
@@ -24,10 +24,7 @@ PacketSenderTCP::~PacketSenderTCP()
 {
 	StopBackgroundSend();
 
-	if (buffer_)
-		delete buffer_;
-
-	ClosePipe();
+	CloseWakeEvent();
 
 	KBE_DEBUG(TEXT("PacketSenderTCP::~PacketSenderTCP()"));
 }
@@ -36,50 +33,47 @@ bool PacketSenderTCP::Send(uint8* datas, uint32 length)
 {
 	KBE_ASSERT(length > 0);
 
-	uint32 t_spos = spos_;
-
-	//д±ڵڷ±꣬˵û߸ոշ꣬һûлػддβͷд
-	if (wpos_ >= t_spos)
+	if (!buffer_.Write(datas, length))
 	{
-		uint32 space1 = bufferLength_ - wpos_;
-		uint32 space2 = t_spos - 1;		//д±׷Ϸ±ʱ1λжǷ껹д
-		if (length > space1 + space2)
-		{
-			KBE_ERROR(TEXT("PacketSenderTCP::Send() : no space, Please adjust 'TCP_SEND_BUFFER_MAX'!data(%d) > space(%d), wpos=%u, spos=%u"), length, space1 + space2, wpos_, t_spos);
-			return false;
-		}
-
-		if (length <= space1)
-		{
-			memcpy(&(buffer_[wpos_]), datas, length);
-			wpos_ += length;
-		}
-		else
-		{
-			if (space1 > 0)
-			{
-				memcpy(&(buffer_[wpos_]), datas, space1);
-			}
-			memcpy(&(buffer_[0]), datas + space1, length - space1);
-			wpos_ = length - space1;
-		}
+		KBE_ERROR(TEXT("PacketSenderTCP::Send() : no space, Please adjust 'TCP_SEND_BUFFER_MAX'!data(%d) > space(%d)"), length, buffer_.WriteSpace());
+		return false;
 	}
-	//±д±꣬˵û겢Ѿػдд±д±֮λ
-	else
+
+	KBE_DEBUG(TEXT("PacketSenderTCP::Send() : data(%d), pending=%u"), length, buffer_.Size());
+
+	WakeUp();
+
+	return true;
+}
+
+bool PacketSenderTCP::SendV(const SendSpanArray& spans)
+{
+	uint32 length = 0;
+	for (auto& span : spans)
+		length += span.length;
+
+	if (length == 0)
+		return true;
+
+	// 先确认所有数据段都能放下，保证一组数据要么全部写入要么全部不写入
+	// 发送线程只会让空间变大，所以这里确认过的空间在写入过程中一直有效
+	uint32 space = buffer_.WriteSpace();
+	if (length > space)
 	{
-		if (length > t_spos - wpos_ - 1)
-		{
-			KBE_ERROR(TEXT("PacketSenderTCP::Send() : no space, Please adjust 'TCP_SEND_BUFFER_MAX'!data(%d) > space(%d), wpos=%u, spos=%u"), length, t_spos - wpos_ - 1, wpos_, t_spos);
-			return false;
-		}
+		KBE_ERROR(TEXT("PacketSenderTCP::SendV() : no space, Please adjust 'TCP_SEND_BUFFER_MAX'!data(%d) > space(%d)"), length, space);
+		return false;
+	}
 
-		memcpy(&(buffer_[wpos_]), datas, length);
-		wpos_ += length;
+	for (auto& span : spans)
+	{
+		if (span.length > 0)
+			buffer_.Write(span.datas, span.length);
 	}
 
-	KBE_DEBUG(TEXT("PacketSenderTCP::Send() : data(%d), wpos=%u, spos=%u"), length, wpos_, t_spos);
+	KBE_DEBUG(TEXT("PacketSenderTCP::SendV() : spans(%d), data(%d), pending=%u"), spans.Num(), length, buffer_.Size());
 
-	WritePipe();
+	// 所有数据段只唤醒一次发送线程，发送线程会把缓冲区中连续的数据一次发出
+	WakeUp();
 
 	return true;
 }
@@ -101,13 +95,8 @@ void PacketSenderTCP::DoThreadedWork()
 {
 	while (true)
 	{
-		FString data = ReadPipe();
-		if (data.Len() == 0)
-		{
-			KBE_ERROR(TEXT("PacketSenderBase::DoThreadedWork: pipe closed!"));
-			break;
-		}
-		//KBE_DEBUG(TEXT("PacketSenderBase::DoThreadedWork(), read pipe data '%s'"), *data);
+		// 自动重置的事件：等待期间的多次唤醒会合并为一次
+		wakeEvent_->Wait();
 
 		if (breakThread_)
 			break;
@@ -120,24 +109,14 @@ void PacketSenderTCP::DoThreadedWork()
 	breakThread_ = false;
 }
 
-uint32 PacketSenderTCP::SendSize() const
-{
-	uint32 t_wpos = wpos_;
-	if (t_wpos >= spos_)
-	{
-		return t_wpos - spos_;
-	}
-	return bufferLength_ - spos_ + t_wpos;
-}
-
 void PacketSenderTCP::StopBackgroundSend()
 {
 	if (thread_)
 	{
 		breakThread_ = true;
-		WritePipe(); // 
+		WakeUp(); // 激活阻塞
 
-		// ȴ߳̽
+		// 阻塞等待线程结束
 		thread_->WaitForCompletion();
 		delete thread_;
 		thread_ = nullptr;
@@ -146,37 +125,31 @@ void PacketSenderTCP::StopBackgroundSend()
 
 void PacketSenderTCP::BackgroundSend()
 {
-	uint32 sendSize = SendSize();
+	// 唤醒是合并的，上一轮发送可能已经把这次唤醒对应的数据发完了
+	uint32 sendSize = buffer_.ReadSize();
 	if (sendSize == 0)
-	{
-		KBE_WARNING(TEXT("PacketSenderBase::BackgroundSend: require send data, but no data to send!!!"));
 		return;
-	}
-
-	uint32 tailSize = bufferLength_ - spos_;
-	int32 bytesSent = 0;
 
-	if (sendSize <= tailSize)
+	// 一次唤醒就把缓冲区中所有待发送的数据发完：
+	// 主线程一次提交的多段数据在缓冲区中是连续存放的，未回环时只需一次Send，
+	// 回环时分尾部与头部两段发送；部分发送时继续发送剩余部分，避免数据滞留到下一次唤醒
+	while (sendSize > 0 && !breakThread_)
 	{
-		RealBackgroundSend(sendSize, bytesSent);
-		return;
-	}
+		uint8* datas = nullptr;
+		uint32 contiguousSize = buffer_.GetReadSpan(datas);
+		int32 bytesSent = 0;
 
-	uint32 remainSize = sendSize;
-	if (tailSize > 0)
-	{
-		RealBackgroundSend(tailSize, bytesSent);
-		if (tailSize != bytesSent)
+		RealBackgroundSend(datas, contiguousSize, bytesSent);
+		if (bytesSent <= 0)
 			return;
-		remainSize = sendSize - tailSize;
+
+		sendSize = buffer_.ReadSize();
 	}
-	spos_ = 0;	//÷λ
-	RealBackgroundSend(remainSize, bytesSent);
 }
 
-void PacketSenderTCP::RealBackgroundSend(uint32 sendSize, int32& bytesSent)
+void PacketSenderTCP::RealBackgroundSend(const uint8* datas, uint32 sendSize, int32& bytesSent)
 {
-	networkInterface_->Socket()->Send(&(buffer_[spos_]), sendSize, bytesSent);
+	networkInterface_->Socket()->Send(datas, sendSize, bytesSent);
 
 	if (bytesSent == -1)
 	{
@@ -201,7 +174,13 @@ void PacketSenderTCP::RealBackgroundSend(uint32 sendSize, int32& bytesSent)
 		};
 		if (!willClose_)
 			KBE_ERROR(TEXT("%s"), *errStr);
-#endif				
+#else
+		if (!willClose_)
+		{
+			ISocketSubsystem* socketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+			KBE_ERROR(TEXT("PacketSenderTCP::RealBackgroundSend: %s"), socketSubsystem ? socketSubsystem->GetSocketError() : TEXT("unknown error"));
+		}
+#endif
 
 		breakThread_ = true;
 		if (!willClose_)
@@ -211,49 +190,30 @@ void PacketSenderTCP::RealBackgroundSend(uint32 sendSize, int32& bytesSent)
 
 	if (bytesSent > 0)
 	{
-		spos_ += bytesSent;
+		// 归还已发送的空间给主线程
+		buffer_.CommitRead(bytesSent);
 	}
 }
 
 
-void PacketSenderTCP::InitPipe()
+void PacketSenderTCP::InitWakeEvent()
 {
-	FPlatformProcess::CreatePipe(readPipe_, writePipe_);
+	KBE_ASSERT(!wakeEvent_);
+	wakeEvent_ = FPlatformProcess::GetSynchEventFromPool(false);
 }
 
-void PacketSenderTCP::ClosePipe()
+void PacketSenderTCP::CloseWakeEvent()
 {
-	if (readPipe_ || writePipe_)
+	if (wakeEvent_)
 	{
-		FPlatformProcess::ClosePipe(readPipe_, writePipe_);
-		readPipe_ = writePipe_ = nullptr;
+		FPlatformProcess::ReturnSynchEventToPool(wakeEvent_);
+		wakeEvent_ = nullptr;
 	}
 }
 
-FString PacketSenderTCP::ReadPipe()
-{
-	FString Output;
-
-#if PLATFORM_WINDOWS
-	UTF8CHAR Buffer[255];
-	uint32 BytesRead = 0;
-	if (::ReadFile(readPipe_, Buffer, 254, (::DWORD*)&BytesRead, NULL))
-	{
-		if (BytesRead > 0)
-		{
-			Buffer[BytesRead] = '\0';
-			Output += FUTF8ToTCHAR((const ANSICHAR*)Buffer).Get();
-		}
-	}
-#else
-	KBE_ASSERT(false);
-#endif
-	return Output;
-}
-
-void PacketSenderTCP::WritePipe()
+void PacketSenderTCP::WakeUp()
 {
-	FPlatformProcess::WritePipe(writePipe_, TEXT("1"));
+	wakeEvent_->Trigger();
 }
 
 }	// end namespace KBEngine
\ No newline at end of file
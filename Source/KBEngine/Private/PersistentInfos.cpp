@@ -21,14 +21,13 @@ namespace KBEngine
 
 	void PersistentInofs::InitDigest()
 	{
-		MemoryStream kbengine_digest;
+		TArray<uint8> kbengine_digest;
 		
 		if (LoadFile(kbengine_digest, prefix_loginapp_digest + GetSuffix()))
-			loginapp_digest_ = kbengine_digest.ReadString();
+			loginapp_digest_ = MemoryStreamView(kbengine_digest.GetData(), kbengine_digest.Num()).ReadString();
 
-		kbengine_digest.Clear();
 		if (LoadFile(kbengine_digest, prefix_baseapp_digest + GetSuffix()))
-			baseapp_digest_ = kbengine_digest.ReadString();
+			baseapp_digest_ = MemoryStreamView(kbengine_digest.GetData(), kbengine_digest.Num()).ReadString();
 	}
 
 	bool PersistentInofs::LoadServerErrorsDescr(MemoryStream& out)
@@ -89,7 +88,7 @@ namespace KBEngine
 
 
 
-	void PersistentInofs::WriteLoginappMessages(MemoryStream &stream)
+	void PersistentInofs::WriteLoginappMessages(MemoryStreamView &stream)
 	{
 		MemoryStream inStream;
 		inStream.WriteString(loginapp_digest_);
@@ -97,7 +96,7 @@ namespace KBEngine
 		WriteFile(prefix_loginapp_messages + GetSuffixLoginapp(), inStream);
 	}
 
-	void PersistentInofs::WriteBaseappMessages(MemoryStream &stream)
+	void PersistentInofs::WriteBaseappMessages(MemoryStreamView &stream)
 	{
 		MemoryStream inStream;
 		inStream.WriteString(baseapp_digest_);
@@ -105,7 +104,7 @@ namespace KBEngine
 		WriteFile(prefix_baseapp_messages + GetSuffixBaseapp(), inStream);
 	}
 
-	void PersistentInofs::WriteServerErrorsDescr(MemoryStream &stream)
+	void PersistentInofs::WriteServerErrorsDescr(MemoryStreamView &stream)
 	{
 		MemoryStream inStream;
 		inStream.WriteString(loginapp_digest_);
@@ -113,7 +112,7 @@ namespace KBEngine
 		WriteFile(prefix_server_err_descr + GetSuffixLoginapp(), inStream);
 	}
 
-	void PersistentInofs::WriteEntityDef(MemoryStream &stream)
+	void PersistentInofs::WriteEntityDef(MemoryStreamView &stream)
 	{
 		MemoryStream inStream;
 		inStream.WriteString(baseapp_digest_);
@@ -181,7 +180,7 @@ namespace KBEngine
 		DeleteFile(prefix_entity_def + GetSuffixBaseapp());
 	}
 
-	void PersistentInofs::WriteFile(const FString &name, MemoryStream &stream)
+	void PersistentInofs::WriteFile(const FString &name, MemoryStreamView &stream)
 	{
 		KBE_DEBUG(TEXT("PersistentInofs::WriteFile: %s"), *(persistentDataPath_ + "/" + name));
 		DeleteFile(name);
@@ -205,6 +204,16 @@ namespace KBEngine
 	}
 
 	bool PersistentInofs::LoadFile(MemoryStream& out, const FString &name)
+	{
+		TArray<uint8> datas;
+		if (!LoadFile(datas, name))
+			return false;
+
+		out.Append(datas.GetData(), datas.Num());
+		return true;
+	}
+
+	bool PersistentInofs::LoadFile(TArray<uint8>& out, const FString &name)
 	{
 		IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
 		IFileHandle *file = PlatformFile.OpenRead(*(persistentDataPath_ + "/" + name));
@@ -218,14 +227,11 @@ namespace KBEngine
 		int32 len = (int32)file->Tell();
 		file->Seek(0);
 
-		TArray<uint8> datas;
-		datas.SetNumUninitialized(len);
-		file->Read(datas.GetData(), len);
+		out.SetNumUninitialized(len);
+		file->Read(out.GetData(), len);
 		delete file;
 
 		KBE_INFO(TEXT("PersistentInofs::LoadFile: %s/%s, datasize=%d"), *persistentDataPath_, *name, len);
-
-		out.Append(datas.GetData(), datas.Num());
 		return true;
 	}
 
@@ -3,6 +3,7 @@
 #include "Entity.h"
 #include "MemoryStream.h"
 #include "EntityDef.h"
+#include "KBEngineApp.h"
 
 namespace KBEngine
 {
@@ -41,27 +42,120 @@ namespace KBEngine
 				delete it.Value;
 		}
 
+		for (Entity* entity : entityPool_)
+			delete entity;
+		entityPool_.Empty();
+
+		for (Mailbox* mailbox : mailboxPool_)
+			delete mailbox;
+		mailboxPool_.Empty();
 	}
 
 	Entity* ScriptModule::CreateEntity(int32 eid)
 	{
 		Entity* entity = nullptr;
-		if (script_)
-			entity = script_->CreateEntity();
-
-		if (!entity)
+		if (entityPool_.Num() > 0)
 		{
-			KBE_ERROR(TEXT("ScriptModule::CreateEntity: module '%s' has no entity script! entityID = %d"), *name_, eid);
-			entity = new UnknownEntity();
+			entity = entityPool_.Pop(false);
+			poolStats_.reused++;
 		}
+		else
+		{
+			if (script_)
+				entity = script_->CreateEntity();
+
+			if (!entity)
+			{
+				KBE_ERROR(TEXT("ScriptModule::CreateEntity: module '%s' has no entity script! entityID = %d"), *name_, eid);
+				entity = new UnknownEntity();
+			}
+
+			poolStats_.created++;
+		}
+
+		poolStats_.live++;
+		if (poolStats_.live > poolStats_.peakLive)
+			poolStats_.peakLive = poolStats_.live;
 
 		entity->ID(eid);
 		entity->ClassName(name_);
 		entity->InitProperties(*this);
 
+		if (!proxiesBound_)
+			BindProxies(entity);
+
 		return entity;
 	}
 
+	void ScriptModule::ReleaseEntity(Entity* entity)
+	{
+		KBE_ASSERT(poolStats_.live > 0);
+		poolStats_.live--;
+
+		if (entity->baseMailbox_)
+		{
+			ReleaseMailbox(entity->baseMailbox_);
+			entity->baseMailbox_ = nullptr;
+		}
+
+		if (entity->cellMailbox_)
+		{
+			ReleaseMailbox(entity->cellMailbox_);
+			entity->cellMailbox_ = nullptr;
+		}
+
+		int32 poolSize = KBEngineApp::app ? KBEngineApp::app->EntityPoolSize() : 0;
+		if (entityPool_.Num() >= poolSize)
+		{
+			delete entity;
+			return;
+		}
+
+		entity->Recycle();
+		entityPool_.Add(entity);
+		poolStats_.released++;
+	}
+
+	Mailbox* ScriptModule::CreateMailbox(int32 eid, Mailbox::MAILBOX_TYPE mbType)
+	{
+		if (mailboxPool_.Num() > 0)
+		{
+			Mailbox* mailbox = mailboxPool_.Pop(false);
+			mailbox->Reset(eid, name_, mbType);
+			return mailbox;
+		}
+
+		return new Mailbox(eid, name_, mbType);
+	}
+
+	void ScriptModule::ReleaseMailbox(Mailbox* mailbox)
+	{
+		// 每个实体最多同时持有base与cell两个Mailbox
+		int32 poolSize = KBEngineApp::app ? KBEngineApp::app->EntityPoolSize() * 2 : 0;
+		if (mailboxPool_.Num() >= poolSize)
+		{
+			delete mailbox;
+			return;
+		}
+
+		mailboxPool_.Add(mailbox);
+	}
+
+	void ScriptModule::BindProxies(Entity* entity)
+	{
+		// 方法与属性在模块创建之后才陆续导入，所以在创建第一个实体时才进行绑定，同一个类只需要绑定一次
+		proxiesBound_ = true;
+
+		for (auto it : methods_)
+			it.Value->proxy = entity->FindMethodProxy(it.Key);
+
+		for (auto it : propertys_)
+		{
+			it.Value->proxy = entity->FindPropertyProxy(it.Key);
+			it.Value->plan.Compile(it.Value->utype);
+		}
+	}
+
 	Property* ScriptModule::GetProperty(const FString& name)
 	{
 		Property** pp = propertys_.Find(name);
@@ -70,7 +164,16 @@ namespace KBEngine
 
 	Property* ScriptModule::GetProperty(uint16 id)
 	{
-		Property** pp = idpropertys_.Find(id);
+		if (usePropertyDescrAlias_)
+			return id < idpropertys_.Num() ? idpropertys_[id] : nullptr;
+
+		Property** pp = utypepropertys_.Find(id);
+		return pp ? *pp : nullptr;
+	}
+
+	Property* ScriptModule::GetPropertyByUType(uint16 utype)
+	{
+		Property** pp = utypepropertys_.Find(utype);
 		return pp ? *pp : nullptr;
 	}
 
@@ -82,7 +185,10 @@ namespace KBEngine
 
 	Method* ScriptModule::GetMethod(uint16 id)
 	{
-		Method** pp = idmethods_.Find(id);
+		if (useMethodDescrAlias_)
+			return id < idmethods_.Num() ? idmethods_[id] : nullptr;
+
+		Method** pp = utypemethods_.Find(id);
 		return pp ? *pp : nullptr;
 	}
 
@@ -110,7 +216,7 @@ namespace KBEngine
 		return pp ? *pp : nullptr;
 	}
 
-	Property* ScriptModule::MakeProperty(MemoryStream &stream)
+	Property* ScriptModule::MakeProperty(MemoryStreamView &stream)
 	{
 		Property* savedata = new Property();
 
@@ -123,6 +229,10 @@ namespace KBEngine
 
 		savedata->val = savedata->utype->ParseDefaultValStr(savedata->defaultValStr);
 
+		savedata->slot = slotpropertys_.Num();
+		slotpropertys_.Add(savedata);
+		defaultValues_.Add(savedata->val);
+
 		//Type Class = module.script;
 		//PropertyHandler setmethod = null;
 
@@ -144,13 +254,15 @@ namespace KBEngine
 
 		propertys_.Add(savedata->name, savedata);
 
-		if (UsePropertyDescrAlias())
-		{
-			idpropertys_.Add((uint16)savedata->aliasID, savedata);
-		}
-		else
+		utypepropertys_.Add(savedata->properUtype, savedata);
+
+		// 别名ID在数据流中以uint8传输，只有0-255的别名才放入按别名索引的数组
+		if (UsePropertyDescrAlias() && savedata->aliasID >= 0 && savedata->aliasID <= 0xFF)
 		{
-			idpropertys_.Add(savedata->properUtype, savedata);
+			if (idpropertys_.Num() <= savedata->aliasID)
+				idpropertys_.SetNumZeroed(savedata->aliasID + 1);
+
+			idpropertys_[savedata->aliasID] = savedata;
 		}
 
 		KBE_DEBUG(TEXT("ScriptModule::MakeProperty: add(%s), property(%s/%d)."), *name_, *savedata->name, savedata->properUtype);
@@ -158,7 +270,7 @@ namespace KBEngine
 		return savedata;
 	}
 
-	Method* ScriptModule::MakeMethod(MemoryStream &stream)
+	Method* ScriptModule::MakeMethod(MemoryStreamView &stream)
 	{
 		Method* method = new Method();
 		method->methodUtype = stream.ReadUint16();
@@ -195,13 +307,14 @@ namespace KBEngine
 
 		methods_.Add(method->name, method);
 
-		if (UseMethodDescrAlias())
-		{
-			idmethods_.Add((uint16)method->aliasID, method);
-		}
-		else
+		utypemethods_.Add(method->methodUtype, method);
+
+		if (UseMethodDescrAlias() && method->aliasID >= 0 && method->aliasID <= 0xFF)
 		{
-			idmethods_.Add(method->methodUtype, method);
+			if (idmethods_.Num() <= method->aliasID)
+				idmethods_.SetNumZeroed(method->aliasID + 1);
+
+			idmethods_[method->aliasID] = method;
 		}
 
 		KBE_DEBUG(TEXT("ScriptModule::MakeMethod: add(%s), method(%s)."), *name_, *method->name);
@@ -209,7 +322,7 @@ namespace KBEngine
 		return method;
 	}
 
-	Method* ScriptModule::MakeBaseMethod(MemoryStream &stream)
+	Method* ScriptModule::MakeBaseMethod(MemoryStreamView &stream)
 	{
 		Method* method = new Method();
 		method->methodUtype = stream.ReadUint16();
@@ -238,7 +351,7 @@ namespace KBEngine
 		return method;
 	}
 
-	Method* ScriptModule::MakeCellMethod(MemoryStream &stream)
+	Method* ScriptModule::MakeCellMethod(MemoryStreamView &stream)
 	{
 		Method* method = new Method();
 		method->methodUtype = stream.ReadUint16();
@@ -266,24 +379,4 @@ namespace KBEngine
 
 		return method;
 	}
-
-	void ScriptModule::ClonePropertyTo(TMap<FString, Property *>& out1, TMap<uint16, Property *>& out2)
-	{
-		for (auto it : propertys_)
-		{
-			Property *e = it.Value;
-			Property *newp = new Property();
-			newp->name = e->name;
-			newp->utype = e->utype;
-			newp->properUtype = e->properUtype;
-			newp->properFlags = e->properFlags;
-			newp->aliasID = e->aliasID;
-			newp->defaultValStr = e->defaultValStr;
-			newp->setmethod = e->setmethod;
-			newp->val = newp->utype->ParseDefaultValStr(newp->defaultValStr);
-
-			out1.Add(e->name, newp);
-			out2.Add(e->properUtype, newp);
-		}
-	}
 }
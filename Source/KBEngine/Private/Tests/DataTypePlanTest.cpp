@@ -0,0 +1,169 @@
+#include "DataTypePlan.h"
+#include "KBEnginePrivatePCH.h"
+#include "Misc/AutomationTest.h"
+#include "DataTypes.h"
+#include "EntityDef.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace KBEngine
+{
+	// 每轮解码的记录数量
+	static const int32 DATA_TYPE_PLAN_RECORDS = 20000;
+
+	// 每条路径的点数
+	static const int32 DATA_TYPE_PLAN_PATH_POINTS = 8;
+
+	/*
+	测试用的数据类型，字段使用EntityDef中内置类型的ID
+	EntityDef还没有初始化（没有连接服务器）时由这里初始化，结束后清除；已经初始化时只读取，不做修改
+	*/
+	struct DataTypePlanTestTypes
+	{
+		DataTypePlanTestTypes() :
+			ownsEntityDef(EntityDef::DataTypeNum() == 0),
+			avatar(TEXT("")),
+			path(16)
+		{
+			if (ownsEntityDef)
+				EntityDef::Init();
+
+			avatar.AddSubType(TEXT("id"), 8);
+			avatar.AddSubType(TEXT("hp"), 4);
+			avatar.AddSubType(TEXT("speed"), 13);
+			avatar.AddSubType(TEXT("position"), 16);
+			avatar.AddSubType(TEXT("name"), 12);
+			avatar.Bind();
+			path.Bind();
+		}
+
+		~DataTypePlanTestTypes()
+		{
+			if (ownsEntityDef)
+				EntityDef::Clear();
+		}
+
+		bool ownsEntityDef;
+
+		// FIXED_DICT {id: INT32, hp: UINT32, speed: FLOAT, position: VECTOR3, name: UNICODE}
+		KBEDATATYPE_FIXED_DICT avatar;
+
+		// ARRAY <of> VECTOR3 </of>
+		KBEDATATYPE_ARRAY path;
+	};
+
+	static void WriteAvatars(MemoryStream& stream, int32 count)
+	{
+		for (int32 i = 0; i < count; ++i)
+		{
+			stream.WriteInt32(i);
+			stream.WriteUint32(1000 + i);
+			stream.WriteFloat(i * 0.5f);
+			stream.WriteFloat((float)i);
+			stream.WriteFloat(2.f * i);
+			stream.WriteFloat(-1.f * i);
+			stream.WriteUTF8(FString::Printf(TEXT("avatar_%d"), i));
+		}
+	}
+
+	static void WritePaths(MemoryStream& stream, int32 count)
+	{
+		for (int32 i = 0; i < count; ++i)
+		{
+			stream.WriteUint32(DATA_TYPE_PLAN_PATH_POINTS);
+			for (int32 n = 0; n < DATA_TYPE_PLAN_PATH_POINTS * 3; ++n)
+				stream.WriteFloat((float)(i + n));
+		}
+	}
+
+	// 解码data中的count条记录，plan为nullptr时使用CreateFromStream；返回每条记录的耗时，单位：纳秒
+	static double MeasureDecode(KBEDATATYPE_BASE* type, const DataTypePlan* plan, const MemoryStream& data, int32 count)
+	{
+		MemoryStreamView stream(data.Data(), data.WPos());
+
+		double start = FPlatformTime::Seconds();
+
+		for (int32 i = 0; i < count; ++i)
+		{
+			FVariant value = plan ? plan->Decode(stream) : type->CreateFromStream(&stream);
+			(void)value;
+		}
+
+		return (FPlatformTime::Seconds() - start) * 1e9 / count;
+	}
+
+	// 两种方式解码的结果必须相同
+	static bool CheckSameResult(FAutomationTestBase& test, const TCHAR* name, KBEDATATYPE_BASE* type, const DataTypePlan& plan, const MemoryStream& data, int32 count)
+	{
+		MemoryStreamView byType(data.Data(), data.WPos());
+		MemoryStreamView byPlan(data.Data(), data.WPos());
+
+		for (int32 i = 0; i < count; ++i)
+		{
+			if (type->CreateFromStream(&byType) != plan.Decode(byPlan))
+			{
+				test.AddError(FString::Printf(TEXT("%s: record %d differs"), name, i));
+				return false;
+			}
+		}
+
+		return test.TestEqual(FString::Printf(TEXT("%s: whole stream is consumed"), name), (int64)byPlan.RPos(), (int64)data.WPos());
+	}
+
+	static void RunDecodeBenchmark(FAutomationTestBase& test, const TCHAR* name, KBEDATATYPE_BASE* type, const DataTypePlan& plan, const MemoryStream& data, int32 count)
+	{
+		// 先各运行一次，排除第一次运行时的缓存与内存分配的影响
+		MeasureDecode(type, nullptr, data, count);
+		MeasureDecode(type, &plan, data, count);
+
+		double byType = MeasureDecode(type, nullptr, data, count);
+		double byPlan = MeasureDecode(type, &plan, data, count);
+
+		test.AddInfo(FString::Printf(TEXT("%s: CreateFromStream %.1f ns/record, DataTypePlan %.1f ns/record (x%.2f)"),
+			name, byType, byPlan, byPlan > 0.0 ? byType / byPlan : 0.0));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKBEDataTypePlanDecodeTest, "KBEngine.DataTypePlan.Decode", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKBEDataTypePlanDecodeTest::RunTest(const FString& Parameters)
+{
+	KBEngine::DataTypePlanTestTypes types;
+
+	KBEngine::DataTypePlan avatarPlan;
+	avatarPlan.Compile(&types.avatar);
+	KBEngine::DataTypePlan pathPlan;
+	pathPlan.Compile(&types.path);
+
+	KBEngine::MemoryStream avatars;
+	KBEngine::WriteAvatars(avatars, 100);
+	KBEngine::MemoryStream paths;
+	KBEngine::WritePaths(paths, 100);
+
+	bool ok = KBEngine::CheckSameResult(*this, TEXT("FIXED_DICT"), &types.avatar, avatarPlan, avatars, 100);
+	ok = KBEngine::CheckSameResult(*this, TEXT("ARRAY"), &types.path, pathPlan, paths, 100) && ok;
+	return ok;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKBEDataTypePlanBenchmark, "KBEngine.DataTypePlan.Benchmark", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FKBEDataTypePlanBenchmark::RunTest(const FString& Parameters)
+{
+	KBEngine::DataTypePlanTestTypes types;
+
+	KBEngine::DataTypePlan avatarPlan;
+	avatarPlan.Compile(&types.avatar);
+	KBEngine::DataTypePlan pathPlan;
+	pathPlan.Compile(&types.path);
+
+	KBEngine::MemoryStream avatars;
+	KBEngine::WriteAvatars(avatars, KBEngine::DATA_TYPE_PLAN_RECORDS);
+	KBEngine::MemoryStream paths;
+	KBEngine::WritePaths(paths, KBEngine::DATA_TYPE_PLAN_RECORDS);
+
+	KBEngine::RunDecodeBenchmark(*this, TEXT("FIXED_DICT"), &types.avatar, avatarPlan, avatars, KBEngine::DATA_TYPE_PLAN_RECORDS);
+	KBEngine::RunDecodeBenchmark(*this, TEXT("ARRAY"), &types.path, pathPlan, paths, KBEngine::DATA_TYPE_PLAN_RECORDS);
+	return true;
+}
+
+#endif
@@ -0,0 +1,64 @@
+#include "Entity.h"
+#include "KBEnginePrivatePCH.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace KBEngine
+{
+	// 只用于测试：直接设置服务器同步的坐标与朝向
+	class SnapshotTestEntity : public Entity
+	{
+	public:
+		void SetVolatileData(const FVector& position, const FVector& direction)
+		{
+			position_ = position;
+			direction_ = direction;
+		}
+	};
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKBEEntitySnapshotSeedTest, "KBEngine.EntitySnapshot.SeedFromFirstSnapshot", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKBEEntitySnapshotSeedTest::RunTest(const FString& Parameters)
+{
+	const FVector position(100.f, 200.f, 300.f);
+	const FVector direction(0.f, 0.f, 90.f);
+
+	KBEngine::SnapshotTestEntity entity;
+	entity.SetVolatileData(position, direction);
+	entity.AddSnapshot(10.0, 0.1);
+
+	// 还没有经过BaseApp::InterpolateEntities，平滑值必须已经是第一个快照
+	TestEqual(TEXT("smoothed position is seeded"), entity.SmoothedPosition(), position);
+	TestEqual(TEXT("smoothed direction is seeded"), entity.SmoothedDirection(), direction);
+
+	// 之后的快照不覆盖平滑值，由插值计算
+	entity.SetVolatileData(FVector(200.f, 200.f, 300.f), direction);
+	entity.AddSnapshot(10.1, 0.1);
+	TestEqual(TEXT("later snapshots leave the smoothed position alone"), entity.SmoothedPosition(), position);
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKBEEntitySnapshotBufferTest, "KBEngine.EntitySnapshot.Evaluate", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKBEEntitySnapshotBufferTest::RunTest(const FString& Parameters)
+{
+	KBEngine::EntitySnapshotBuffer buffer;
+	FVector position, direction;
+
+	TestFalse(TEXT("empty buffer has nothing to evaluate"), buffer.Evaluate(0.0, 0.0, position, direction));
+
+	buffer.Add(1.0, FVector(0.f, 0.f, 0.f), FVector(0.f, 0.f, 170.f), 0.1);
+	buffer.Add(2.0, FVector(10.f, 0.f, 0.f), FVector(0.f, 0.f, -170.f), 0.1);
+
+	TestTrue(TEXT("evaluate between snapshots"), buffer.Evaluate(1.5, 0.0, position, direction));
+	TestEqual(TEXT("position is interpolated"), position, FVector(5.f, 0.f, 0.f));
+	TestEqual(TEXT("direction takes the shortest path"), direction.Z, 180.f, 0.001f);
+
+	TestTrue(TEXT("evaluate after the newest snapshot"), buffer.Evaluate(2.5, 0.2, position, direction));
+	TestEqual(TEXT("extrapolation is capped"), position, FVector(12.f, 0.f, 0.f));
+	return true;
+}
+
+#endif
@@ -0,0 +1,244 @@
+#include "PackedFloat.h"
+#include "KBEnginePrivatePCH.h"
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace KBEngine
+{
+	// XZ的取样间隔（质数，让各个位的组合都能被取到），2^24个值中大约取27万个
+	static const uint32 PACKED_FLOAT_XZ_STRIDE = 61;
+
+	// XYZ随机取样的数量
+	static const int32 PACKED_FLOAT_XYZ_SAMPLES = 100000;
+
+	// 性能测试每轮解码的数量与轮数
+	static const int32 PACKED_FLOAT_BENCH_COUNT = 4096;
+	static const int32 PACKED_FLOAT_BENCH_ROUNDS = 200;
+
+	static bool SameBits(float a, float b)
+	{
+		return PackedFloat::AsUint32(a) == PackedFloat::AsUint32(b);
+	}
+
+	static void WriteXZ(TArray<uint8>& datas, uint32 value)
+	{
+		datas.Add((uint8)(value >> 16));
+		datas.Add((uint8)(value >> 8));
+		datas.Add((uint8)value);
+	}
+
+	static TArray<uint8> MakeXZSamples()
+	{
+		TArray<uint8> datas;
+		for (uint32 v = 0; v < (1u << 24); v += PACKED_FLOAT_XZ_STRIDE)
+			WriteXZ(datas, v);
+
+		// 符号位与尾数全为1的边界值
+		WriteXZ(datas, 0xFFFFFF);
+		WriteXZ(datas, 0x800800);
+		WriteXZ(datas, 0x7FF7FF);
+		return datas;
+	}
+
+	static TArray<uint8> MakeYSamples()
+	{
+		TArray<uint8> datas;
+		datas.SetNumUninitialized(65536 * 2);
+
+		for (uint32 v = 0; v < 65536; ++v)
+		{
+			uint16 data = (uint16)v;
+			FMemory::Memcpy(&datas[v * 2], &data, sizeof(data));
+		}
+
+		return datas;
+	}
+
+	static TArray<uint8> MakeXYZSamples(int32 count)
+	{
+		FRandomStream random(0x4B4245);
+
+		TArray<uint8> datas;
+		datas.SetNumUninitialized(count * 4);
+
+		for (int32 i = 0; i < count; ++i)
+		{
+			uint32 packed = random.GetUnsignedInt();
+			FMemory::Memcpy(&datas[i * 4], &packed, sizeof(packed));
+		}
+
+		return datas;
+	}
+
+	// 批量解码的结果必须与单个解码逐位相同；count依次减少，覆盖向量部分之后剩余的标量部分
+	static bool CheckXZ(FAutomationTestBase& test, const TArray<uint8>& datas, int32 count)
+	{
+		TArray<float> xs, zs;
+		xs.SetNumUninitialized(count);
+		zs.SetNumUninitialized(count);
+		PackedFloat::DecodeXZ(datas.GetData(), count, xs.GetData(), zs.GetData());
+
+		for (int32 i = 0; i < count; ++i)
+		{
+			float x, z;
+			PackedFloat::DecodeXZ(PackedFloat::LoadXZ(&datas[i * 3]), x, z);
+
+			if (!SameBits(x, xs[i]) || !SameBits(z, zs[i]))
+			{
+				test.AddError(FString::Printf(TEXT("XZ 0x%06x: bulk (%g, %g) scalar (%g, %g)"), PackedFloat::LoadXZ(&datas[i * 3]), xs[i], zs[i], x, z));
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	static bool CheckY(FAutomationTestBase& test, const TArray<uint8>& datas, int32 count)
+	{
+		TArray<float> ys;
+		ys.SetNumUninitialized(count);
+		PackedFloat::DecodeY(datas.GetData(), count, ys.GetData());
+
+		for (int32 i = 0; i < count; ++i)
+		{
+			uint16 data;
+			FMemory::Memcpy(&data, &datas[i * 2], sizeof(data));
+			float y = PackedFloat::DecodeY(data);
+
+			if (!SameBits(y, ys[i]))
+			{
+				test.AddError(FString::Printf(TEXT("Y 0x%04x: bulk %g scalar %g"), data, ys[i], y));
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	static bool CheckXYZ(FAutomationTestBase& test, const TArray<uint8>& datas, int32 count, float minf)
+	{
+		TArray<float> xs, ys, zs;
+		xs.SetNumUninitialized(count);
+		ys.SetNumUninitialized(count);
+		zs.SetNumUninitialized(count);
+		PackedFloat::DecodeXYZ(datas.GetData(), count, xs.GetData(), ys.GetData(), zs.GetData(), minf);
+
+		for (int32 i = 0; i < count; ++i)
+		{
+			uint32 packed;
+			FMemory::Memcpy(&packed, &datas[i * 4], sizeof(packed));
+
+			float x, y, z;
+			PackedFloat::DecodeXYZ(packed, x, y, z, minf);
+
+			if (!SameBits(x, xs[i]) || !SameBits(y, ys[i]) || !SameBits(z, zs[i]))
+			{
+				test.AddError(FString::Printf(TEXT("XYZ 0x%08x: bulk (%g, %g, %g) scalar (%g, %g, %g)"), packed, xs[i], ys[i], zs[i], x, y, z));
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	// 返回每个值的耗时，单位：纳秒
+	template<typename DecodeFunc>
+	static double MeasurePacked(int32 count, DecodeFunc decode)
+	{
+		double start = FPlatformTime::Seconds();
+
+		for (int32 round = 0; round < PACKED_FLOAT_BENCH_ROUNDS; ++round)
+			decode();
+
+		return (FPlatformTime::Seconds() - start) * 1e9 / ((double)count * PACKED_FLOAT_BENCH_ROUNDS);
+	}
+
+	template<typename ScalarFunc, typename BulkFunc>
+	static void RunPackedBenchmark(FAutomationTestBase& test, const TCHAR* name, ScalarFunc scalar, BulkFunc bulk)
+	{
+		// 先各运行一次，排除第一次运行时缓存的影响
+		MeasurePacked(PACKED_FLOAT_BENCH_COUNT, scalar);
+		MeasurePacked(PACKED_FLOAT_BENCH_COUNT, bulk);
+
+		double byScalar = MeasurePacked(PACKED_FLOAT_BENCH_COUNT, scalar);
+		double byBulk = MeasurePacked(PACKED_FLOAT_BENCH_COUNT, bulk);
+
+		test.AddInfo(FString::Printf(TEXT("%s: scalar %.2f ns/value, bulk %.2f ns/value (x%.2f)"),
+			name, byScalar, byBulk, byBulk > 0.0 ? byScalar / byBulk : 0.0));
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKBEPackedFloatBulkDecodeTest, "KBEngine.PackedFloat.BulkDecode", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKBEPackedFloatBulkDecodeTest::RunTest(const FString& Parameters)
+{
+	TArray<uint8> xzs = KBEngine::MakeXZSamples();
+	TArray<uint8> ys = KBEngine::MakeYSamples();
+	TArray<uint8> xyzs = KBEngine::MakeXYZSamples(KBEngine::PACKED_FLOAT_XYZ_SAMPLES);
+
+	int32 xzCount = xzs.Num() / 3;
+
+	bool ok = true;
+	for (int32 tail = 0; tail < 8 && ok; ++tail)
+	{
+		ok = KBEngine::CheckXZ(*this, xzs, xzCount - tail) && ok;
+		ok = KBEngine::CheckY(*this, ys, 65536 - tail) && ok;
+		ok = KBEngine::CheckXYZ(*this, xyzs, KBEngine::PACKED_FLOAT_XYZ_SAMPLES - tail, -256.f) && ok;
+	}
+
+	ok = KBEngine::CheckXYZ(*this, xyzs, KBEngine::PACKED_FLOAT_XYZ_SAMPLES, -100.f) && ok;
+	return ok;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKBEPackedFloatBenchmark, "KBEngine.PackedFloat.Benchmark", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FKBEPackedFloatBenchmark::RunTest(const FString& Parameters)
+{
+	using KBEngine::PackedFloat;
+
+	const int32 count = KBEngine::PACKED_FLOAT_BENCH_COUNT;
+
+	TArray<uint8> xzs = KBEngine::MakeXZSamples();
+	TArray<uint8> ys = KBEngine::MakeYSamples();
+	TArray<uint8> xyzs = KBEngine::MakeXYZSamples(count);
+
+	TArray<float> outX, outY, outZ;
+	outX.SetNumUninitialized(count);
+	outY.SetNumUninitialized(count);
+	outZ.SetNumUninitialized(count);
+
+	KBEngine::RunPackedBenchmark(*this, TEXT("XZ"),
+		[&]() {
+			for (int32 i = 0; i < count; ++i)
+				PackedFloat::DecodeXZ(PackedFloat::LoadXZ(&xzs[i * 3]), outX[i], outZ[i]);
+		},
+		[&]() { PackedFloat::DecodeXZ(xzs.GetData(), count, outX.GetData(), outZ.GetData()); });
+
+	KBEngine::RunPackedBenchmark(*this, TEXT("Y"),
+		[&]() {
+			for (int32 i = 0; i < count; ++i)
+			{
+				uint16 data;
+				FMemory::Memcpy(&data, &ys[i * 2], sizeof(data));
+				outY[i] = PackedFloat::DecodeY(data);
+			}
+		},
+		[&]() { PackedFloat::DecodeY(ys.GetData(), count, outY.GetData()); });
+
+	KBEngine::RunPackedBenchmark(*this, TEXT("XYZ"),
+		[&]() {
+			for (int32 i = 0; i < count; ++i)
+			{
+				uint32 packed;
+				FMemory::Memcpy(&packed, &xyzs[i * 4], sizeof(packed));
+				PackedFloat::DecodeXYZ(packed, outX[i], outY[i], outZ[i], -256.f);
+			}
+		},
+		[&]() { PackedFloat::DecodeXYZ(xyzs.GetData(), count, outX.GetData(), outY.GetData(), outZ.GetData()); });
+
+	return true;
+}
+
+#endif
@@ -0,0 +1,207 @@
+#include "RingBuffer.h"
+#include "KBEnginePrivatePCH.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+
+#include <atomic>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace KBEngine
+{
+	// 压力测试写入的元素总数，每个元素的值就是它的序号，消费者据此检查顺序与完整性
+	static const uint32 RING_BUFFER_STRESS_COUNT = 4 * 1024 * 1024;
+
+	// 消费者等待数据的最长时间，超过则认为生产者的数据丢失；单位：秒
+	static const double RING_BUFFER_STRESS_TIMEOUT = 60.0;
+
+	static void MaybeShrink(RingBuffer<uint32>& buffer)
+	{
+	}
+
+	static void MaybeShrink(GrowableRingBuffer<uint32>& buffer)
+	{
+		buffer.Shrink();
+	}
+
+	/*
+	生产者线程：以不断变化的长度写入连续的序号，覆盖回环、部分写入以及（可增长的缓冲区）扩容与收缩
+	*/
+	template<typename BufferType>
+	class RingBufferStressProducer : public FRunnable
+	{
+	public:
+		explicit RingBufferStressProducer(BufferType& buffer) :
+			buffer_(buffer)
+		{
+		}
+
+		virtual uint32 Run() override
+		{
+			uint32 next = 0;
+			uint32 chunk = 1;
+
+			while (next < RING_BUFFER_STRESS_COUNT && !stop_.load(std::memory_order_relaxed))
+			{
+				// 每写入64K个元素尝试收缩一次，只有缓冲区被读空时才会真正收缩
+				if ((next & 0xFFFF) == 0)
+					MaybeShrink(buffer_);
+
+				uint32* datas = nullptr;
+				uint32 space = buffer_.GetWriteSpan(datas);
+				if (space == 0)
+				{
+					FPlatformProcess::Sleep(0);
+					continue;
+				}
+
+				uint32 count = FMath::Min3(space, chunk, RING_BUFFER_STRESS_COUNT - next);
+				for (uint32 i = 0; i < count; ++i)
+					datas[i] = next++;
+
+				buffer_.CommitWrite(count);
+				chunk = chunk % 1021 + 1;
+			}
+
+			return 0;
+		}
+
+		void Stop()
+		{
+			stop_.store(true, std::memory_order_relaxed);
+		}
+
+	private:
+		BufferType& buffer_;
+		std::atomic<bool> stop_{ false };
+	};
+
+	// 在当前线程中作为消费者读取并检查生产者线程写入的数据
+	template<typename BufferType>
+	static bool RunRingBufferStress(FAutomationTestBase& test, BufferType& buffer)
+	{
+		RingBufferStressProducer<BufferType> producer(buffer);
+		FRunnableThread* thread = FRunnableThread::Create(&producer, TEXT("KBEngineRingBufferStressProducer"));
+
+		uint32 expected = 0;
+		uint32 chunk = 1;
+		double lastReadTime = FPlatformTime::Seconds();
+		bool ok = true;
+
+		while (ok && expected < RING_BUFFER_STRESS_COUNT)
+		{
+			uint32* datas = nullptr;
+			uint32 size = buffer.GetReadSpan(datas);
+			if (size == 0)
+			{
+				if (FPlatformTime::Seconds() - lastReadTime > RING_BUFFER_STRESS_TIMEOUT)
+				{
+					test.AddError(FString::Printf(TEXT("timeout waiting for element %u"), expected));
+					ok = false;
+				}
+
+				FPlatformProcess::Sleep(0);
+				continue;
+			}
+
+			// 每次只读取一部分，让读写位置在环中错开
+			uint32 count = FMath::Min(size, chunk);
+			for (uint32 i = 0; i < count; ++i)
+			{
+				if (datas[i] != expected)
+				{
+					test.AddError(FString::Printf(TEXT("element %u is %u"), expected, datas[i]));
+					ok = false;
+					break;
+				}
+
+				expected++;
+			}
+
+			buffer.CommitRead(count);
+			chunk = chunk % 769 + 1;
+			lastReadTime = FPlatformTime::Seconds();
+		}
+
+		producer.Stop();
+		thread->WaitForCompletion();
+		delete thread;
+
+		return ok;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKBERingBufferStressTest, "KBEngine.RingBuffer.Stress", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKBERingBufferStressTest::RunTest(const FString& Parameters)
+{
+	KBEngine::RingBuffer<uint32> buffer(1000);
+	TestEqual(TEXT("capacity is rounded up to a power of two"), buffer.Capacity(), 1024u);
+
+	bool ok = KBEngine::RunRingBufferStress(*this, buffer);
+	TestTrue(TEXT("buffer is empty after the consumer caught up"), ok && buffer.Empty());
+	return ok;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKBEGrowableRingBufferStressTest, "KBEngine.GrowableRingBuffer.Stress", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKBEGrowableRingBufferStressTest::RunTest(const FString& Parameters)
+{
+	KBEngine::GrowableRingBuffer<uint32> buffer(256, 64 * 1024);
+
+	bool ok = KBEngine::RunRingBufferStress(*this, buffer);
+
+	uint32* datas = nullptr;
+	TestEqual(TEXT("nothing is left to read"), buffer.GetReadSpan(datas), 0u);
+	return ok;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKBEGrowableRingBufferCapacityTest, "KBEngine.GrowableRingBuffer.Capacity", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKBEGrowableRingBufferCapacityTest::RunTest(const FString& Parameters)
+{
+	// 上限不是2的幂时向下取整，消费者不读取时所有环的容量总和也不能超过上限
+	KBEngine::GrowableRingBuffer<uint32> buffer(256, 1000);
+	TestEqual(TEXT("max capacity is rounded down to a power of two"), buffer.MaxCapacity(), 512u);
+
+	uint32 written = 0;
+	while (true)
+	{
+		uint32* datas = nullptr;
+		uint32 space = buffer.GetWriteSpan(datas);
+		if (space == 0)
+			break;
+
+		for (uint32 i = 0; i < space; ++i)
+			datas[i] = written++;
+
+		buffer.CommitWrite(space);
+		TestTrue(TEXT("allocated capacity stays within the cap"), buffer.AllocatedCapacity() <= buffer.MaxCapacity());
+	}
+
+	TestEqual(TEXT("buffered elements fill the cap exactly"), written, 512u);
+
+	// 读空之后旧环被释放，额度归还
+	uint32 expected = 0;
+	uint32* datas = nullptr;
+	while (uint32 size = buffer.GetReadSpan(datas))
+	{
+		for (uint32 i = 0; i < size; ++i)
+		{
+			if (datas[i] != expected++)
+			{
+				AddError(FString::Printf(TEXT("element %u is %u"), expected - 1, datas[i]));
+				return false;
+			}
+		}
+
+		buffer.CommitRead(size);
+	}
+
+	TestEqual(TEXT("every element is read back"), expected, written);
+	TestEqual(TEXT("drained segments return their capacity"), buffer.AllocatedCapacity(), buffer.Capacity());
+	return true;
+}
+
+#endif
@@ -0,0 +1,108 @@
+#include "VolatileDataBatch.h"
+#include "KBEnginePrivatePCH.h"
+#include "Misc/AutomationTest.h"
+#include "PackedFloat.h"
+#include "KBEMath.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+using KBEngine::VolatileDataBatch;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKBEVolatileDataBatchMergeTest, "KBEngine.VolatileDataBatch.MergeSameEntity", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKBEVolatileDataBatchMergeTest::RunTest(const FString& Parameters)
+{
+	VolatileDataBatch batch;
+
+	batch.Add(1, VolatileDataBatch::HAS_POSITION, FVector(1.f, 2.f, 3.f), FVector::ZeroVector, FVector::ZeroVector, 1);
+	batch.Add(2, VolatileDataBatch::HAS_POSITION, FVector(7.f, 8.f, 9.f), FVector::ZeroVector, FVector::ZeroVector, -1);
+	batch.Add(1, VolatileDataBatch::HAS_POSITION, FVector(4.f, 5.f, 6.f), FVector(10.f, 0.f, 0.f), FVector::ZeroVector, -1);
+
+	// 同一个实体只占一条，坐标以最后一次为准，没有设置的isOnGround保留之前的值
+	TestEqual(TEXT("one slot per entity"), batch.Num(), 2);
+	TestEqual(TEXT("updates are counted"), batch.totalUpdates, (uint64)3);
+	TestEqual(TEXT("the repeated update is merged"), batch.mergedUpdates, (uint64)1);
+	TestEqual(TEXT("first entity keeps its slot"), batch.entityIDs[0], 1);
+	TestEqual(TEXT("last position wins"), batch.positions[0], FVector(4.f, 5.f, 6.f));
+	TestEqual(TEXT("position offset follows the position"), batch.positionOffsets[0], FVector(10.f, 0.f, 0.f));
+	TestEqual(TEXT("unset isOnGround keeps the earlier value"), batch.onGrounds[0], (int8)1);
+	TestEqual(TEXT("other entity is untouched"), batch.positions[1], FVector(7.f, 8.f, 9.f));
+
+	batch.Reset();
+	TestEqual(TEXT("reset empties the batch"), batch.Num(), 0);
+
+	batch.Add(1, VolatileDataBatch::HAS_POSITION, FVector(1.f, 1.f, 1.f), FVector::ZeroVector, FVector::ZeroVector, -1);
+	TestEqual(TEXT("reset forgets the old slots"), batch.Num(), 1);
+	TestEqual(TEXT("reset entity starts a new slot"), batch.positions[0], FVector(1.f, 1.f, 1.f));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKBEVolatileDataBatchAngleTest, "KBEngine.VolatileDataBatch.MergeAnglesPerComponent", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKBEVolatileDataBatchAngleTest::RunTest(const FString& Parameters)
+{
+	VolatileDataBatch batch;
+
+	// 先收到完整的朝向，再分别只更新yaw与roll：没有更新的分量保留之前的值
+	batch.Add(1, VolatileDataBatch::HAS_DIRECTION, FVector::ZeroVector, FVector::ZeroVector, FVector(10.f, 20.f, 30.f), -1);
+	batch.Add(1, VolatileDataBatch::HAS_YAW, FVector::ZeroVector, FVector::ZeroVector, FVector(0.f, 0.f, 90.f), -1);
+	batch.Add(1, VolatileDataBatch::HAS_ROLL, FVector::ZeroVector, FVector::ZeroVector, FVector(45.f, 0.f, 0.f), -1);
+
+	TestEqual(TEXT("one slot"), batch.Num(), 1);
+	TestEqual(TEXT("roll is overwritten"), batch.angles[0].X, 45.f);
+	TestEqual(TEXT("pitch is kept"), batch.angles[0].Y, 20.f);
+	TestEqual(TEXT("yaw is overwritten"), batch.angles[0].Z, 90.f);
+	TestEqual(TEXT("no position flag was added"), batch.flags[0] & VolatileDataBatch::HAS_POSITION, 0);
+
+	// 只有部分分量的更新合并后，标记是各次更新的并集，坐标更新不改动朝向
+	batch.Add(2, VolatileDataBatch::HAS_PITCH, FVector::ZeroVector, FVector::ZeroVector, FVector(0.f, 5.f, 0.f), -1);
+	batch.Add(2, (uint8)(VolatileDataBatch::HAS_POSITION | VolatileDataBatch::HAS_YAW), FVector(1.f, 2.f, 3.f), FVector::ZeroVector, FVector(99.f, 99.f, 15.f), -1);
+
+	TestEqual(TEXT("flags are merged"), (int32)batch.flags[1], (int32)(VolatileDataBatch::HAS_PITCH | VolatileDataBatch::HAS_POSITION | VolatileDataBatch::HAS_YAW));
+	TestEqual(TEXT("pitch from the first update is kept"), batch.angles[1].Y, 5.f);
+	TestEqual(TEXT("yaw from the second update is applied"), batch.angles[1].Z, 15.f);
+	TestEqual(TEXT("roll without its flag is ignored"), batch.angles[1].X, 0.f);
+	TestEqual(TEXT("position is applied"), batch.positions[1], FVector(1.f, 2.f, 3.f));
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FKBEVolatileDataBatchPackedTest, "KBEngine.VolatileDataBatch.DecodePackedPositions", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::EngineFilter)
+
+bool FKBEVolatileDataBatchPackedTest::RunTest(const FString& Parameters)
+{
+	using KBEngine::PackedFloat;
+
+	const uint8 packedXZ[3] = { 0x9A, 0xBC, 0xDE };
+	const uint16 y = 0x8123;
+	uint8 packedY[2];
+	FMemory::Memcpy(packedY, &y, sizeof(y));
+
+	float x, z;
+	PackedFloat::DecodeXZ(PackedFloat::LoadXZ(packedXZ), x, z);
+	const FVector expected = KBEngine::KBEMath::KBEngine2UnrealPosition(FVector(x, PackedFloat::DecodeY(y), z));
+	const FVector expectedNoY = KBEngine::KBEMath::KBEngine2UnrealPosition(FVector(x, 0.f, z));
+
+	VolatileDataBatch batch;
+	batch.AddPacked(1, 0, packedXZ, packedY, FVector::ZeroVector, FVector::ZeroVector, 0);
+	batch.AddPacked(2, 0, packedXZ, nullptr, FVector::ZeroVector, FVector::ZeroVector, 1);
+
+	// 压缩的坐标之后又收到了未压缩的坐标，以后者为准
+	batch.AddPacked(3, 0, packedXZ, packedY, FVector::ZeroVector, FVector::ZeroVector, 0);
+	batch.Add(3, VolatileDataBatch::HAS_POSITION, FVector(1.f, 2.f, 3.f), FVector::ZeroVector, FVector::ZeroVector, -1);
+
+	// 未压缩的坐标之后又收到了压缩的坐标，同样以后者为准
+	batch.Add(4, VolatileDataBatch::HAS_POSITION, FVector(1.f, 2.f, 3.f), FVector::ZeroVector, FVector::ZeroVector, -1);
+	batch.AddPacked(4, VolatileDataBatch::HAS_YAW, packedXZ, packedY, FVector::ZeroVector, FVector(0.f, 0.f, 90.f), 0);
+
+	batch.DecodePackedPositions();
+
+	TestEqual(TEXT("packed XYZ matches the scalar decode"), batch.positions[0], expected);
+	TestEqual(TEXT("packed XZ without Y decodes Y as zero"), batch.positions[1], expectedNoY);
+	TestEqual(TEXT("a later plain position replaces the packed one"), batch.positions[2], FVector(1.f, 2.f, 3.f));
+	TestEqual(TEXT("a later packed position replaces the plain one"), batch.positions[3], expected);
+	TestEqual(TEXT("packed flag is cleared after decoding"), batch.flags[3] & VolatileDataBatch::HAS_PACKED_POSITION, 0);
+	TestEqual(TEXT("merged flags keep the position and yaw"), (int32)batch.flags[3], (int32)(VolatileDataBatch::HAS_POSITION | VolatileDataBatch::HAS_YAW));
+	return true;
+}
+
+#endif
@@ -0,0 +1,110 @@
+#include "VolatileDataBatch.h"
+#include "KBEnginePrivatePCH.h"
+#include "PackedFloat.h"
+#include "KBEMath.h"
+
+namespace KBEngine
+{
+	void VolatileDataBatch::Add(int32 entityID, uint8 updateFlags, const FVector& position, const FVector& positionOffset, const FVector& updateAngles, int8 isOnGround)
+	{
+		Merge(entityID, updateFlags, position, positionOffset, updateAngles, isOnGround);
+	}
+
+	void VolatileDataBatch::AddPacked(int32 entityID, uint8 updateFlags, const uint8* packedXZ, const uint8* packedY, const FVector& positionOffset, const FVector& updateAngles, int8 isOnGround)
+	{
+		int32 slot = Merge(entityID, updateFlags | HAS_POSITION | HAS_PACKED_POSITION, FVector::ZeroVector, positionOffset, updateAngles, isOnGround);
+
+		FMemory::Memcpy(&packedXZs[slot * 3], packedXZ, 3);
+
+		if (packedY)
+			FMemory::Memcpy(&packedYs[slot * 2], packedY, 2);
+		else
+			FMemory::Memzero(&packedYs[slot * 2], 2);
+	}
+
+	int32 VolatileDataBatch::Merge(int32 entityID, uint8 updateFlags, const FVector& position, const FVector& positionOffset, const FVector& updateAngles, int8 isOnGround)
+	{
+		totalUpdates++;
+
+		int32* pSlot = slots_.Find(entityID);
+		if (!pSlot)
+		{
+			int32 slot = entityIDs.Num();
+			slots_.Add(entityID, slot);
+			entityIDs.Add(entityID);
+			flags.Add(updateFlags);
+			positions.Add(position);
+			positionOffsets.Add(positionOffset);
+			angles.Add(updateAngles);
+			onGrounds.Add(isOnGround);
+			packedXZs.AddZeroed(3);
+			packedYs.AddZeroed(2);
+			return slot;
+		}
+
+		mergedUpdates++;
+
+		int32 slot = *pSlot;
+
+		if (updateFlags & HAS_POSITION)
+		{
+			// 新的坐标替换之前的坐标，不论之前的是否是压缩的
+			flags[slot] &= ~HAS_PACKED_POSITION;
+			positions[slot] = position;
+			positionOffsets[slot] = positionOffset;
+		}
+
+		flags[slot] |= updateFlags;
+
+		if (updateFlags & HAS_ROLL)
+			angles[slot].X = updateAngles.X;
+
+		if (updateFlags & HAS_PITCH)
+			angles[slot].Y = updateAngles.Y;
+
+		if (updateFlags & HAS_YAW)
+			angles[slot].Z = updateAngles.Z;
+
+		if (isOnGround >= 0)
+			onGrounds[slot] = isOnGround;
+
+		return slot;
+	}
+
+	void VolatileDataBatch::DecodePackedPositions()
+	{
+		int32 count = Num();
+		if (count == 0)
+			return;
+
+		// 所有实体的压缩数据都是连续存放的，没有压缩坐标的实体数据为0，一起解码比逐个判断更快
+		decodedX_.SetNumUninitialized(count, false);
+		decodedY_.SetNumUninitialized(count, false);
+		decodedZ_.SetNumUninitialized(count, false);
+
+		PackedFloat::DecodeXZ(packedXZs.GetData(), count, decodedX_.GetData(), decodedZ_.GetData());
+		PackedFloat::DecodeY(packedYs.GetData(), count, decodedY_.GetData());
+
+		for (int32 i = 0; i < count; ++i)
+		{
+			if (!(flags[i] & HAS_PACKED_POSITION))
+				continue;
+
+			positions[i] = KBEMath::KBEngine2UnrealPosition(FVector(decodedX_[i], decodedY_[i], decodedZ_[i]));
+			flags[i] &= ~HAS_PACKED_POSITION;
+		}
+	}
+
+	void VolatileDataBatch::Reset()
+	{
+		entityIDs.Reset();
+		flags.Reset();
+		positions.Reset();
+		positionOffsets.Reset();
+		angles.Reset();
+		onGrounds.Reset();
+		packedXZs.Reset();
+		packedYs.Reset();
+		slots_.Reset();
+	}
+}
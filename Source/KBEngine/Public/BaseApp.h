@@ -4,6 +4,8 @@
 #include "KBEDefine.h"
 #include "Core.h"
 #include "MessagesHandler.h"
+#include "EntityMessageBuffer.h"
+#include "VolatileDataBatch.h"
 
 namespace KBEngine
 {
@@ -12,14 +14,15 @@ namespace KBEngine
 	class MessageReader;
 	class Messages;
 	class Entity;
+	class Bundle;
 
 	class KBENGINE_API BaseApp : public MessagesHandler
 	{
 		const static int ADDITIONAL_UPDATE_COUNT = 8;
 
 	public:
-		/* ӻص
-		intĲʾ룬ϢԲοKBEngineApp::serverErrs_
+		/* 连接回调函数
+		int的参数表示错误码，更多的信息可以参考KBEngineApp::serverErrs_
 		*/
 		typedef std::function<void(int32)> ConnectCallbackFunc;
 
@@ -27,55 +30,64 @@ namespace KBEngine
 		BaseApp(KBEngineApp* app);
 		virtual ~BaseApp();
 
-		// ӵ
+		// 连接到服务器
 		void Connect(const FString& host, uint16 tcpPort, uint16 udpPort, ConnectCallbackFunc func);
 
-		// Ͽ
+		// 主动断开网络连接
 		void Disconnect();
 
-		// ǷЧϣ
+		// 检查网络是否有效（连接上）
 		bool NetworkIsValid();
 
-		// ¼
+		// 登录
 		void Login(const FString& account, const FString& password, ConnectCallbackFunc func);
 
 		/*
-		ص¼(baseapp)
-		һЩƶӦ׵ߣʹøùܿٵ˽ͨ
+		重登录到网关(baseapp)
+		一些移动类应用容易掉线，可以使用该功能快速的重新与服务端建立通信
 		*/
 		void Relogin(ConnectCallbackFunc func);
 
 
-		// ¼
+		// 跨服登录
 		void AcrossLogin(FString& accountName, FString& password, CLIENT_TYPE clientType, UINT16 loginKey, ConnectCallbackFunc func);
-		// ¼ɹ
+		// 跨服登录成功
 		void AcrossLoginSuccess();
 
 
-		// ˺
+		// 绑定账号邮箱
 		void BindAccountEmail(const FString& emailAddress, ConnectCallbackFunc func);
 
-		// ޸
+		// 修改密码
 		void NewPassword(const FString& old_password, const FString& new_password, ConnectCallbackFunc func);
 
-		// ÿTickִһ
+		// 每个Tick执行一次
 		void Process();
 
-		// ȡĽɫEntity
+		// 获取玩家自身的角色Entity
 		Entity* Player();
 
-		// ͨentityIDҵӦentityʵ
+		// 通过entityID找到对应的entity实例
 		Entity* FindEntity(int32 entityID);
 
-		// ȡEntityֵ
+		// 获取Entity字典
 		const TMap<int32, Entity*>* Entities() { return &entities_; }
 
-		// KeyȡӦSpaceData
+		// 实体进入世界之前被缓存的属性数据的统计信息
+		const EntityMessageBufferStats& BufferedCreateEntityMessageStats() { return bufferedCreateEntityMessage_.Stats(); }
+
+		// 易变数据批处理的缓存，可以查看累计更新与被合并的条数
+		const VolatileDataBatch& VolatileDataBatchInfo() { return volatileDataBatch_; }
+
+		// 根据Key取相应的SpaceData
 		const FString& GetSpaceData(const FString& key);
 
-		// ԷϢ
-		virtual void HandleMessage(const FString &name, MemoryStream *stream) override;
-		virtual void HandleMessage(const FString &name, const TArray<FVariant> &args) override;
+		// 处理来自服务器的消息
+		virtual void HandleMessage(const Message& msg, MemoryStreamView *stream) override;
+		virtual void HandleMessage(const Message& msg, const TArray<FVariant> &args) override;
+
+		virtual void BindMessage(const Message& msg) override;
+		virtual void UnbindMessages() override;
 
 	public:
 		// for internal
@@ -83,17 +95,31 @@ namespace KBEngine
 		void EntityServerPos(FVector pos) { entityServerPos_ = pos; }
 		Messages* pMessages() { return messages_; }
 		NetworkInterfaceBase* pNetworkInterface() { return networkInterface_; }
-		void OnLoseConnect();  // ʧȥӣϿ
+		void OnLoseConnect();  // 失去与服务器的连接（非主动断开）
 
 		bool IsAcrossServer() { return isAcrossServer_; }
 
+		// 发送一个Bundle
+		// 开启了帧合并(KBEngineArgs::useFrameBundle)时，消息被并入本帧的合并包中，由Process()统一发送
+		void SendBundle(Bundle* bundle);
+
+		// 立即发送帧合并包中积攒的所有消息
+		void FlushFrameBundle();
+
 	private:
 		void UpdatePlayerToServer();
 		void ClearNetwork();
-		MemoryStream* FindBufferedCreateEntityMessage(int32 entityID);
-		int32 GetAoiEntityIDFromStream(MemoryStream &stream);
+		int32 GetAoiEntityIDFromStream(MemoryStreamView &stream);
 		void ClearEntities(bool isall);
 		void ClearSpace(bool isall);
+
+		// 销毁实体，同时维护等待父对象的子对象索引
+		void DestroyEntity(Entity* entity);
+
+		// 父对象还不存在的子对象登记在这里，父对象进入世界时再挂接
+		void AddPendingChild(int32 parentID, int32 childID);
+		void RemovePendingChild(int32 parentID, int32 childID);
+		void AttachPendingChildren(Entity* parent);
 		void SendTick();
 
 
@@ -103,16 +129,16 @@ namespace KBEngine
 		void CmdImportClientMessages();
 		void CmdImportClientEntityDef();
 
-		void Client_onHelloCB(MemoryStream &stream);
-		void Client_onVersionNotMatch(MemoryStream &stream);
-		void Client_onScriptVersionNotMatch(MemoryStream &stream);
-		void Client_onImportClientMessages(MemoryStream &stream);
-		void Client_onImportClientEntityDef(MemoryStream &stream);
+		void Client_onHelloCB(MemoryStreamView &stream);
+		void Client_onVersionNotMatch(MemoryStreamView &stream);
+		void Client_onScriptVersionNotMatch(MemoryStreamView &stream);
+		void Client_onImportClientMessages(MemoryStreamView &stream);
+		void Client_onImportClientEntityDef(MemoryStreamView &stream);
 		
 		void Client_onLoginBaseappFailed(uint16 failedcode);
-		void Client_onLoginBaseappSuccessfully(MemoryStream &stream);
+		void Client_onLoginBaseappSuccessfully(MemoryStreamView &stream);
 		void Client_onReloginBaseappFailed(uint16 failedcode);
-		void Client_onReloginBaseappSuccessfully(MemoryStream &stream);
+		void Client_onReloginBaseappSuccessfully(MemoryStreamView &stream);
 		void Client_onReqAccountBindEmailCB(uint16 failcode);
 		void Client_onReqAccountNewPasswordCB(uint16 failcode);
 
@@ -122,121 +148,149 @@ namespace KBEngine
 		void Client_onCreatedProxies(uint64 rndUUID, int32 eid, FString entityType);
 		void Client_onEntityDestroyed(int32 eid);
 
-		// ͻֵı֪ͨ
-		void Client_onUpdatePropertysOptimized(MemoryStream &stream);
-		void Client_onUpdatePropertys(MemoryStream &stream);
-		void OnUpdatePropertys(int32 eid, MemoryStream& stream);
+		// 客户端属性值改变通知
+		void Client_onUpdatePropertysOptimized(MemoryStreamView &stream);
+		void Client_onUpdatePropertys(MemoryStreamView &stream);
+		void OnUpdatePropertys(int32 eid, MemoryStreamView &stream);
 
-		// ͻԶ̷
-		void Client_onRemoteMethodCallOptimized(MemoryStream &stream);
-		void Client_onRemoteMethodCall(MemoryStream &stream);
-		void OnRemoteMethodCall(int32 eid, MemoryStream& stream);
+		// 客户端远程方法调用
+		void Client_onRemoteMethodCallOptimized(MemoryStreamView &stream);
+		void Client_onRemoteMethodCall(MemoryStreamView &stream);
+		void OnRemoteMethodCall(int32 eid, MemoryStreamView &stream);
 
-		// 롢뿪
-		void Client_onEntityEnterWorld(MemoryStream &stream);
-		void Client_onEntityLeaveWorldOptimized(MemoryStream &stream);
+		// 进入、离开世界
+		void Client_onEntityEnterWorld(MemoryStreamView &stream);
+		void Client_onEntityLeaveWorldOptimized(MemoryStreamView &stream);
 		void Client_onEntityLeaveWorld(int32 eid);
 
-		// 롢뿪ǰͼ
-		void Client_onEntityEnterSpace(MemoryStream &stream);
+		// 进入、离开当前地图
+		void Client_onEntityEnterSpace(MemoryStreamView &stream);
 		void Client_onEntityLeaveSpace(int32 eid);
 
-		// ͼ
+		// 地图数据相关
 		void AddSpaceGeometryMapping(uint32 spaceID, const FString& respath);
-		void Client_initSpaceData(MemoryStream &stream);
+		void Client_initSpaceData(MemoryStreamView &stream);
 		void Client_setSpaceData(uint32 spaceID, const FString& key, const FString& value);
 		void Client_delSpaceData(uint32 spaceID, const FString& key);
 
 		/*
-		˸ҵĻλúͳ ͻλüϱֵΧʵ
+		服务端更新玩家的基础位置和朝向， 客户端以这个基础位置加上便宜值计算出玩家周围实体的坐标
 		*/
 		void Client_onUpdateBasePos(float x, float y, float z);
 		void Client_onUpdateBasePosXZ(float x, float z);
-		void Client_onUpdateBaseDir(MemoryStream &stream);
+		void Client_onUpdateBaseDir(MemoryStreamView &stream);
 
 		/*
-		ǿҵ
-		磺ڷʹavatar.position=(0,0,0), λٶ쳣ʱǿصһλ
+		服务端强制设置了玩家的坐标
+		例如：在服务端使用avatar.position=(0,0,0), 或者玩家位置与速度异常时会强制拉回到一个位置
 		*/
-		void Client_onSetEntityPosAndDir(MemoryStream &stream);
-
-		// ꡢıأŻ߾
-		void Client_onUpdateData(MemoryStream &stream);
-		void Client_onUpdateData_ypr(MemoryStream &stream);
-		void Client_onUpdateData_yp(MemoryStream &stream);
-		void Client_onUpdateData_yr(MemoryStream &stream);
-		void Client_onUpdateData_pr(MemoryStream &stream);
-		void Client_onUpdateData_y(MemoryStream &stream);
-		void Client_onUpdateData_p(MemoryStream &stream);
-		void Client_onUpdateData_r(MemoryStream &stream);
-		void Client_onUpdateData_xz(MemoryStream &stream);
-		void Client_onUpdateData_xz_ypr(MemoryStream &stream);
-		void Client_onUpdateData_xz_yp(MemoryStream &stream);
-		void Client_onUpdateData_xz_yr(MemoryStream &stream);
-		void Client_onUpdateData_xz_pr(MemoryStream &stream);
-		void Client_onUpdateData_xz_y(MemoryStream &stream);
-		void Client_onUpdateData_xz_p(MemoryStream &stream);
-		void Client_onUpdateData_xz_r(MemoryStream &stream);
-		void Client_onUpdateData_xyz(MemoryStream &stream);
-		void Client_onUpdateData_xyz_ypr(MemoryStream &stream);
-		void Client_onUpdateData_xyz_yp(MemoryStream &stream);
-		void Client_onUpdateData_xyz_yr(MemoryStream &stream);
-		void Client_onUpdateData_xyz_pr(MemoryStream &stream);
-		void Client_onUpdateData_xyz_y(MemoryStream &stream);
-		void Client_onUpdateData_xyz_p(MemoryStream &stream);
-		void Client_onUpdateData_xyz_r(MemoryStream &stream);
-
-		// ꡢıأݱŻѹ
-		void Client_onUpdateData_optimized(MemoryStream &stream);
-		void Client_onUpdateData_ypr_optimized(MemoryStream &stream);
-		void Client_onUpdateData_yp_optimized(MemoryStream &stream);
-		void Client_onUpdateData_yr_optimized(MemoryStream &stream);
-		void Client_onUpdateData_pr_optimized(MemoryStream &stream);
-		void Client_onUpdateData_y_optimized(MemoryStream &stream);
-		void Client_onUpdateData_p_optimized(MemoryStream &stream);
-		void Client_onUpdateData_r_optimized(MemoryStream &stream);
-		void Client_onUpdateData_xz_optimized(MemoryStream &stream);
-		void Client_onUpdateData_xz_ypr_optimized(MemoryStream &stream);
-		void Client_onUpdateData_xz_yp_optimized(MemoryStream &stream);
-		void Client_onUpdateData_xz_yr_optimized(MemoryStream &stream);
-		void Client_onUpdateData_xz_pr_optimized(MemoryStream &stream);
-		void Client_onUpdateData_xz_y_optimized(MemoryStream &stream);
-		void Client_onUpdateData_xz_p_optimized(MemoryStream &stream);
-		void Client_onUpdateData_xz_r_optimized(MemoryStream &stream);
-		void Client_onUpdateData_xyz_optimized(MemoryStream &stream);
-		void Client_onUpdateData_xyz_ypr_optimized(MemoryStream &stream);
-		void Client_onUpdateData_xyz_yp_optimized(MemoryStream &stream);
-		void Client_onUpdateData_xyz_yr_optimized(MemoryStream &stream);
-		void Client_onUpdateData_xyz_pr_optimized(MemoryStream &stream);
-		void Client_onUpdateData_xyz_y_optimized(MemoryStream &stream);
-		void Client_onUpdateData_xyz_p_optimized(MemoryStream &stream);
-		void Client_onUpdateData_xyz_r_optimized(MemoryStream &stream);
+		void Client_onSetEntityPosAndDir(MemoryStreamView &stream);
+
+		// 坐标、朝向改变相关，非优化高精度
+		void Client_onUpdateData(MemoryStreamView &stream);
+		void Client_onUpdateData_ypr(MemoryStreamView &stream);
+		void Client_onUpdateData_yp(MemoryStreamView &stream);
+		void Client_onUpdateData_yr(MemoryStreamView &stream);
+		void Client_onUpdateData_pr(MemoryStreamView &stream);
+		void Client_onUpdateData_y(MemoryStreamView &stream);
+		void Client_onUpdateData_p(MemoryStreamView &stream);
+		void Client_onUpdateData_r(MemoryStreamView &stream);
+		void Client_onUpdateData_xz(MemoryStreamView &stream);
+		void Client_onUpdateData_xz_ypr(MemoryStreamView &stream);
+		void Client_onUpdateData_xz_yp(MemoryStreamView &stream);
+		void Client_onUpdateData_xz_yr(MemoryStreamView &stream);
+		void Client_onUpdateData_xz_pr(MemoryStreamView &stream);
+		void Client_onUpdateData_xz_y(MemoryStreamView &stream);
+		void Client_onUpdateData_xz_p(MemoryStreamView &stream);
+		void Client_onUpdateData_xz_r(MemoryStreamView &stream);
+		void Client_onUpdateData_xyz(MemoryStreamView &stream);
+		void Client_onUpdateData_xyz_ypr(MemoryStreamView &stream);
+		void Client_onUpdateData_xyz_yp(MemoryStreamView &stream);
+		void Client_onUpdateData_xyz_yr(MemoryStreamView &stream);
+		void Client_onUpdateData_xyz_pr(MemoryStreamView &stream);
+		void Client_onUpdateData_xyz_y(MemoryStreamView &stream);
+		void Client_onUpdateData_xyz_p(MemoryStreamView &stream);
+		void Client_onUpdateData_xyz_r(MemoryStreamView &stream);
+
+		// 坐标、朝向改变相关，数据被优化压缩
+		void Client_onUpdateData_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_ypr_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_yp_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_yr_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_pr_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_y_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_p_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_r_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_xz_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_xz_ypr_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_xz_yp_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_xz_yr_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_xz_pr_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_xz_y_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_xz_p_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_xz_r_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_xyz_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_xyz_ypr_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_xyz_yp_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_xyz_yr_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_xyz_pr_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_xyz_y_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_xyz_p_optimized(MemoryStreamView &stream);
+		void Client_onUpdateData_xyz_r_optimized(MemoryStreamView &stream);
 		void UpdateVolatileData(int32 entityID, float x, float y, float z, float yaw, float pitch, float roll, int8 isOnGround, bool isOptimized);
 
-		// 
+		// 优化协议中压缩的坐标：packedXZ为3个字节，packedY为2个字节，没有Y时为nullptr
+		void UpdatePackedVolatileData(int32 entityID, const uint8* packedXZ, const uint8* packedY, float yaw, float pitch, float roll, int8 isOnGround);
+
+		// 把收到的朝向转换为角度，返回VolatileDataBatch::Flags中朝向相关的标记
+		uint8 DecodeVolatileAngles(float yaw, float pitch, float roll, bool isOptimized, FVector& angles);
+
+		// 把解码后的易变数据应用到实体上，坐标或朝向发生了改变时返回true
+		bool ApplyVolatileData(Entity* entity, uint8 flags, FVector pos, const FVector& posOffset, const FVector& angles, int8 isOnGround);
+
+		// 应用本帧积攒的易变数据（KBEngineArgs::useVolatileDataBatch）
+		void ApplyVolatileDataBatch();
+
+		// 根据快照计算所有实体本帧的插值坐标与朝向（KBEngineArgs::useInterpolation）
+		void InterpolateEntities();
+
+		// 处理该消息之前是否需要先应用本帧积攒的易变数据
+		FORCEINLINE bool IsVolatileFlushMessage(uint16 msgid) const { return msgid < volatileFlushMessages_.Num() && volatileFlushMessages_[msgid]; }
+
+		// 数据流接收相关
 		void Client_onStreamDataStarted(int16 id, uint32 datasize, const FString& descr);
-		void Client_onStreamDataRecv(MemoryStream &stream);
+		void Client_onStreamDataRecv(MemoryStreamView &stream);
 		void Client_onStreamDataCompleted(int16 id);
 
-		// ֪ͨͻˣĳentityparentı
+		// 服务器通知客户端：某个entity的parent改变了
 		void Client_onParentChanged(int32 eid, int32 parentID);
 
-		// ׼ϣԵ¼
-		void Client_acrossServerReady(MemoryStream &stream);
+		// 跨服准备完毕，可以登录了
+		void Client_acrossServerReady(MemoryStreamView &stream);
 
 		bool NeedAdditionalUpdate(Entity *entity);
 		void ResetAdditionalUpdateCount();
 		bool PlayerNeedUpdate(Entity *entity, bool moveChanged);
 
+		// 需要同步时把实体的坐标与朝向写入bundle，返回是否写入了
+		bool WriteVolatileDataToServer(Bundle* bundle, Entity* entity, bool isPlayer, double time);
+
 	private:
 		KBEngineApp* app_ = nullptr;
 
-		// Ϣ
+		// 消息处理器
 		MessageReader *messageReader_ = nullptr;
 
-		// Ϣִ
+		// 消息处执行器
 		Messages *messages_ = nullptr;
 
+		// 按消息ID索引的消息派发表
+		typedef MessageDispatchTable<BaseApp> DispatchTable;
+		DispatchTable dispatchTable_;
+
+		// 消息名到处理函数的映射
+		static const DispatchTable::HandlerMap& MessageHandlers();
+
 		NetworkInterfaceBase* networkInterface_ = nullptr;
 
 		FString host_;
@@ -244,53 +298,72 @@ namespace KBEngine
 		uint16 baseappUdpPort_;
 		ConnectCallbackFunc connectedCallbackFunc_;
 
-		// ǰҵʵidʵ
+		// 当前玩家的实体id与实体类别
 		uint64 entity_uuid_ = 0;
 		int32 entity_id_ = 0;
 		FString entity_type_ = "";
 
-		// ¼ʱ˺Ϣ
+		// 登录时的账号密码等信息
 		FString account_;
 		FString password_;
 
-		// spaceݣ忴APIֲspaceData
+		// space的数据，具体看API手册关于spaceData
 		// https://github.com/kbengine/kbengine/tree/master/docs/api
 		TMap<FString, FString> spaceDatas_;
 
-		// ʵ嶼 οAPIֲentities
+		// 所有实体都保存于这里， 请参看API手册关于entities部分
 		// https://github.com/kbengine/kbengine/tree/master/docs/api
 		TMap<int32, Entity*> entities_;
 
-		// AOIΧС256ʵʱǿͨһֽҵentity
+		// 在玩家AOI范围小于256个实体时我们可以通过一字节索引来找到entity
 		TArray<int32> entityIDAliasIDList_;
 
-		// controlledByм¼ıؿͻ˿ƵEntityԼ⣩
+		// controlledBy机制中记录的被本地客户端控制的Entity（自己除外）
 		TArray<Entity *> controlledEntities_;
 
-		TMap<int32, MemoryStream*> bufferedCreateEntityMessage_;
+		// 实体进入世界之前收到的属性数据
+		EntityMessageBuffer bufferedCreateEntityMessage_;
 
-		// ҵǰڿռid ԼռӦԴ
+		// 本帧积攒的易变数据，以及应用后发生了改变的实体
+		VolatileDataBatch volatileDataBatch_;
+		TArray<Entity*> volatileUpdatedEntities_;
+
+		// 以消息ID为下标，标记哪些消息会读取或替换实体的坐标与朝向、或者创建与销毁实体，
+		// 处理这些消息之前需要先应用本帧积攒的易变数据，其它消息都留到Process中统一应用
+		TArray<bool> volatileFlushMessages_;
+
+		// 父对象ID => 正在等待该父对象出现的子对象ID列表
+		TMap<int32, TArray<int32>> pendingChildren_;
+
+		// 玩家当前所在空间的id， 以及空间对应的资源
 		uint32 spaceID_ = 0;
 		FString spaceResPath_ = "";
 		bool isLoadedGeometry_ = false;
 
-		// ǰһͬλ
+		// 当前服务端最后一次同步过来的玩家位置
 		FVector entityServerPos_ = FVector::ZeroVector;
 
-		// һʱ䡢һյظʱ
-		// ΪǷߵж
+		// 最后一次心跳发送时间、最后一次收到心跳回复的时间
+		// 用于作为是否断线的判断依据
 		FDateTime lastTicktime_ = FDateTime::UtcNow();
 		FDateTime lastTickCBTime_ = FDateTime::UtcNow();
 
-		// һͬꡢʱ䣬ڿͬƵ
-		FDateTime lastUpdateToServerTime_ = FDateTime::UtcNow();
+		// 最后一次同步坐标、朝向给服务器的时间（FPlatformTime::Seconds），用于控制同步频率
+		double lastUpdateToServerTime_ = 0.0;
 		
-		// ֹͣƶ󣬶ͬλóĴ
+		// 玩家停止移动后，额外向服务端同步位置朝向的次数
 		uint8 additionalUpdateCount_ = BaseApp::ADDITIONAL_UPDATE_COUNT;
 		
-		// Ƿ
+		// 是否跨服中
 		bool isAcrossServer_ = false;
 
+		// 同步坐标、朝向给服务器时使用的包，重复使用以避免每次分配
+		Bundle* syncBundle_ = nullptr;
+
+		// 帧合并包，以及其中第一条消息的写入时间
+		Bundle* frameBundle_ = nullptr;
+		double frameBundleStartTime_ = 0.0;
+
 	};  // end of class BaseApp;
 
 
@@ -23,7 +23,24 @@ namespace KBEngine
 
 		void CheckStream(int v);
 
+		// 把other中已经写完的消息(数据流块)转移到本Bundle的待发送列表末尾，不产生内存复制
+		// 用于把多个Bundle合并到一次发送中
+		void Absorb(Bundle *other);
+
+		// 已经写完、等待发送的字节数
+		uint32 PendingLength() const { return pendingLength_; }
+
+		// 丢弃所有已写完但未发送的消息
+		void Discard();
+
 		//---------------------------------------------------------------------------------
+		template <typename T>
+		void Write(T v)
+		{
+			CheckStream(sizeof(T));
+			stream_->Append<T>(v);
+		}
+
 		void WriteInt8(int8 v)
 		{
 			CheckStream(1);
@@ -102,9 +119,9 @@ namespace KBEngine
 		{
 			FTCHARToUTF8 utf8(*v);
 			
-			//                 |-   -| |-  ->
-			// BLOBʽ00 00 00 00 xx xx xx xx xx ...
-			// Ҫ4ֽڳ
+			//                 |- 长度  -| |- 数据流 ->
+			// BLOB数据流格式：00 00 00 00 xx xx xx xx xx ...
+			// 所以需要加4个字节长度
 			CheckStream(utf8.Length() + 4);
 			stream_->WriteBlob(utf8.Get(), utf8.Length());
 		}
@@ -121,6 +138,14 @@ namespace KBEngine
 			stream_->WriteBlob(bytes);
 		}
 
+		// 一次写入num个定长的基础类型数据（不含长度）
+		template <typename T>
+		void WriteArray(const T *values, int32 num)
+		{
+			CheckStream(num * sizeof(T));
+			stream_->Append((const uint8 *)values, num * sizeof(T));
+		}
+
 	protected:
 		MemoryStream *stream_;
 		TArray<MemoryStream *> streamList_;
@@ -128,6 +153,7 @@ namespace KBEngine
 		int messageLength_ = 0;
 		const Message *msgType_ = nullptr;
 		int curMsgStreamIndex_ = 0;
+		uint32 pendingLength_ = 0;
 	};
 }
 
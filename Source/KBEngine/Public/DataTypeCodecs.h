@@ -0,0 +1,117 @@
+#pragma once
+
+#include <type_traits>
+
+#include "MemoryStream.h"
+#include "Bundle.h"
+
+namespace KBEngine
+{
+	/*
+	DataTypePlan中的操作码，每种可以直接解码的数据类型对应一个
+	*/
+	enum class EKBEPlanOp : uint8
+	{
+		Int8,
+		Int16,
+		Int32,
+		Int64,
+		UInt8,
+		UInt16,
+		UInt32,
+		UInt64,
+		Float,
+		Double,
+		Vector2,
+		Vector3,
+		Vector4,
+		String,
+		Unicode,
+		Blob,
+		Array,
+		FixedDict,
+
+		// 交给数据类型的CreateFromStream处理
+		Generic,
+	};
+
+	template <class T> struct TKBEPrimitivePlanOp;
+	template <> struct TKBEPrimitivePlanOp<int8>   { static const EKBEPlanOp Value = EKBEPlanOp::Int8; };
+	template <> struct TKBEPrimitivePlanOp<int16>  { static const EKBEPlanOp Value = EKBEPlanOp::Int16; };
+	template <> struct TKBEPrimitivePlanOp<int32>  { static const EKBEPlanOp Value = EKBEPlanOp::Int32; };
+	template <> struct TKBEPrimitivePlanOp<int64>  { static const EKBEPlanOp Value = EKBEPlanOp::Int64; };
+	template <> struct TKBEPrimitivePlanOp<uint8>  { static const EKBEPlanOp Value = EKBEPlanOp::UInt8; };
+	template <> struct TKBEPrimitivePlanOp<uint16> { static const EKBEPlanOp Value = EKBEPlanOp::UInt16; };
+	template <> struct TKBEPrimitivePlanOp<uint32> { static const EKBEPlanOp Value = EKBEPlanOp::UInt32; };
+	template <> struct TKBEPrimitivePlanOp<uint64> { static const EKBEPlanOp Value = EKBEPlanOp::UInt64; };
+	template <> struct TKBEPrimitivePlanOp<float>  { static const EKBEPlanOp Value = EKBEPlanOp::Float; };
+	template <> struct TKBEPrimitivePlanOp<double> { static const EKBEPlanOp Value = EKBEPlanOp::Double; };
+
+	/*
+	定长数值类型的编解码
+	*/
+	template <class T>
+	struct TKBEPrimitiveCodec
+	{
+		typedef T ValueType;
+
+		static constexpr uint32 WIRE_SIZE = sizeof(T);
+		static constexpr bool PRIMITIVE = true;
+		static const EKBEPlanOp PLAN_OP = TKBEPrimitivePlanOp<T>::Value;
+
+		FORCEINLINE static T Read(MemoryStreamView& stream) { return stream.Read<T>(); }
+		FORCEINLINE static void Write(Bundle& bundle, T value) { bundle.Write<T>(value); }
+
+		static T Parse(const FString& s) { return Parse(s, std::integral_constant<int, std::is_floating_point<T>::value ? 2 : (std::is_signed<T>::value ? 1 : 0)>()); }
+
+	private:
+		static T Parse(const FString& s, std::integral_constant<int, 0>)
+		{
+			TCHAR *pEnd = nullptr;
+			return (T)FCString::Strtoui64(*s, &pEnd, 10);
+		}
+
+		static T Parse(const FString& s, std::integral_constant<int, 1>) { return (T)FCString::Atoi64(*s); }
+		static T Parse(const FString& s, std::integral_constant<int, 2>) { return (T)FCString::Atod(*s); }
+	};
+
+	template <int32 N> struct TKBEVectorType;
+	template <> struct TKBEVectorType<2> { typedef FVector2D Type; static const EKBEPlanOp PLAN_OP = EKBEPlanOp::Vector2; };
+	template <> struct TKBEVectorType<3> { typedef FVector Type; static const EKBEPlanOp PLAN_OP = EKBEPlanOp::Vector3; };
+	template <> struct TKBEVectorType<4> { typedef FVector4 Type; static const EKBEPlanOp PLAN_OP = EKBEPlanOp::Vector4; };
+
+	/*
+	N个float组成的向量的编解码
+	*/
+	template <int32 N>
+	struct TKBEVectorCodec
+	{
+		typedef typename TKBEVectorType<N>::Type ValueType;
+
+		static constexpr uint32 WIRE_SIZE = N * sizeof(float);
+		static constexpr bool PRIMITIVE = false;
+		static const EKBEPlanOp PLAN_OP = TKBEVectorType<N>::PLAN_OP;
+
+		FORCEINLINE static ValueType Read(MemoryStreamView& stream)
+		{
+			ValueType value;
+			for (int32 i = 0; i < N; ++i)
+				value[i] = stream.ReadFloat();
+			return value;
+		}
+
+		FORCEINLINE static void Write(Bundle& bundle, const ValueType& value)
+		{
+			for (int32 i = 0; i < N; ++i)
+				bundle.Write<float>(value[i]);
+		}
+
+		static ValueType Parse(const FString& s)
+		{
+			ValueType value;
+			for (int32 i = 0; i < N; ++i)
+				value[i] = 0.f;
+			return value;
+		}
+	};
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "DataTypeCodecs.h"
+
+namespace KBEngine
+{
+	class KBEDATATYPE_BASE;
+
+	/*
+	数据类型的解码计划
+	把一个数据类型（包括ARRAY、FIXED_DICT嵌套的子类型）展开成一个扁平的操作列表，
+	解码时顺序执行这些操作，定长数值、向量、字符串等类型直接内联解码，不再经过每个值一次的虚函数调用。
+	由ScriptModule为每个实体定义的属性编译一次
+	*/
+	class KBENGINE_API DataTypePlan
+	{
+	public:
+		struct Op
+		{
+			EKBEPlanOp code = EKBEPlanOp::Generic;
+
+			// Array：元素子计划的操作数量；FixedDict：字段数量
+			int32 arg = 0;
+
+			// Array、FixedDict、Generic对应的数据类型
+			KBEDATATYPE_BASE* type = nullptr;
+		};
+
+		// 根据数据类型编译计划，之前的计划会被清空
+		void Compile(KBEDATATYPE_BASE* type);
+
+		FORCEINLINE bool IsValid() const { return ops_.Num() > 0; }
+
+		FVariant Decode(MemoryStreamView& stream) const;
+
+		// 供各数据类型的CompilePlan使用，返回新操作的下标
+		int32 Add(EKBEPlanOp code, KBEDATATYPE_BASE* type = nullptr, int32 arg = 0);
+
+		FORCEINLINE int32 Num() const { return ops_.Num(); }
+		FORCEINLINE Op& operator[](int32 index) { return ops_[index]; }
+
+	private:
+		FVariant Run(int32& pc, MemoryStreamView& stream) const;
+
+	private:
+		TArray<Op> ops_;
+	};
+}
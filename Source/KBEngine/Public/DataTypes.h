@@ -1,8 +1,12 @@
 #pragma once
 
+#include <limits>
+#include <type_traits>
+
 #include "KBEDebug.h"
 #include "MemoryStream.h"
 #include "Bundle.h"
+#include "DataTypePlan.h"
 
 namespace KBEngine
 {
@@ -14,346 +18,301 @@ namespace KBEngine
 		static bool IsNumeric(const FVariant &v);
 		static double ToNumber(const FVariant &v);
 
+		/*
+		把数值类型的FVariant转换为T，不经过double，64位整数不会丢失精度
+		值超出T的范围，或者把带小数的浮点数转换为整数时返回false
+		*/
+		template <class T>
+		static bool ConvertNumber(const FVariant &v, T &out)
+		{
+			return ConvertNumber(v, out, std::is_floating_point<T>());
+		}
+
 		virtual const TCHAR *TypeString() const = 0;
 
 		virtual void Bind() {}
-		virtual FVariant CreateFromStream(MemoryStream *stream) = 0;
+		virtual FVariant CreateFromStream(MemoryStreamView *stream) = 0;
 		virtual void AddToStream(Bundle *stream, const FVariant &v) = 0;
 		virtual FVariant ParseDefaultValStr(const FString& s) = 0;
 		virtual bool IsSameType(const FVariant &v) = 0;
-	};
-
-	class KBENGINE_API KBEDATATYPE_INT8 : public KBEDATATYPE_BASE
-	{
-	public:
-		virtual const TCHAR *TypeString() const override
-		{
-			return TEXT("KBEDATATYPE_INT8");
-		}
 
-		FVariant CreateFromStream(MemoryStream *stream) override
+		/*
+		检查类型并写入数据流，只遍历一次值；类型不符时返回false，此时数据流中可能已经写入了一部分数据
+		默认实现为IsSameType + AddToStream，容器类型重写以避免把值从FVariant中取出两次
+		*/
+		virtual bool AddToStreamChecked(Bundle *stream, const FVariant &v)
 		{
-			return FVariant(stream->ReadInt8());
-		}
+			if (!IsSameType(v))
+				return false;
 
-		void AddToStream(Bundle *stream, const FVariant &v) override
-		{
-			stream->WriteInt8(v.GetValue<int8>());
+			AddToStream(stream, v);
+			return true;
 		}
 
-		FVariant ParseDefaultValStr(const FString& s) override
-		{
-			return (int8)FCString::Atoi(*s);
-		}
+		// 字符串类型在数据流中以UTF-8编码
+		virtual bool IsUnicode() const { return false; }
 
-		bool IsSameType(const FVariant &v) override
-		{
-			if (!KBEDATATYPE_BASE::IsNumeric(v))
-				return false;
+		// 定长的基础数值类型返回解码出的FVariant的类型，ARRAY据此选择整块读写的方式；其它类型返回EVariantTypes::Empty
+		virtual EVariantTypes PrimitiveType() const { return EVariantTypes::Empty; }
 
-			double n = KBEDATATYPE_BASE::ToNumber(v);
-			return n >= INT8_MIN && n <= INT8_MAX;
-		}
-	};
+		// ARRAY的元素类型，其它类型返回nullptr
+		virtual KBEDATATYPE_BASE* ElementType() const { return nullptr; }
 
-	class KBENGINE_API KBEDATATYPE_INT16 : public KBEDATATYPE_BASE
-	{
-	public:
-		virtual const TCHAR *TypeString() const override
-		{
-			return TEXT("KBEDATATYPE_INT16");
-		}
+		// 把本类型的解码操作添加到计划中，默认交给CreateFromStream处理
+		virtual void CompilePlan(DataTypePlan& plan) { plan.Add(EKBEPlanOp::Generic, this); }
 
-		FVariant CreateFromStream(MemoryStream *stream) override
-		{
-			return FVariant(stream->ReadInt16());
-		}
+		// 数据流中的编码方式，直接读入C++类型之前据此检查声明的类型；没有对应操作码的类型返回EKBEPlanOp::Generic
+		virtual EKBEPlanOp WireOp() const { return EKBEPlanOp::Generic; }
 
-		void AddToStream(Bundle *stream, const FVariant &v) override
-		{
-			stream->WriteInt16(v.GetValue<int16>());
-		}
+	private:
+		// 整数类型（包括bool与字符）的值，negative为true时bits中是int64，否则是uint64；不是整数类型时返回false
+		static bool ToInteger(const FVariant &v, uint64 &bits, bool &negative);
 
-		FVariant ParseDefaultValStr(const FString& s) override
+		template <class T>
+		static bool ConvertNumber(const FVariant &v, T &out, std::true_type)
 		{
-			return (int16)FCString::Atoi(*s);
-		}
+			if (!IsNumeric(v))
+				return false;
 
-		bool IsSameType(const FVariant &v) override
-		{
-			if (!KBEDATATYPE_BASE::IsNumeric(v))
+			double n = ToNumber(v);
+			if (!(n >= (double)TNumericLimits<T>::Lowest() && n <= (double)TNumericLimits<T>::Max()))
 				return false;
 
-			double n = KBEDATATYPE_BASE::ToNumber(v);
-			return n >= INT16_MIN && n <= INT16_MAX;
+			out = (T)n;
+			return true;
 		}
-	};
 
-	class KBENGINE_API KBEDATATYPE_INT32 : public KBEDATATYPE_BASE
-	{
-	public:
-		virtual const TCHAR *TypeString() const override
+		template <class T>
+		static bool ConvertNumber(const FVariant &v, T &out, std::false_type)
 		{
-			return TEXT("KBEDATATYPE_INT32");
-		}
+			uint64 bits = 0;
+			bool negative = false;
+			if (ToInteger(v, bits, negative))
+			{
+				if (negative)
+				{
+					if (!std::is_signed<T>::value || (int64)bits < (int64)TNumericLimits<T>::Lowest())
+						return false;
 
-		FVariant CreateFromStream(MemoryStream *stream) override
-		{
-			return FVariant(stream->ReadInt32());
-		}
+					out = (T)(int64)bits;
+					return true;
+				}
 
-		void AddToStream(Bundle *stream, const FVariant &v) override
-		{
-			stream->WriteInt32(v.GetValue<int32>());
-		}
+				if (bits > (uint64)TNumericLimits<T>::Max())
+					return false;
 
-		FVariant ParseDefaultValStr(const FString& s) override
-		{
-			return (int32)FCString::Atoi(*s);
-		}
+				out = (T)bits;
+				return true;
+			}
 
-		bool IsSameType(const FVariant &v) override
-		{
-			if (!KBEDATATYPE_BASE::IsNumeric(v))
+			if (v.GetType() != EVariantTypes::Float && v.GetType() != EVariantTypes::Double)
+				return false;
+
+			// 上界2^digits不能写成(double)Max()，64位时它会被舍入为2^64（2^63），转换时越界
+			double n = ToNumber(v);
+			const double upper = FMath::Pow(2.0, (double)std::numeric_limits<T>::digits);
+			const double lower = std::is_signed<T>::value ? -upper : 0.0;
+			if (n != FMath::FloorToDouble(n) || n < lower || n >= upper)
 				return false;
 
-			double n = KBEDATATYPE_BASE::ToNumber(v);
-			return n >= INT32_MIN && n <= INT32_MAX;
+			out = (T)n;
+			return true;
 		}
 	};
 
-	class KBENGINE_API KBEDATATYPE_INT64 : public KBEDATATYPE_BASE
+	/*
+	以编解码器实现的数据类型，原有的虚函数接口只是对编解码器的一层转发
+	*/
+	template <class Codec>
+	class TKBEDataTypeCodec : public KBEDATATYPE_BASE
 	{
 	public:
-		virtual const TCHAR *TypeString() const override
-		{
-			return TEXT("KBEDATATYPE_INT64");
-		}
+		typedef typename Codec::ValueType ValueType;
 
-		FVariant CreateFromStream(MemoryStream *stream) override
+		FVariant CreateFromStream(MemoryStreamView *stream) override
 		{
-			return FVariant(stream->ReadInt64());
+			return FVariant(Codec::Read(*stream));
 		}
 
 		void AddToStream(Bundle *stream, const FVariant &v) override
 		{
-			stream->WriteInt64(v.GetValue<int64>());
+			Codec::Write(*stream, v.GetValue<ValueType>());
 		}
 
 		FVariant ParseDefaultValStr(const FString& s) override
 		{
-			return (int64)FCString::Atoi64(*s);
+			return FVariant(Codec::Parse(s));
 		}
 
 		bool IsSameType(const FVariant &v) override
 		{
-			if (!KBEDATATYPE_BASE::IsNumeric(v))
-				return false;
-
-			double n = KBEDATATYPE_BASE::ToNumber(v);
-			return n >= INT64_MIN && n <= INT64_MAX;
+			return IsSameType(v, TypeCheckTag());
 		}
-	};
 
-	class KBENGINE_API KBEDATATYPE_UINT8 : public KBEDATATYPE_BASE
-	{
-	public:
-		virtual const TCHAR *TypeString() const override
+		bool AddToStreamChecked(Bundle *stream, const FVariant &v) override
 		{
-			return TEXT("KBEDATATYPE_UINT8");
+			if (v.GetType() == TVariantTraits<ValueType>::GetType())
+			{
+				Codec::Write(*stream, v.GetValue<ValueType>());
+				return true;
+			}
+
+			return AddConvertedToStream(stream, v, std::integral_constant<bool, Codec::PRIMITIVE>());
 		}
 
-		FVariant CreateFromStream(MemoryStream *stream) override
+		EVariantTypes PrimitiveType() const override
 		{
-			return FVariant(stream->ReadUint8());
+			return Codec::PRIMITIVE ? TVariantTraits<ValueType>::GetType() : EVariantTypes::Empty;
 		}
 
-		void AddToStream(Bundle *stream, const FVariant &v) override
+		void CompilePlan(DataTypePlan& plan) override
 		{
-			stream->WriteUint8(v.GetValue<uint8>());
+			plan.Add(Codec::PLAN_OP, this);
 		}
 
-		FVariant ParseDefaultValStr(const FString& s) override
+		EKBEPlanOp WireOp() const override
 		{
-			return (uint8)FCString::Atoi(*s);
+			return Codec::PLAN_OP;
 		}
 
-		bool IsSameType(const FVariant &v) override
+	private:
+		typedef std::integral_constant<int, !Codec::PRIMITIVE ? 0 : (std::is_floating_point<ValueType>::value ? 2 : 1)> TypeCheckTag;
+
+		// 数值类型允许其它数值类型的值，只要在范围内，写入时转换
+		static bool AddConvertedToStream(Bundle *stream, const FVariant &v, std::true_type)
 		{
-			if (!KBEDATATYPE_BASE::IsNumeric(v))
+			ValueType value;
+			if (!Convert(v, value, TypeCheckTag()))
 				return false;
 
-			double n = KBEDATATYPE_BASE::ToNumber(v);
-			return n >= 0 && n <= UINT8_MAX;
+			Codec::Write(*stream, value);
+			return true;
 		}
-	};
 
-	class KBENGINE_API KBEDATATYPE_UINT16 : public KBEDATATYPE_BASE
-	{
-	public:
-		virtual const TCHAR *TypeString() const override
+		static bool AddConvertedToStream(Bundle *stream, const FVariant &v, std::false_type)
 		{
-			return TEXT("KBEDATATYPE_UINT16");
+			return false;
 		}
 
-		FVariant CreateFromStream(MemoryStream *stream) override
+		// 向量：类型必须一致
+		static bool IsSameType(const FVariant &v, std::integral_constant<int, 0>)
 		{
-			return FVariant(stream->ReadUint16());
+			return v.GetType() == TVariantTraits<ValueType>::GetType();
 		}
 
-		void AddToStream(Bundle *stream, const FVariant &v) override
+		// 整数与浮点数：能够转换为ValueType即可
+		template <int Tag>
+		static bool IsSameType(const FVariant &v, std::integral_constant<int, Tag> tag)
 		{
-			stream->WriteUint16(v.GetValue<uint16>());
+			ValueType value;
+			return Convert(v, value, tag);
 		}
 
-		FVariant ParseDefaultValStr(const FString& s) override
+		// 整数：任何整数类型，或者没有小数部分的浮点数，只要在范围内；64位整数不经过double，不会丢失精度
+		static bool Convert(const FVariant &v, ValueType &out, std::integral_constant<int, 1>)
 		{
-			return (uint16)FCString::Atoi(*s);
+			return KBEDATATYPE_BASE::ConvertNumber(v, out);
 		}
 
-		bool IsSameType(const FVariant &v) override
+		// 浮点数：必须是浮点类型，并且在范围内
+		static bool Convert(const FVariant &v, ValueType &out, std::integral_constant<int, 2>)
 		{
-			if (!KBEDATATYPE_BASE::IsNumeric(v))
+			if (v.GetType() != EVariantTypes::Float &&
+				v.GetType() != EVariantTypes::Double)
 				return false;
 
-			double n = KBEDATATYPE_BASE::ToNumber(v);
-			return n >= 0 && n <= UINT16_MAX;
+			return KBEDATATYPE_BASE::ConvertNumber(v, out);
 		}
 	};
 
-	class KBENGINE_API KBEDATATYPE_UINT32 : public KBEDATATYPE_BASE
+	class KBENGINE_API KBEDATATYPE_INT8 : public TKBEDataTypeCodec<TKBEPrimitiveCodec<int8>>
 	{
 	public:
 		virtual const TCHAR *TypeString() const override
 		{
-			return TEXT("KBEDATATYPE_UINT32");
-		}
-
-		FVariant CreateFromStream(MemoryStream *stream) override
-		{
-			return FVariant(stream->ReadUint32());
-		}
-
-		void AddToStream(Bundle *stream, const FVariant &v) override
-		{
-			stream->WriteUint32(v.GetValue<uint32>());
+			return TEXT("KBEDATATYPE_INT8");
 		}
+	};
 
-		FVariant ParseDefaultValStr(const FString& s) override
+	class KBENGINE_API KBEDATATYPE_INT16 : public TKBEDataTypeCodec<TKBEPrimitiveCodec<int16>>
+	{
+	public:
+		virtual const TCHAR *TypeString() const override
 		{
-			return (uint32)FCString::Atoi64(*s);
+			return TEXT("KBEDATATYPE_INT16");
 		}
+	};
 
-		bool IsSameType(const FVariant &v) override
+	class KBENGINE_API KBEDATATYPE_INT32 : public TKBEDataTypeCodec<TKBEPrimitiveCodec<int32>>
+	{
+	public:
+		virtual const TCHAR *TypeString() const override
 		{
-			if (!KBEDATATYPE_BASE::IsNumeric(v))
-				return false;
-
-			double n = KBEDATATYPE_BASE::ToNumber(v);
-			return n >= 0 && n <= UINT32_MAX;
+			return TEXT("KBEDATATYPE_INT32");
 		}
 	};
 
-	class KBENGINE_API KBEDATATYPE_UINT64 : public KBEDATATYPE_BASE
+	class KBENGINE_API KBEDATATYPE_INT64 : public TKBEDataTypeCodec<TKBEPrimitiveCodec<int64>>
 	{
 	public:
 		virtual const TCHAR *TypeString() const override
 		{
-			return TEXT("KBEDATATYPE_UINT64");
+			return TEXT("KBEDATATYPE_INT64");
 		}
+	};
 
-		FVariant CreateFromStream(MemoryStream *stream) override
+	class KBENGINE_API KBEDATATYPE_UINT8 : public TKBEDataTypeCodec<TKBEPrimitiveCodec<uint8>>
+	{
+	public:
+		virtual const TCHAR *TypeString() const override
 		{
-			return FVariant(stream->ReadUint64());
+			return TEXT("KBEDATATYPE_UINT8");
 		}
+	};
 
-		void AddToStream(Bundle *stream, const FVariant &v) override
+	class KBENGINE_API KBEDATATYPE_UINT16 : public TKBEDataTypeCodec<TKBEPrimitiveCodec<uint16>>
+	{
+	public:
+		virtual const TCHAR *TypeString() const override
 		{
-			stream->WriteUint64(v.GetValue<uint64>());
+			return TEXT("KBEDATATYPE_UINT16");
 		}
+	};
 
-		FVariant ParseDefaultValStr(const FString& s) override
+	class KBENGINE_API KBEDATATYPE_UINT32 : public TKBEDataTypeCodec<TKBEPrimitiveCodec<uint32>>
+	{
+	public:
+		virtual const TCHAR *TypeString() const override
 		{
-			TCHAR *pEnd = nullptr;
-			return (uint64)FCString::Strtoui64(*s, &pEnd, 10);
+			return TEXT("KBEDATATYPE_UINT32");
 		}
+	};
 
-		bool IsSameType(const FVariant &v) override
+	class KBENGINE_API KBEDATATYPE_UINT64 : public TKBEDataTypeCodec<TKBEPrimitiveCodec<uint64>>
+	{
+	public:
+		virtual const TCHAR *TypeString() const override
 		{
-			if (!KBEDATATYPE_BASE::IsNumeric(v))
-				return false;
-
-			double n = KBEDATATYPE_BASE::ToNumber(v);
-			return n >= 0 && n <= UINT64_MAX;
+			return TEXT("KBEDATATYPE_UINT64");
 		}
 	};
 
-	class KBENGINE_API KBEDATATYPE_FLOAT : public KBEDATATYPE_BASE
+	class KBENGINE_API KBEDATATYPE_FLOAT : public TKBEDataTypeCodec<TKBEPrimitiveCodec<float>>
 	{
 	public:
 		virtual const TCHAR *TypeString() const override
 		{
 			return TEXT("KBEDATATYPE_FLOAT");
 		}
-
-		FVariant CreateFromStream(MemoryStream *stream) override
-		{
-			return FVariant(stream->ReadFloat());
-		}
-
-		void AddToStream(Bundle *stream, const FVariant &v) override
-		{
-			stream->WriteFloat(v.GetValue<float>());
-		}
-
-		FVariant ParseDefaultValStr(const FString& s) override
-		{
-			return (float)FCString::Atof(*s);
-		}
-
-		bool IsSameType(const FVariant &v) override
-		{
-			if (v.GetType() != EVariantTypes::Float &&
-				v.GetType() != EVariantTypes::Double)
-				return false;
-
-			double n = KBEDATATYPE_BASE::ToNumber(v);
-			return n >= -FLT_MAX && n <= FLT_MAX;
-		}
 	};
 
-	class KBENGINE_API KBEDATATYPE_DOUBLE : public KBEDATATYPE_BASE
+	class KBENGINE_API KBEDATATYPE_DOUBLE : public TKBEDataTypeCodec<TKBEPrimitiveCodec<double>>
 	{
 	public:
 		virtual const TCHAR *TypeString() const override
 		{
 			return TEXT("KBEDATATYPE_DOUBLE");
 		}
-
-		FVariant CreateFromStream(MemoryStream *stream) override
-		{
-			return FVariant(stream->ReadDouble());
-		}
-
-		void AddToStream(Bundle *stream, const FVariant &v) override
-		{
-			stream->WriteDouble(v.GetValue<double>());
-		}
-
-		FVariant ParseDefaultValStr(const FString& s) override
-		{
-			return (double)FCString::Atod(*s);
-		}
-
-		bool IsSameType(const FVariant &v) override
-		{
-			if (v.GetType()!= EVariantTypes::Float && 
-				v.GetType()!= EVariantTypes::Double)
-				return false;
-
-			double n = KBEDATATYPE_BASE::ToNumber(v);
-			return n >= -DBL_MAX && n <= DBL_MAX;
-		}
 	};
 
 	class KBENGINE_API KBEDATATYPE_STRING : public KBEDATATYPE_BASE
@@ -364,11 +323,21 @@ namespace KBEngine
 			return TEXT("KBEDATATYPE_STRING");
 		}
 
-		FVariant CreateFromStream(MemoryStream *stream) override
+		FVariant CreateFromStream(MemoryStreamView *stream) override
 		{
 			return FVariant(FString(stream->ReadString()));
 		}
 
+		void CompilePlan(DataTypePlan& plan) override
+		{
+			plan.Add(EKBEPlanOp::String, this);
+		}
+
+		EKBEPlanOp WireOp() const override
+		{
+			return EKBEPlanOp::String;
+		}
+
 		void AddToStream(Bundle *stream, const FVariant &v) override
 		{
 			stream->WriteString(v.GetValue<FString>());
@@ -385,124 +354,53 @@ namespace KBEngine
 		}
 	};
 
-	class KBENGINE_API KBEDATATYPE_VECTOR2 : public KBEDATATYPE_BASE
+	class KBENGINE_API KBEDATATYPE_VECTOR2 : public TKBEDataTypeCodec<TKBEVectorCodec<2>>
 	{
 	public:
 		virtual const TCHAR *TypeString() const override
 		{
 			return TEXT("KBEDATATYPE_VECTOR2");
 		}
-
-		FVariant CreateFromStream(MemoryStream *stream) override
-		{
-			FVector2D vec;
-			vec.X = stream->ReadFloat();
-			vec.Y = stream->ReadFloat();
-			return FVariant(vec);
-		}
-
-		void AddToStream(Bundle *stream, const FVariant &v) override
-		{
-			FVector2D vec = v.GetValue<FVector2D>();
-			stream->WriteFloat(vec.X);
-			stream->WriteFloat(vec.Y);
-		}
-
-		FVariant ParseDefaultValStr(const FString& s) override
-		{
-			return FVector2D(0, 0);
-		}
-
-		bool IsSameType(const FVariant &v) override
-		{
-			return v.GetType() == EVariantTypes::Vector2d;
-		}
 	};
 
-	class KBENGINE_API KBEDATATYPE_VECTOR3 : public KBEDATATYPE_BASE
+	class KBENGINE_API KBEDATATYPE_VECTOR3 : public TKBEDataTypeCodec<TKBEVectorCodec<3>>
 	{
 	public:
 		virtual const TCHAR *TypeString() const override
 		{
 			return TEXT("KBEDATATYPE_VECTOR3");
 		}
-
-		FVariant CreateFromStream(MemoryStream *stream) override
-		{
-			FVector vec;
-			vec.X = stream->ReadFloat();
-			vec.Y = stream->ReadFloat();
-			vec.Z = stream->ReadFloat();
-			return FVariant(vec);
-		}
-
-		void AddToStream(Bundle *stream, const FVariant &v) override
-		{
-			FVector vec = v.GetValue<FVector>();
-			stream->WriteFloat(vec.X);
-			stream->WriteFloat(vec.Y);
-			stream->WriteFloat(vec.Z);
-		}
-
-		FVariant ParseDefaultValStr(const FString& s) override
-		{
-			return FVariant(FVector(0, 0, 0));
-		}
-
-		bool IsSameType(const FVariant &v) override
-		{
-			return v.GetType() == EVariantTypes::Vector;
-		}
 	};
 
-	class KBENGINE_API KBEDATATYPE_VECTOR4 : public KBEDATATYPE_BASE
+	class KBENGINE_API KBEDATATYPE_VECTOR4 : public TKBEDataTypeCodec<TKBEVectorCodec<4>>
 	{
 	public:
 		virtual const TCHAR *TypeString() const override
 		{
 			return TEXT("KBEDATATYPE_VECTOR4");
 		}
-
-		FVariant CreateFromStream(MemoryStream *stream) override
-		{
-			FVector4 vec;
-			vec.X = stream->ReadFloat();
-			vec.Y = stream->ReadFloat();
-			vec.Z = stream->ReadFloat();
-			vec.W = stream->ReadFloat();
-			return FVariant(vec);
-		}
-
-		void AddToStream(Bundle *stream, const FVariant &v) override
-		{
-			FVector4 vec = v.GetValue<FVector4>();
-			stream->WriteFloat(vec.X);
-			stream->WriteFloat(vec.Y);
-			stream->WriteFloat(vec.Z);
-			stream->WriteFloat(vec.W);
-		}
-
-		FVariant ParseDefaultValStr(const FString& s) override
-		{
-			return FVector4(0, 0, 0, 0);
-		}
-
-		bool IsSameType(const FVariant &v) override
-		{
-			return v.GetType() == EVariantTypes::Vector4;
-		}
 	};
 
 	class KBENGINE_API KBEDATATYPE_BYTEARRAY : public KBEDATATYPE_BASE
 	{
 	public:
-		FVariant CreateFromStream(MemoryStream *stream) override
+		FVariant CreateFromStream(MemoryStreamView *stream) override
 		{
 			TArray<uint8> bytes;
 			stream->ReadBlob(bytes);
 			return bytes;
 		}
 
+		void CompilePlan(DataTypePlan& plan) override
+		{
+			plan.Add(EKBEPlanOp::Blob, this);
+		}
+
+		EKBEPlanOp WireOp() const override
+		{
+			return EKBEPlanOp::Blob;
+		}
+
 		void AddToStream(Bundle *stream, const FVariant &v) override
 		{
 			stream->WriteBlob(v.GetValue< TArray<uint8> >());
@@ -563,11 +461,21 @@ namespace KBEngine
 			return TEXT("KBEDATATYPE_UNICODE");
 		}
 
-		FVariant CreateFromStream(MemoryStream *stream) override
+		FVariant CreateFromStream(MemoryStreamView *stream) override
 		{
 			return FVariant(stream->ReadUTF8());
 		}
 
+		void CompilePlan(DataTypePlan& plan) override
+		{
+			plan.Add(EKBEPlanOp::Unicode, this);
+		}
+
+		EKBEPlanOp WireOp() const override
+		{
+			return EKBEPlanOp::Unicode;
+		}
+
 		void AddToStream(Bundle *stream, const FVariant &v) override
 		{
 			stream->WriteUTF8(v.GetValue<FString>());
@@ -582,6 +490,11 @@ namespace KBEngine
 		{
 			return v.GetType() == EVariantTypes::String;
 		}
+
+		bool IsUnicode() const override
+		{
+			return true;
+		}
 	};
 
 	class KBENGINE_API KBEDATATYPE_MAILBOX : public KBEDATATYPE_BYTEARRAY
@@ -616,14 +529,23 @@ namespace KBEngine
 		}
 
 		void Bind() override;
-		FVariant CreateFromStream(MemoryStream *stream) override;
+		FVariant CreateFromStream(MemoryStreamView *stream) override;
 		void AddToStream(Bundle *stream, const FVariant &v) override;
 		FVariant ParseDefaultValStr(const FString& s) override;
 		bool IsSameType(const FVariant &v) override;
+		bool AddToStreamChecked(Bundle *stream, const FVariant &v) override;
+
+		KBEDATATYPE_BASE* ElementType() const override { return vtypeObject_; }
+
+		void CompilePlan(DataTypePlan& plan) override;
+		EKBEPlanOp WireOp() const override { return EKBEPlanOp::Array; }
 
 	private:
 		uint16 vtype_;
 		KBEDATATYPE_BASE *vtypeObject_ = nullptr;
+
+		// 元素为定长的基础数值类型时，在Bind()中记下其类型，编解码时整块读写
+		EVariantTypes elementType_ = EVariantTypes::Empty;
 	};
 
 	class KBENGINE_API KBEDATATYPE_FIXED_DICT : public KBEDATATYPE_BASE
@@ -643,16 +565,42 @@ namespace KBEngine
 		}
 
 		void Bind() override;
-		FVariant CreateFromStream(MemoryStream *stream) override;
+		FVariant CreateFromStream(MemoryStreamView *stream) override;
 		void AddToStream(Bundle *stream, const FVariant &v) override;
 		FVariant ParseDefaultValStr(const FString& s) override;
 		bool IsSameType(const FVariant &v) override;
+		bool AddToStreamChecked(Bundle *stream, const FVariant &v) override;
 
-		void AddSubType(const FString& key, uint16 type) { dictType_.Add(key, type); }
+		// 按服务器定义（数据流中）的顺序添加字段
+		void AddSubType(const FString& key, uint16 type);
+
+		struct Field
+		{
+			FString name;
+			uint16 utype = 0;
+			KBEDATATYPE_BASE* type = nullptr;
+		};
+
+		const TArray<Field>& Fields() const { return fields_; }
+
+		// 字段的下标，找不到时返回INDEX_NONE；字段一般很少，顺序查找即可
+		int32 FieldIndex(const FString& name) const;
+
+		// 解码为FVariantFixedDict时使用的字段名，第一次使用时按当前的字段取得
+		const FVariantFixedDictSchema* Schema() const;
+
+		void CompilePlan(DataTypePlan& plan) override;
+		EKBEPlanOp WireOp() const override { return EKBEPlanOp::FixedDict; }
+
+		// 是否解码为FVariantFixedDict（KBEngineArgs::fixedDictAsStruct）
+		static bool DecodeAsStruct();
 
 	private:
 		FString implementedBy_;
-		TMap<FString, uint16> dictType_;
-		TMap<FString, KBEDATATYPE_BASE *> dictTypeObjects_;
+
+		// 字段按数据流中的顺序排列，编解码时依次处理
+		TArray<Field> fields_;
+
+		mutable const FVariantFixedDictSchema* schema_ = nullptr;
 	};
 }
@@ -1,9 +1,13 @@
 #pragma once
 #include <memory>
 #include <type_traits>
+#include <tuple>
+#include <utility>
 
 #include "KBEDefine.h"
 #include "KBEDebug.h"
+#include "Method.h"
+#include "DataTypes.h"
 
 namespace KBEngine
 {
@@ -39,11 +43,285 @@ namespace KBEngine
 
 	};
 
+	/*
+	把按声明的类型解码出的FVariant转换为方法参数的C++类型
+	数值之间按值转换（超出范围或者带小数的浮点数转换为整数时失败），其它类型必须一致
+	*/
+	template <class T, bool = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>
+	class MethodArgConverter
+	{
+	public:
+		static bool Convert(const FVariant& v, T& out)
+		{
+			if (v.GetType() != TVariantTraits<T>::GetType())
+				return false;
+
+			out = v.GetValue<T>();
+			return true;
+		}
+	};
+
+	template <class T>
+	class MethodArgConverter<T, true>
+	{
+	public:
+		FORCEINLINE static bool Convert(const FVariant& v, T& out) { return KBEDATATYPE_BASE::ConvertNumber(v, out); }
+	};
+
+	template <>
+	class MethodArgConverter<bool>
+	{
+	public:
+		static bool Convert(const FVariant& v, bool& out)
+		{
+			if (!KBEDATATYPE_BASE::IsNumeric(v))
+				return false;
+
+			out = KBEDATATYPE_BASE::ToNumber(v) != 0.0;
+			return true;
+		}
+	};
+
+	/*
+	声明的类型与C++类型不一致时，先按声明的类型解码为FVariant再转换，数据流的位置因此总是正确的
+	无法转换时参数为默认值
+	*/
+	template <class T>
+	void ReadConvertedArg(T& out, KBEDATATYPE_BASE* type, MemoryStreamView& stream)
+	{
+		FVariant v = type->CreateFromStream(&stream);
+		if (!MethodArgConverter<T>::Convert(v, out))
+		{
+			KBE_ERROR(TEXT("MethodArgReader: %s can not be converted to the parameter type!"), type->TypeString());
+			out = T();
+		}
+	}
+
+	/*
+	从数据流中直接把参数读入C++类型的变量，不再经过FVariant中转
+	声明的类型与C++类型一致时直接读取，否则交给ReadConvertedArg
+	*/
+	template <class T, bool = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>
+	class MethodArgReader
+	{
+	public:
+		FORCEINLINE static void Read(T& out, KBEDATATYPE_BASE* type, MemoryStreamView& stream) { ReadConvertedArg(out, type, stream); }
+	};
+
+	template <class T>
+	class MethodArgReader<T, true>
+	{
+	public:
+		FORCEINLINE static void Read(T& out, KBEDATATYPE_BASE* type, MemoryStreamView& stream)
+		{
+			if (type->PrimitiveType() == TVariantTraits<T>::GetType())
+				out = stream.Read<T>();
+			else
+				ReadConvertedArg(out, type, stream);
+		}
+	};
+
+	template <>
+	class MethodArgReader<FString>
+	{
+	public:
+		static void Read(FString& out, KBEDATATYPE_BASE* type, MemoryStreamView& stream)
+		{
+			switch (type->WireOp())
+			{
+			case EKBEPlanOp::String:
+				out = stream.ReadString();
+				break;
+			case EKBEPlanOp::Unicode:
+				out = stream.ReadUTF8();
+				break;
+			default:
+				ReadConvertedArg(out, type, stream);
+				break;
+			}
+		}
+	};
+
+	// ARRAY参数：元素类型与声明的数值类型一致时整块读取，不为每个元素生成FVariant
+	template <class T, bool = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>
+	class ArrayArgReader
+	{
+	public:
+		static void Read(TArray<T>& out, KBEDATATYPE_BASE* type, MemoryStreamView& stream)
+		{
+			out.Reset();
+
+			FVariant v = type->CreateFromStream(&stream);
+			if (v.GetType() != static_cast<EVariantTypes>(EKBEVariantTypes::VariantArray))
+			{
+				KBE_ERROR(TEXT("ArrayArgReader: %s can not be converted to the parameter type!"), type->TypeString());
+				return;
+			}
+
+			const auto values = v.GetValue<FVariantArray>();
+
+			out.Reserve(values.Num());
+			for (const FVariant& value : values)
+			{
+				T element;
+				if (!MethodArgConverter<T>::Convert(value, element))
+				{
+					KBE_ERROR(TEXT("ArrayArgReader: the element of %s can not be converted to the parameter type!"), type->TypeString());
+					out.Reset();
+					return;
+				}
+
+				out.Add(element);
+			}
+		}
+	};
+
+	template <class T>
+	class ArrayArgReader<T, true>
+	{
+	public:
+		static void Read(TArray<T>& out, KBEDATATYPE_BASE* type, MemoryStreamView& stream)
+		{
+			KBEDATATYPE_BASE* elementType = type->ElementType();
+			if (type->WireOp() == EKBEPlanOp::Array && elementType && elementType->PrimitiveType() == TVariantTraits<T>::GetType())
+			{
+				uint32 size = stream.ReadUint32();
+				stream.ReadArray(out, size);
+				return;
+			}
+
+			// 声明的类型与元素类型不一致时按数值转换
+			ArrayArgReader<T, false>::Read(out, type, stream);
+		}
+	};
+
+	template <class T>
+	class MethodArgReader<TArray<T>, false>
+	{
+	public:
+		FORCEINLINE static void Read(TArray<T>& out, KBEDATATYPE_BASE* type, MemoryStreamView& stream) { ArrayArgReader<T>::Read(out, type, stream); }
+	};
+
+	// BLOB等类型直接读入，声明为ARRAY时按uint8数组读取
+	template <>
+	class MethodArgReader<TArray<uint8>>
+	{
+	public:
+		FORCEINLINE static void Read(TArray<uint8>& out, KBEDATATYPE_BASE* type, MemoryStreamView& stream)
+		{
+			if (type->WireOp() == EKBEPlanOp::Blob)
+				stream.ReadBlob(out);
+			else
+				ArrayArgReader<uint8>::Read(out, type, stream);
+		}
+	};
+
+	template <>
+	class MethodArgReader<FVector2D>
+	{
+	public:
+		FORCEINLINE static void Read(FVector2D& out, KBEDATATYPE_BASE* type, MemoryStreamView& stream)
+		{
+			if (type->WireOp() != EKBEPlanOp::Vector2)
+			{
+				ReadConvertedArg(out, type, stream);
+				return;
+			}
+
+			out.X = stream.ReadFloat();
+			out.Y = stream.ReadFloat();
+		}
+	};
+
+	template <>
+	class MethodArgReader<FVector>
+	{
+	public:
+		FORCEINLINE static void Read(FVector& out, KBEDATATYPE_BASE* type, MemoryStreamView& stream)
+		{
+			if (type->WireOp() != EKBEPlanOp::Vector3)
+			{
+				ReadConvertedArg(out, type, stream);
+				return;
+			}
+
+			out.X = stream.ReadFloat();
+			out.Y = stream.ReadFloat();
+			out.Z = stream.ReadFloat();
+		}
+	};
+
+	template <>
+	class MethodArgReader<FVector4>
+	{
+	public:
+		FORCEINLINE static void Read(FVector4& out, KBEDATATYPE_BASE* type, MemoryStreamView& stream)
+		{
+			if (type->WireOp() != EKBEPlanOp::Vector4)
+			{
+				ReadConvertedArg(out, type, stream);
+				return;
+			}
+
+			out.X = stream.ReadFloat();
+			out.Y = stream.ReadFloat();
+			out.Z = stream.ReadFloat();
+			out.W = stream.ReadFloat();
+		}
+	};
+
+	template <>
+	class MethodArgReader<FVariant>
+	{
+	public:
+		FORCEINLINE static void Read(FVariant& out, KBEDATATYPE_BASE* type, MemoryStreamView& stream) { out = type->CreateFromStream(&stream); }
+	};
+
+	// FIXED_DICT参数不论解码为哪种表示（KBEngineArgs::fixedDictAsStruct），都转换为方法声明的类型
+	template <>
+	class MethodArgReader<FVariantMap>
+	{
+	public:
+		static void Read(FVariantMap& out, KBEDATATYPE_BASE* type, MemoryStreamView& stream)
+		{
+			FVariant v = type->CreateFromStream(&stream);
+			if (v.GetType() == static_cast<EVariantTypes>(EKBEVariantTypes::VariantFixedDict))
+				out = v.GetValue<FVariantFixedDict>().ToMap();
+			else
+				out = v.GetValue<FVariantMap>();
+		}
+	};
+
+	template <>
+	class MethodArgReader<FVariantFixedDict>
+	{
+	public:
+		static void Read(FVariantFixedDict& out, KBEDATATYPE_BASE* type, MemoryStreamView& stream)
+		{
+			FVariant v = type->CreateFromStream(&stream);
+			if (v.GetType() == static_cast<EVariantTypes>(EKBEVariantTypes::VariantMap))
+			{
+				// 按类型定义的字段顺序转换
+				const KBEDATATYPE_FIXED_DICT* dictType = static_cast<const KBEDATATYPE_FIXED_DICT*>(type);
+				const auto data = v.GetValue<FVariantMap>();
+
+				out = FVariantFixedDict(dictType->Schema());
+				for (const auto& field : dictType->Fields())
+					out.values.Add(data.FindRef(field.name));
+			}
+			else
+			{
+				out = v.GetValue<FVariantFixedDict>();
+			}
+		}
+	};
+
 	template <class T>
 	class MethodArg
 	{
 	public:
 		FORCEINLINE static void Convert(T& out, const FVariant&& v) { out = v.GetValue<T>(); }
+		FORCEINLINE static void Read(T& out, KBEDATATYPE_BASE* type, MemoryStreamView& stream) { MethodArgReader<T>::Read(out, type, stream); }
 	};
 
 	template <>
@@ -51,12 +329,16 @@ namespace KBEngine
 	{
 	public:
 		FORCEINLINE static void Convert(FVariant& out, const FVariant&& v) { out = std::forward<const FVariant>(v); }
+		FORCEINLINE static void Read(FVariant& out, KBEDATATYPE_BASE* type, MemoryStreamView& stream) { MethodArgReader<FVariant>::Read(out, type, stream); }
 	};
 
 	class KBENGINE_API EntityMethodProxy
 	{
 	public:
 		virtual void Do(KBEngine::Entity *entity, const FVariantArray &args) = 0;
+
+		// 按方法的定义直接从数据流中解码参数并调用，参数个数不符时返回false
+		virtual bool DoFromStream(KBEngine::Entity *entity, const Method &method, MemoryStreamView &stream) = 0;
 	};
 
 	typedef std::shared_ptr<EntityMethodProxy> EntityMethodProxyPtr;
@@ -85,6 +367,31 @@ namespace KBEngine
 
 			MethodInvokerE<_Mysize>::MethodInvoker<TUPLE>::Invoke(entity, func, args);
 		}
+
+		virtual bool DoFromStream(KBEngine::Entity *entity, const Method &method, MemoryStreamView &stream) override
+		{
+			if (method.args.Num() != _Mysize)
+			{
+				KBE_ERROR(TEXT("EntityMethodProxy: method(%s) args must takes %d arguments (%d defined)"), *method.name, _Mysize, method.args.Num());
+				return false;
+			}
+
+			InvokeFromStream(entity, method, stream, std::index_sequence_for<TYPES...>());
+			return true;
+		}
+
+	private:
+		template<size_t... I>
+		FORCEINLINE void InvokeFromStream(KBEngine::Entity *entity, const Method &method, MemoryStreamView &stream, std::index_sequence<I...>)
+		{
+			TUPLE values;
+
+			// 花括号初始化列表保证从左到右求值，即参数按照在数据流中的顺序被读出
+			int order[] = { 0, (MethodArg<typename std::tuple_element<I, TUPLE>::type>::Read(std::get<I>(values), method.args[I], stream), 0)... };
+			(void)order;
+
+			(entity->*func)(std::get<I>(values)...);
+		}
 	};
 
 
@@ -107,12 +414,24 @@ namespace KBEngine
 	};
 
 
+	/*
+	用于判断实体类是否重载了OnRemoteMethodCall(const FString&, const TArray<FVariant>&)
+	按名字取得的重载集合中有FVariant版本时，返回声明它的类；只有数据流版本时返回Entity（第二个参数使FVariant版本优先）
+	*/
+	template <class C> C* RemoteMethodCallHookOwner(void (C::*)(const FString&, const TArray<FVariant>&), int);
+	template <class C> Entity* RemoteMethodCallHookOwner(void (C::*)(const Method&, MemoryStreamView&), long);
+
 #define KBE_DECLARE_ENTITY_MAP() \
 protected: \
 	static const KBEngine::KBE_ENTITY_METHOD_MAP* GetThisMethodMap(); \
 	virtual const KBEngine::KBE_ENTITY_METHOD_MAP* GetMethodMap() const override; \
 	static const KBEngine::KBE_ENTITY_PROPERTY_MAP* GetThisPropertyMap(); \
 	virtual const KBEngine::KBE_ENTITY_PROPERTY_MAP* GetPropertyMap() const override; \
+	virtual bool UsesVariantRemoteMethodCall() const override \
+	{ \
+		typedef std::remove_cv<std::remove_pointer<decltype(this)>::type>::type ThisEntityClass; \
+		return !std::is_same<decltype(KBEngine::RemoteMethodCallHookOwner(&ThisEntityClass::OnRemoteMethodCall, 0)), KBEngine::Entity*>::value; \
+	} \
 
 
 #define KBE_BEGIN_ENTITY_METHOD_MAP(theClass, baseClass) \
@@ -138,9 +457,9 @@ protected: \
 
 
 
-// @TODO(penghuawei): ʹc++11Ժ
-// DECLARE_REMOTE_METHOD_0 - DECLARE_REMOTE_METHOD_9Ѿʹã
-// ֮ԱΪ˼ݾɴ룬һʱ󽫱ɾ
+// @TODO(penghuawei): 使用c++11特性后，
+// 下面的DECLARE_REMOTE_METHOD_0 - DECLARE_REMOTE_METHOD_9已经不再使用，
+// 之所以保留是为了兼容旧代码，一定时间后将被删除
 #define DECLARE_REMOTE_METHOD_0(name, func) \
 	{TEXT(#name), KBEngine::EntityMethodProxyPtr(new KBEngine::EntityMethodProxyV<>(static_cast<KBEngine::EntityMethodProxyV<>::EMETHOD>(func)))}, \
 
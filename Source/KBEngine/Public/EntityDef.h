@@ -9,8 +9,8 @@ namespace KBEngine
 	class ScriptModule;
 
 	/*
-	EntityDefģ
-	еʵ嶨Լе
+	EntityDef模块
+	管理了所有的实体定义的描述以及所有的数据类型描述
 	*/
 	class KBENGINE_API EntityDef
 	{
@@ -30,19 +30,22 @@ namespace KBEngine
 		static int32 ScriptModuleNum() { return moduledefs_.Num(); }
 
 		static void RegisterScriptModule(const FString& moduleName, uint16 moduleID, ScriptModule* inst);
-		static bool ImportEntityDefFromStream(MemoryStream &stream);
+		static bool ImportEntityDefFromStream(MemoryStreamView &stream);
 
 		static bool EntityDefImported() { return entityDefImported_; }
 		static void EntityDefImported(bool bValue) { entityDefImported_ = bValue; }
 
+		// 实体定义每次清除或导入后都会改变这个值，缓存了ScriptModule/Method指针的地方据此判断是否需要重新查找
+		static uint32 Generation() { return generation_; }
+
 	private:
 		static void InitDataType();
 		static void BindMessageDataType();
-		static void CreateDataTypesFromStream(MemoryStream &stream);
-		static void CreateDataTypeFromStream(MemoryStream &stream);
+		static void CreateDataTypesFromStream(MemoryStreamView &stream);
+		static void CreateDataTypeFromStream(MemoryStreamView &stream);
 
 	private:
-		// е
+		// 所有的数据类型
 		static TMap<FString, uint16> datatype2id_;
 		static TMap<FString, KBEDATATYPE_BASE *> datatypes_;
 		static TMap<uint16, KBEDATATYPE_BASE *> id2datatypes_;
@@ -52,7 +55,9 @@ namespace KBEngine
 		static TMap<FString, ScriptModule *> moduledefs_;
 		static TMap<uint16, ScriptModule *> idmoduledefs_;
 
-		// Ƿѵ
+		// 是否已导入数据
 		static bool entityDefImported_;
+
+		static uint32 generation_;
 	};
 }
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "MemoryStream.h"
+
+namespace KBEngine
+{
+	/*
+	EntityMessageBuffer的统计信息，用于性能分析
+	*/
+	struct EntityMessageBufferStats
+	{
+		// 上一帧被缓存的实体数量
+		uint32 bufferedLastFrame = 0;
+
+		// 单帧被缓存的实体数量的峰值
+		uint32 peakBufferedPerFrame = 0;
+
+		// 累计被缓存的实体数量
+		uint64 totalBuffered = 0;
+
+		// 因过期或空间不足而被丢弃的缓存数量
+		uint64 evicted = 0;
+
+		// 当前缓存的实体数量、有效数据字节数以及缓冲区的大小
+		int32 count = 0;
+		uint32 usedBytes = 0;
+		uint32 arenaBytes = 0;
+	};
+
+	/*
+	实体进入世界之前收到的属性数据的缓存
+	所有实体的数据都存放在同一块连续的缓冲区中，每个实体只记录偏移与长度。
+	移除的数据先标记为废弃，在Tick中统一整理；缓冲区有上限，超出时丢弃最早的数据，
+	长时间没有进入世界的实体的数据也会被丢弃
+	*/
+	class KBENGINE_API EntityMessageBuffer
+	{
+	public:
+		const static uint32 DEFAULT_MAX_BYTES = 1024 * 1024;
+		const static int32 DEFAULT_MAX_AGE = 60;	// 单位：秒
+
+		EntityMessageBuffer(uint32 maxBytes = DEFAULT_MAX_BYTES, int32 maxAge = DEFAULT_MAX_AGE);
+
+		FORCEINLINE bool Contains(int32 entityID) const { return records_.Contains(entityID); }
+
+		// 缓存实体的数据，实体已经有缓存或数据超出上限时返回false
+		bool Add(int32 entityID, const uint8* datas, uint32 length);
+
+		// 取得实体缓存的数据，返回的视图在下一次Add或Tick之前有效
+		bool Find(int32 entityID, MemoryStreamView& out) const;
+
+		void Remove(int32 entityID);
+		void Clear();
+
+		// 每帧调用一次：丢弃过期的数据、整理缓冲区并统计本帧的缓存数量
+		void Tick();
+
+		const EntityMessageBufferStats& Stats() const { return stats_; }
+
+	private:
+		struct Record
+		{
+			uint32 offset = 0;
+			uint32 length = 0;
+			double time = 0.0;
+		};
+
+		void Evict(int32 entityID);
+		void EvictOldest();
+		void Compact();
+
+	private:
+		uint32 maxBytes_;
+		int32 maxAge_;
+
+		TArray<uint8> arena_;
+		uint32 garbageBytes_ = 0;
+
+		TMap<int32, Record> records_;
+
+		uint32 bufferedThisFrame_ = 0;
+		EntityMessageBufferStats stats_;
+	};
+}
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "KBEDefine.h"
+#include "DataTypes.h"
+#include "Bundle.h"
+#include "Mailbox.h"
+#include "Method.h"
+
+namespace KBEngine
+{
+	class Entity;
+	class ScriptModule;
+
+	/*
+	预先解析的实体远程方法（base或cell上的方法）
+	Entity::BaseCall/CellCall每次调用都要按名字查找方法，并且参数要先装进FVariant；
+	这里在第一次调用时解析方法，之后只要实体的定义没有变化（EntityDef::Generation）就直接使用，
+	参数以C++类型传入并直接写入数据流。
+
+	用法：
+		static EntityRemoteMethod attack(TEXT("attack"), Mailbox::MAILBOX_TYPE::MAILBOX_TYPE_CELL);
+		attack.Call(entity, targetID, skillID);
+	*/
+	class KBENGINE_API EntityRemoteMethod
+	{
+	public:
+		EntityRemoteMethod(const FString& methodName, Mailbox::MAILBOX_TYPE type);
+
+		const FString& MethodName() const { return methodName_; }
+
+		// 取得entity所属实体类中的这个方法，没有时返回nullptr
+		Method* Resolve(Entity* entity);
+
+		/*
+		调用远程方法，参数的个数必须与方法的定义一致
+		参数写入失败（类型不符）时这次调用被丢弃，返回false
+		*/
+		template <typename... Args>
+		bool Call(Entity* entity, const Args&... args);
+
+		// 把FVariant形式的参数按定义的类型写入数据流，KBEngineArgs::validateEntityCallArgs为true时检查类型
+		static bool WriteArg(Bundle* bundle, KBEDATATYPE_BASE* type, const FVariant& v);
+
+	private:
+		Mailbox* Prepare(Entity* entity, int32 numArgs, Method*& method);
+		bool Finish(Entity* entity, Method* method, Mailbox* mailbox, int32 failedArg);
+
+		template <size_t... I, typename... Args>
+		static int32 WriteArgs(Bundle* bundle, Method* method, std::index_sequence<I...>, const Args&... args);
+
+	private:
+		FString methodName_;
+		Mailbox::MAILBOX_TYPE type_;
+
+		// 解析的结果，scriptModule_或generation_变化后重新解析
+		ScriptModule* scriptModule_ = nullptr;
+		uint32 generation_ = 0;
+		Method* method_ = nullptr;
+	};
+
+	/*
+	按方法定义的类型把C++类型的参数写入数据流，与MethodArgReader相对应
+	数值、字符串与向量类型与定义一致时直接写入，其它情况转换为FVariant后写入（数值在范围内时会被转换）
+	*/
+	template <class T, bool = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>
+	class MethodArgWriter
+	{
+	public:
+		FORCEINLINE static bool Write(Bundle* bundle, KBEDATATYPE_BASE* type, const T& v) { return EntityRemoteMethod::WriteArg(bundle, type, FVariant(v)); }
+	};
+
+	template <class T>
+	class MethodArgWriter<T, true>
+	{
+	public:
+		FORCEINLINE static bool Write(Bundle* bundle, KBEDATATYPE_BASE* type, const T& v)
+		{
+			if (type->PrimitiveType() == TVariantTraits<T>::GetType())
+			{
+				bundle->Write<T>(v);
+				return true;
+			}
+
+			return EntityRemoteMethod::WriteArg(bundle, type, FVariant(v));
+		}
+	};
+
+	template <>
+	class MethodArgWriter<FVariant>
+	{
+	public:
+		FORCEINLINE static bool Write(Bundle* bundle, KBEDATATYPE_BASE* type, const FVariant& v) { return EntityRemoteMethod::WriteArg(bundle, type, v); }
+	};
+
+	template <>
+	class MethodArgWriter<FString>
+	{
+	public:
+		static bool Write(Bundle* bundle, KBEDATATYPE_BASE* type, const FString& v)
+		{
+			switch (type->WireOp())
+			{
+			case EKBEPlanOp::String:
+				bundle->WriteString(v);
+				return true;
+			case EKBEPlanOp::Unicode:
+				bundle->WriteUTF8(v);
+				return true;
+			default:
+				return EntityRemoteMethod::WriteArg(bundle, type, FVariant(v));
+			}
+		}
+	};
+
+	// VECTOR2/3/4参数：声明的类型一致时逐个分量直接写入
+	template <int32 N>
+	class VectorArgWriter
+	{
+	public:
+		typedef typename TKBEVectorType<N>::Type ValueType;
+
+		FORCEINLINE static bool Write(Bundle* bundle, KBEDATATYPE_BASE* type, const ValueType& v)
+		{
+			if (type->WireOp() != TKBEVectorType<N>::PLAN_OP)
+				return EntityRemoteMethod::WriteArg(bundle, type, FVariant(v));
+
+			TKBEVectorCodec<N>::Write(*bundle, v);
+			return true;
+		}
+	};
+
+	template <>
+	class MethodArgWriter<FVector2D> : public VectorArgWriter<2>
+	{
+	};
+
+	template <>
+	class MethodArgWriter<FVector> : public VectorArgWriter<3>
+	{
+	};
+
+	template <>
+	class MethodArgWriter<FVector4> : public VectorArgWriter<4>
+	{
+	};
+
+	// ARRAY参数：元素类型与声明的数值类型一致时整块写入，不为每个元素生成FVariant
+	template <class T, bool = std::is_arithmetic<T>::value && !std::is_same<T, bool>::value>
+	class ArrayArgWriter
+	{
+	public:
+		static bool Write(Bundle* bundle, KBEDATATYPE_BASE* type, const TArray<T>& v)
+		{
+			FVariantArray values;
+			values.Reserve(v.Num());
+			for (const T& value : v)
+				values.Add(FVariant(value));
+
+			return EntityRemoteMethod::WriteArg(bundle, type, FVariant(values));
+		}
+	};
+
+	template <class T>
+	class ArrayArgWriter<T, true>
+	{
+	public:
+		static bool Write(Bundle* bundle, KBEDATATYPE_BASE* type, const TArray<T>& v)
+		{
+			KBEDATATYPE_BASE* elementType = type->ElementType();
+			if (elementType && elementType->PrimitiveType() == TVariantTraits<T>::GetType())
+			{
+				bundle->WriteUint32((uint32)v.Num());
+				bundle->WriteArray(v.GetData(), v.Num());
+				return true;
+			}
+
+			return ArrayArgWriter<T, false>::Write(bundle, type, v);
+		}
+	};
+
+	template <class T>
+	class MethodArgWriter<TArray<T>, false>
+	{
+	public:
+		FORCEINLINE static bool Write(Bundle* bundle, KBEDATATYPE_BASE* type, const TArray<T>& v) { return ArrayArgWriter<T>::Write(bundle, type, v); }
+	};
+
+	template <typename... Args>
+	bool EntityRemoteMethod::Call(Entity* entity, const Args&... args)
+	{
+		Method* method = nullptr;
+		Mailbox* mailbox = Prepare(entity, sizeof...(Args), method);
+		if (!mailbox)
+			return false;
+
+		Bundle* bundle = mailbox->NewMail();
+		bundle->WriteUint16(method->methodUtype);
+
+		int32 failedArg = WriteArgs(bundle, method, std::index_sequence_for<Args...>(), args...);
+		return Finish(entity, method, mailbox, failedArg);
+	}
+
+	template <size_t... I, typename... Args>
+	int32 EntityRemoteMethod::WriteArgs(Bundle* bundle, Method* method, std::index_sequence<I...>, const Args&... args)
+	{
+		int32 failedArg = -1;
+
+		// 花括号初始化列表保证从左到右求值，即参数按照声明的顺序写入；出错之后的参数不再写入
+		int order[] = { 0, ((failedArg < 0 && !MethodArgWriter<Args>::Write(bundle, method->args[I], args)) ? (failedArg = (int32)I, 0) : 0)... };
+		(void)order;
+
+		return failedArg;
+	}
+}
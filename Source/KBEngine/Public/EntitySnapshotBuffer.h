@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Core.h"
+
+namespace KBEngine
+{
+	/*
+	实体坐标与朝向的快照缓存，用于客户端的插值与外推
+	快照以收到的时间为时间戳，存放在定长的环形数组中，不分配内存。
+	渲染时间落在两个快照之间时做线性插值（朝向按最短路径插值），
+	超出最新快照时按最近两个快照的速度外推坐标，外推的时长有上限
+	*/
+	class KBENGINE_API EntitySnapshotBuffer
+	{
+	public:
+		const static int32 CAPACITY = 8;
+
+		// 静止超过这个时长（单位：秒）后再收到的快照视为新一段移动的开始
+		const static double MAX_SNAPSHOT_GAP;
+
+		/*
+		添加一个快照
+		interpolationDelay为插值延迟，在长时间没有快照之后，上一个快照会被重新打上time - interpolationDelay的时间戳，
+		使实体在插值延迟内平滑过渡到新的位置，而不是一次性跳过去
+		*/
+		void Add(double time, const FVector& position, const FVector& direction, double interpolationDelay);
+
+		// 清空并以当前状态作为唯一的快照，用于传送等需要直接跳到新位置的情况
+		void Reset(double time, const FVector& position, const FVector& direction);
+
+		void Clear();
+
+		/*
+		计算renderTime时刻的坐标与朝向，没有任何快照时返回false
+		maxExtrapolation为最大外推时长（单位：秒），为0时不外推
+		*/
+		bool Evaluate(double renderTime, double maxExtrapolation, FVector& outPosition, FVector& outDirection) const;
+
+		FORCEINLINE int32 Num() const { return count_; }
+
+	private:
+		struct Snapshot
+		{
+			double time;
+			FVector position;
+			FVector direction;
+		};
+
+		FORCEINLINE const Snapshot& At(int32 index) const { return snapshots_[(head_ + index) % CAPACITY]; }
+
+		void Push(double time, const FVector& position, const FVector& direction);
+
+	private:
+		Snapshot snapshots_[CAPACITY];
+
+		// 最早快照的位置以及快照的数量
+		int32 head_ = 0;
+		int32 count_ = 0;
+	};
+}
@@ -20,7 +20,7 @@ DEFINE_LOG_CATEGORY_STATIC(KBELog, Log, All);
 #define KBE_DISPLAY(msg, ...) UE_LOG(KBELog, Display, msg, __VA_ARGS__);
 #define KBE_VERBOSE(msg, ...) UE_LOG(KBELog, Verbose, msg, __VA_ARGS__);
 
-// ӡ
+// 打印输出
 inline void PrintString(FString name)
 {
 	KBE_DISPLAY(TEXT("%s"), *FString::Printf(TEXT("\n%s\n"), *name));
@@ -36,12 +36,12 @@ inline void PrintInteger64(int64 value)
 	KBE_DISPLAY(TEXT("%s"), *FString::Printf(TEXT("\n%llu\n"), value));
 }
 
-// ӻָλöȡT͵ֵ
+// 从缓存的指定位置读取T类型的值。
 template <typename T>
 T read(const uint8* buffer, uint32 pos)
 {
-	// buffer׵ַbuffer[pos]õԪصֵ, Ȼ&ȡõַ
-	// (T const *)ѵַתΪָͣȻ*ȡֵ
+	// 把buffer当作数组首地址，buffer[pos]得到数组元素的值, 然后&取得地址，
+	// (T const *)把地址转为指定类型，然后*取值
 	T val = *((T const*)&buffer[pos]);
 
 	//EndianConvert(val);
@@ -49,5 +49,5 @@ T read(const uint8* buffer, uint32 pos)
 }
 
 
-// 16ƴָλֽ
+// 以16进制从指定位置输出缓存的字节
 void hexlike(const uint8* buffer, uint32 startPos, uint32 size);
\ No newline at end of file
@@ -7,6 +7,7 @@ namespace KBEngine
 {
 	class Entity;
 	class MemoryStream;
+	class MemoryStreamView;
 
 	typedef uint16 MessageID;
 	typedef TArray<FVariant> FVariantArray;
@@ -21,7 +22,7 @@ namespace KBEngine
 
 
 
-	// ͻ˵
+	// 客户端的类别
 	// http://www.kbengine.org/docs/programming/clientsdkprogramming.html
 	// http://www.kbengine.org/cn/docs/programming/clientsdkprogramming.html
 	enum class CLIENT_TYPE : int8
@@ -38,7 +39,7 @@ namespace KBEngine
 		// Mac Application program
 		CLIENT_TYPE_MAC = 4,
 
-		// WebHTML5Flash
+		// Web，HTML5，Flash
 		CLIENT_TYPE_BROWSER = 5,
 
 		// bots
@@ -60,8 +61,58 @@ namespace KBEngine
 		const int VariantMap = 0x8001;
 		const int EntityPtr = 0x8002;
 		const int MemoryStreamPtr = 0x8003;
+		const int MemoryStreamViewPtr = 0x8004;
+		const int VariantFixedDict = 0x8005;
 	}
 
+	/*
+	FVariantFixedDict共享的字段名，按服务器定义的顺序排列
+	字段名相同的FIXED_DICT类型共用一个schema，schema创建后不再释放，
+	因此EntityDef::Clear删除数据类型之后，已经解码出的值仍然可以按字段名访问
+	*/
+	struct KBENGINE_API FVariantFixedDictSchema
+	{
+		TArray<FString> names;
+
+		// 从1开始分配，FVariant中的值以此保存schema
+		uint32 id = 0;
+
+		// 字段的下标，找不到时返回INDEX_NONE；字段一般很少，顺序查找即可
+		int32 FieldIndex(const FString& name) const;
+
+		// 取得与names相同的schema，没有时创建；只在游戏线程中调用
+		static const FVariantFixedDictSchema* Intern(const TArray<FString>& names);
+
+		// 按id查找，id为0或无效时返回nullptr
+		static const FVariantFixedDictSchema* Find(uint32 id);
+
+	private:
+		static TArray<FVariantFixedDictSchema*> schemas_;
+	};
+
+	/*
+	FIXED_DICT的紧凑表示（KBEngineArgs::fixedDictAsStruct）
+	字段值按服务器定义的顺序存放在values中，字段名由schema共享，不随每个值复制；
+	可以直接以下标访问，也可以通过字段名查找
+	*/
+	struct KBENGINE_API FVariantFixedDict
+	{
+		FVariantFixedDict() {}
+		explicit FVariantFixedDict(const FVariantFixedDictSchema* inSchema) : schema(inSchema) {}
+
+		// 字段的下标，找不到时返回INDEX_NONE
+		int32 FieldIndex(const FString& name) const;
+
+		const FVariant* Find(const FString& name) const;
+		FVariant* Find(const FString& name);
+
+		// 转换为以字段名为key的FVariantMap
+		FVariantMap ToMap() const;
+
+		const FVariantFixedDictSchema* schema = nullptr;
+		FVariantArray values;
+	};
+
 	template<> struct TVariantTraits < FVariantArray >
 	{
 		static EVariantTypes GetType()
@@ -78,6 +129,14 @@ namespace KBEngine
 		}
 	};
 
+	template<> struct TVariantTraits < FVariantFixedDict >
+	{
+		static EVariantTypes GetType()
+		{
+			return static_cast<EVariantTypes>(EKBEVariantTypes::VariantFixedDict);
+		}
+	};
+
 	template<> struct TVariantTraits < MemoryStream * >
 	{
 		static EVariantTypes GetType()
@@ -86,6 +145,14 @@ namespace KBEngine
 		}
 	};
 
+	template<> struct TVariantTraits < MemoryStreamView * >
+	{
+		static EVariantTypes GetType()
+		{
+			return static_cast<EVariantTypes>(EKBEVariantTypes::MemoryStreamViewPtr);
+		}
+	};
+
 	template<> struct TVariantTraits < Entity * >
 	{
 		static EVariantTypes GetType()
@@ -94,12 +161,31 @@ namespace KBEngine
 		}
 	};
 
+	inline FArchive &operator << (FArchive &ar, FVariantFixedDict &dict)
+	{
+		// 只保存schema的id，读取时再按id找回
+		uint32 schemaID = dict.schema ? dict.schema->id : 0;
+		ar << schemaID;
+
+		if (ar.IsLoading())
+			dict.schema = FVariantFixedDictSchema::Find(schemaID);
+
+		ar << dict.values;
+		return ar;
+	}
+
 	inline FMemoryWriter &operator << (FMemoryWriter &mem, MemoryStream *pMemoryStream)
 	{
 		mem.Serialize(&pMemoryStream, sizeof(pMemoryStream));
 		return mem;
 	}
 
+	inline FMemoryWriter &operator << (FMemoryWriter &mem, MemoryStreamView *pMemoryStreamView)
+	{
+		mem.Serialize(&pMemoryStreamView, sizeof(pMemoryStreamView));
+		return mem;
+	}
+
 	inline FMemoryWriter &operator << (FMemoryWriter &mem, Entity *pEntity)
 	{
 		mem.Serialize(&pEntity, sizeof(pEntity));
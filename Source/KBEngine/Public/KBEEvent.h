@@ -52,7 +52,7 @@ namespace KBEngine
 		bool Deregister(const FString& eventName, EventFuncPtr func);
 
 		/*
-		עobjйصעắ
+		注销所有obj有关的注册函数；
 		no efficiency
 		*/
 		template <class T>
@@ -72,10 +72,10 @@ namespace KBEngine
 
 	private:
 		EventFuncArray* GetEvent(const FString& eventName);
-		// ̰߳ȫ¼
+		// 线程安全的事件复制
 		void CopyEvent(EventFuncArray& out, const FString& eventName);
 
-		// ̰߳ȫĲ¼
+		// 线程安全的插入事件到队列中
 		void AddEvent(const FString& eventName, EventPair* eventPair);
 
 		bool HasRegister(const FString& eventName);
@@ -87,13 +87,13 @@ namespace KBEngine
 		static TSharedPtr<KBEEvent> s_event_;
 
 	private:
-		/* penghuawei: ܿUE4һbug
-		   ǣTMap<FString, EventFuncArray> events_
-		   ʱʹKBEEvent::Instance()->Register("f1", obj, func)עһf1¼ʱһ
-		   ǣٴעһf1¼Ĵʱ
-		   д빹FVariant()ʵevents_["f1"][0].funcĵַЧƺͷˣ
-		   ԣFire("f1")¼ʱڴЧ⣬crash
-		   ˣΪʹָ룬ʵ
+		/* penghuawei: 这很可能是UE4的一个bug
+		   当我们：TMap<FString, EventFuncArray> events_
+		   这样声明的时候，使用KBEEvent::Instance()->Register("f1", obj, func)注册一个f1事件时，一切正常，
+		   但是，当我们再次注册一个f1事件的处理函数时，
+		   如果接着有代码构造了FVariant()实例，则events_["f1"][0].func的地址将变得无效，似乎被释放了，
+		   所以，当Fire("f1")事件时，则会遇到内存访问无效的问题，导致crash。
+		   因此，下面改为使用数组指针，而不是数组实例
 		*/
 		TMap<FString, EventFuncArray *> events_;
 		TArray<EventObj> firedEvents_;
@@ -114,7 +114,7 @@ namespace KBEngine
 	{
 		MonitorEnter(cs_events_);
 
-		//  GetEvent()Աظ
+		// 不能用 GetEvent()，以避免重复锁
 		EventFuncArray** p = events_.Find(eventName);
 		EventFuncArray* lst = p ? *p : nullptr;
 		if (!lst)
@@ -157,7 +157,7 @@ namespace KBEngine
 		for (auto it : events_)
 		{
 			EventFuncArray* lst = it.Value;
-			// ӺǰԱ;ɾ
+			// 从后往前遍历，以避免中途删除的问题
 			for (int i = lst->Num() - 1; i >= 0; i--)
 			{
 				const auto& o = (*lst)[i];
@@ -7,8 +7,8 @@
 #include "KBEMain.generated.h"
 
 /*
-ģ
-аװҪ¼(installEvents)ͬʱʼKBEngine(initKBEngine)
+插件的入口模块
+在这个入口中安装了需要监听的事件(installEvents)，同时初始化KBEngine(initKBEngine)
 */
 
 UCLASS()
@@ -65,6 +65,48 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	int32 TCP_RECV_BUFFER_MAX = 65535;
 
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 TCP_RECV_BUFFER_LIMIT = 4 * 1024 * 1024;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 STREAM_POOL_MAX = 64;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool useFrameBundle = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 frameBundleMaxBytes = 1400;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 frameBundleMaxLatency = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool useVolatileDataBatch = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 entityPoolSize = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool useInterpolation = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 interpolationDelay = 100;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 maxExtrapolationTime = 200;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 playerSyncMaxInterval = 100;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	float playerSyncDistance = 50.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool fixedDictAsStruct = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	bool validateEntityCallArgs = true;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite)
 	bool useAliasEntityID = true;
 
@@ -83,6 +125,6 @@ public:
 	KBEngine::KBEngineApp * pKBEApp = nullptr;
 
 private:
-	// for test
+	// for test，测试主机域名解析
 	void TestResolveIPAddress();
 };
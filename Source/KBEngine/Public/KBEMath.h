@@ -40,8 +40,8 @@ namespace KBEngine
 
 
 		/*
-		1KBEUE4УX,Y,ZߵĶӦϵһµģֵǲһµģKBEûȣUE4ýǶȣ
-		2ϷĹУʵҪֻͬZᣨ
+		1、KBE和UE4中，描述方向的X,Y,Z两者的对应关系是一致的（数值表述是不一致的，KBE用弧度，UE4用角度）
+		2、在游戏的过程中，我们实际所需要同步的只是Z轴（朝向）
 		*/
 		static inline FVector Unreal2KBEngineDirection(const FVector& unrealDir)
 		{
@@ -63,7 +63,7 @@ namespace KBEngine
 			return KBEngine2UnrealDirection(FVector(kbengineDir[0], kbengineDir[1], kbengineDir[2]));
 		}
 
-		// Ԫ㷨
+		// 四元数逆运算算法
 		static FQuat QuatReverse(const FQuat& quat)
 		{
 			FQuat conjugate = quat.Inverse();
@@ -71,7 +71,7 @@ namespace KBEngine
 			return conjugate / magnitude;
 		}
 
-		// ͱ껥Q
+		// 世界坐标和本地坐标互換
 		static FVector PositionLocalToWorld(const FVector& parentPos, const FVector& parentDir, const FVector& localPos)
 		{
 			FQuat Rotation = FQuat::MakeFromEuler(parentDir);
@@ -96,7 +96,7 @@ namespace KBEngine
 		{
 			FQuat pr = FQuat::MakeFromEuler(parentDir);
 			FQuat wr = FQuat::MakeFromEuler(worldDir);
-			FQuat pr_r = QuatReverse(pr); //㷨
+			FQuat pr_r = QuatReverse(pr); //逆运算算法
 			FQuat lr = pr_r * wr;
 			return lr.Euler();
 		}
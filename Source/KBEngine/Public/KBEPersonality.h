@@ -5,58 +5,65 @@
 
 namespace KBEngine
 {
+	class Entity;
+
 	/*
-	 KBEngine࣬ҪʹKBEngine̳࣬ʵԼضΪ
+	 KBEngine的入口类，想要使用KBEngine插件，必须继承于这个类，并在类中实现自己特定的行为。
 	*/
 	class KBENGINE_API KBEPersonality
 	{
 	public:
-		/* ĳspace dataıʱ˷ */
+		/* 当某个space data被改变或设置时，此方法被触发 */
 		virtual void OnSetSpaceData(uint32 spaceID, const FString &key, const FString &value) {}
 
-		/* ĳspace dataɾʱ˷ */
+		/* 当某个space data被删除时，此方法被触发 */
 		virtual void OnDelSpaceData(uint32 spaceID, const FString &key) {}
 
-		/* еSpace˵ͼĵʱ˷ */
+		/* 当服务器中的Space加载了地图的导航数据时，此方法被触发 */
 		virtual void OnAddSpaceGeometryMapping(uint32 spaceID, const FString &respath) {}
 
-		/* ¼ʧʱ˷ */
+		/* 当登录失败时，此方法被触发 */
 		virtual void OnLoginFailed(int32 errCode, const FString& errName, const FString& errDesc) {}
 
-		/* ӶϿʱ˷ */
+		/* 当与服务器的连接断开时，此方法被触发 */
 		virtual void OnDisconnect() {}
 
+		/* 开启了易变数据批处理(KBEngineArgs::useVolatileDataBatch)时，一帧内积攒的坐标与朝向更新被应用后，此方法被触发
+		 * entities为坐标或朝向发生了改变的实体，每个实体只出现一次
+		 */
+		virtual void OnVolatileDataBatchApplied(const TArray<Entity*>& entities) {}
+
 
 
 
-		/* ͨKBEngineApp::ReLoginBaseapp()пµ¼ͨ˷ص */
+		/* 当通过KBEngineApp::ReLoginBaseapp()进行快速重新登录，结果将通过此方法回调 */
 		virtual void OnReLoginBaseapp(int32 errCode, const FString& errName, const FString& errDesc) {}
 
-		/* ͨKBEngineApp::NewPassword()޸룬ͨ˷ص */
+		/* 当通过KBEngineApp::NewPassword()修改密码，结果将通过此方法回调 */
 		virtual void OnNewPassword(int32 errCode, const FString& errName, const FString& errDesc) {}
 
-		/* ͨKBEngineApp::BindAccountEmail()޸ַͨ˷ص */
+		/* 当通过KBEngineApp::BindAccountEmail()修改邮箱地址，结果将通过此方法回调 */
 		virtual void OnBindAccountEmail(int32 errCode, const FString& errName, const FString& errDesc) {}
 
-		/* ɹͨKBEngineApp::CreateAccount()˺Ժ󣬴˷ */
+		/* 当成功通过KBEngineApp::CreateAccount()创建了账号以后，此方法被触发 */
 		virtual void OnCreateAccountSuccess(const FString& account) {}
 
-		/* ɹͨKBEngineApp::ResetPassword()˺󣬴˷ */
+		/* 当成功通过KBEngineApp::ResetPassword()重置账号密码后，此方法被触发 */
 		virtual void OnResetPasswordSuccess(const FString& account) {}
 
-		// ֪ͨѾÿ¼׼
+		// 服务端通知已经做好跨服登录准备，调用
 		virtual void OnAcrossServerReady() {}
-		// ¼ʧʱ˷
+		// 当跨服登录失败时，此方法被触发
 		virtual void OnAcrossLoginFailed(int32 errCode, const FString& errName, const FString& errDesc) {}
-		// ¼ɹ
+		// 跨服登录成功
 		virtual void OnAcrossLoginSuccess() {}
 
 		/*
-		֪ͨؿʼ
-		see also: ĵbaseapp -> classes -> Proxy::streamStringToClient()
+		服务端通知流数据下载开始
+		see also: 服务器文档，baseapp -> classes -> Proxy::streamStringToClient()
 		*/
 		void OnStreamDataStarted(int16 id, uint32 datasize, const FString& descr) {}
-		void OnStreamDataRecv(MemoryStream &stream) {}
+		void OnStreamDataRecv(MemoryStreamView &stream) {}
 		void OnStreamDataCompleted(int16 id) {}
 
 	public:
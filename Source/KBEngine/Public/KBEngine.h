@@ -13,11 +13,13 @@
 #include "KBEngineArgs.h"
 #include "KBEDefine.h"
 #include "MemoryStream.h"
+#include "MemoryStreamPool.h"
 #include "NetworkInterfaceBase.h"
 #include "KBEPersonality.h"
 #include "Property.h"
 #include "ScriptModule.h"
 #include "EntityDeclareDefine.h"
+#include "EntityRemoteMethod.h"
 
 
 class FKBEngineModule : public IModuleInterface
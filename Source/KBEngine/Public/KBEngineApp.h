@@ -28,17 +28,17 @@ namespace KBEngine
 		KBEngineApp(KBEngineArgs* args);
 		virtual ~KBEngineApp();
 
-		// ѭ
+		// 插件的主循环处理函数
 		virtual void Process();
 
-		// Ͽ
+		// 断开与服务器的连接
 		void Disconnect();
 
-		// ȡĽɫEntity
+		// 获取玩家自身的角色Entity
 		Entity* Player();
 
 		/*
-		¼ˣ¼loginapp(baseapp)¼̲
+		登录到服务端，必须登录完成loginapp与网关(baseapp)，登录流程才算完毕
 		*/
 		void Login(const FString& username, const FString& password, const TArray<uint8>& datas);
 
@@ -49,19 +49,19 @@ namespace KBEngine
 		void BindAccountEmail(const FString& emailAddress);
 		void NewPassword(const FString old_password, const FString new_password);
 
-		// ʹδڵĵ¼ƾ֤¼baseapp
+		// 使用未过期的登录凭证跨服登录baseapp
 		void AcrossLoginBaseapp();
 		void AcrossServerReady(UINT64 loginKey, FString& baseappHost, UINT16 port);
-		// ½µ½Դ
+		// 跨服登陆结束后重新登陆源服务器
 		void AcrossLoginBack();
 
-		// ձ׼ÿͻ˲ֶӦð
+		// 按照标准，每个客户端部分都应该包含这个属性
 		const FString& Component() { return component_; }
 
-		// ͨEntityID֮ӦEntityʵ
+		// 通过EntityID查找与之对应的Entity实例
 		Entity* FindEntity(int32 entityID);
 
-		// ȡEntityֵ
+		// 获取Entity字典
 		const TMap<int32, Entity*>* Entities();
 
 	public:
@@ -81,7 +81,7 @@ namespace KBEngine
 		LoginApp* pLoginApp() { return loginApp_; }
 		Messages* pMessages() { return &messages_; }
 
-		void OnLoseConnect();  // ʧȥӣϿ
+		void OnLoseConnect();  // 失去与服务器的连接（非主动断开）
 
 	public:
 		// args for internal
@@ -92,19 +92,32 @@ namespace KBEngine
 		bool IsOnInitCallPropertysSetMethods() { return args_->isOnInitCallPropertysSetMethods; }
 		bool UseAliasEntityID() { return args_->useAliasEntityID; }
 		bool SyncPlayer() { return args_->syncPlayer; }
+		bool UseFrameBundle() { return args_->useFrameBundle; }
+		uint32 FrameBundleMaxBytes() { return args_->frameBundleMaxBytes; }
+		int32 FrameBundleMaxLatency() { return args_->frameBundleMaxLatency; }
+		int32 EntityPoolSize() { return args_->entityPoolSize; }
+		bool UseVolatileDataBatch() { return args_->useVolatileDataBatch; }
+		bool UseInterpolation() { return args_->useInterpolation; }
+		int32 InterpolationDelay() { return args_->interpolationDelay; }
+		int32 MaxExtrapolationTime() { return args_->maxExtrapolationTime; }
+		int32 PlayerSyncMaxInterval() { return args_->playerSyncMaxInterval; }
+		float PlayerSyncDistance() { return args_->playerSyncDistance; }
+		bool FixedDictAsStruct() { return args_->fixedDictAsStruct; }
+		bool ValidateEntityCallArgs() { return args_->validateEntityCallArgs; }
 		const FString& PersistentDataPath() { return args_->persistentDataPath; }
 		CLIENT_TYPE ClientType() { return args_->clientType; }
 		const FString& LoginappHost() { return args_->host; }
 		uint16 LoginappPort() { return args_->port; }
 		uint32 GetTcpRecvBufferMax() { return args_->TCP_RECV_BUFFER_MAX; }
 		uint32 GetTcpSendBufferMax() {	return args_->TCP_SEND_BUFFER_MAX; }
+		uint32 GetTcpRecvBufferLimit() { return args_->TCP_RECV_BUFFER_LIMIT; }
 		
 		uint32 GetUdpRecvBufferMax() { return args_->UDP_RECV_BUFFER_MAX; }
 		uint32 GetUdpSendBufferMax() { return args_->UDP_SEND_BUFFER_MAX; }
 		bool IsForceDisableUDP() { return args_->forceDisableUDP; }
 
 	private:
-		// ȡóʼʱĲ
+		// 取得初始化时的参数
 		KBEngineArgs* GetInitArgs() { return args_; }
 
 		void CloseLoginApp();
@@ -135,19 +148,19 @@ namespace KBEngine
 		LoginApp* loginApp_ = nullptr;
 		BaseApp* baseApp_ = nullptr;
 
-		BaseApp* acrossBaseApp_ = nullptr;	// ¼baseapp
+		BaseApp* acrossBaseApp_ = nullptr;	// 跨服登录的baseapp
 
-		// Ϣ
+		// 消息管理器
 		Messages messages_;
 
-		// ÿִ֡еĶ
+		// 每帧都执行的额外任务
 		Updatables updatables_;
 
-		// ʱݽв
+		// 构造时传递进来的运行参数
 		KBEngineArgs* args_ = NULL;
 
-		// ־ûϢ 磺ӷ˵ЭԳ־ûأ´ε¼汾ı
-		// ֱӴӱؼṩ¼ٶ
+		// 持久化插件信息， 例如：从服务端导入的协议可以持久化到本地，下次登录版本不发生改变
+		// 可以直接从本地加载来提供登录速度
 		PersistentInofs* persistentInofs_ = nullptr;
 
 		FString username_;
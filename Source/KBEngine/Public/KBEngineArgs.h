@@ -7,45 +7,100 @@ namespace KBEngine
 	class KBENGINE_API KBEngineArgs
 	{
 	public:
-		// ¼ipͶ˿
+		// 登录ip和端口
 		FString host = "127.0.0.1";
 		uint16 port = 20013;
 
-		// ͻ
+		// 客户端类型
 		// Reference: http://www.kbengine.org/docs/programming/clientsdkprogramming.html, client types
 		CLIENT_TYPE clientType = CLIENT_TYPE::CLIENT_TYPE_MINI;
 
-		// ־ûϢ 磺ӷ˵ЭԳ־ûأ´ε¼汾ı
-		// ֱӴӱؼṩ¼ٶ
+		// 持久化插件信息， 例如：从服务端导入的协议可以持久化到本地，下次登录版本不发生改变
+		// 可以直接从本地加载来提供登录速度
 		FString persistentDataPath = TEXT("Application.PersistentDataPath");
 
 		// Allow synchronization role position information to the server
-		// ǷԶͬϢˣϢλ뷽
-		// ǸʵʱϷҪѡ
+		// 是否开启自动同步玩家信息到服务端，信息包括位置与方向
+		// 非高实时类游戏不需要开放这个选项
 		bool syncPlayer = true;
 
-		// Ƿʹñ
-		// ѡkbengine_defs.xml::cellapp/aliasEntityIDĲһ
+		// 是否使用别名机制
+		// 这个参数的选择必须与kbengine_defs.xml::cellapp/aliasEntityID的参数保持一致
 		bool useAliasEntityID = true;
 
-		// EntityʼʱǷ񴥷Եset_*¼(callPropertysSetMethods)
+		// 在Entity初始化时是否触发属性的set_*事件(callPropertysSetMethods)
 		bool isOnInitCallPropertysSetMethods = true;
 
-		// ͻС
+		// 发送缓冲大小
 		uint32 TCP_SEND_BUFFER_MAX = 65535;
 
-		// ջС
+		// 接收缓冲区大小
 		uint32 TCP_RECV_BUFFER_MAX = 65535;
 
-		// ͼԽ̣ΪߵʱҲԽ̣λ
-		// Ϊ0򲻷
-		// ע⣺ֵСkbengine_defs.xmlkbengine.xml<channelCommon><timeout><external>õĳʱ
+		// 接收缓冲区在网络突发时可以扩容到的最大值，突发过后会收缩回TCP_RECV_BUFFER_MAX
+		// 达到这个值时接收线程会等待主线程处理，而不是断开连接
+		uint32 TCP_RECV_BUFFER_LIMIT = 4 * 1024 * 1024;
+
+		// Bundle数据流块缓存池中最多保留的空闲块数量，超出部分归还时直接释放
+		int32 STREAM_POOL_MAX = 64;
+
+		// 是否开启帧合并：一帧(一次BaseApp::Process)内产生的所有消息先积攒起来，在帧末尾一次发送
+		// 可以大幅减少频繁调用远程方法时的发包次数
+		bool useFrameBundle = false;
+
+		// 开启帧合并时，积攒的数据达到这个字节数立即发送
+		uint32 frameBundleMaxBytes = 1400;
+
+		// 开启帧合并时，消息最多积攒多长时间；单位：毫秒
+		// 如果为0，则每帧末尾都发送
+		int32 frameBundleMaxLatency = 0;
+
+		// 是否开启易变数据批处理：一帧内收到的实体坐标与朝向更新先积攒起来，同一个实体只保留合并后的一条，
+		// 在消息处理完毕后一次性应用；遇到其它消息时会先应用已积攒的部分，以保证消息的顺序
+		bool useVolatileDataBatch = false;
+
+		// 每种实体类最多缓存多少个已销毁的实体（及其Mailbox）以便复用
+		// 在传送、切换场景等大量实体同时进出视野时可以避免频繁的内存分配；如果为0，则不缓存
+		// 复用的实体不会重新构造，实体类在成员中保存的状态需要在OnRecycle中重置，因此默认不开启
+		int32 entityPoolSize = 0;
+
+		// 是否开启其它实体的插值：服务器同步的坐标与朝向按收到的时间存为快照，
+		// 每帧统一计算出延迟interpolationDelay后的平滑值，通过Entity::SmoothedPosition/SmoothedDirection获取
+		bool useInterpolation = false;
+
+		// 插值延迟；单位：毫秒
+		// 一般略大于服务器同步易变数据的间隔，延迟越大越平滑，但与服务器的偏差也越大
+		int32 interpolationDelay = 100;
+
+		// 超出最新快照后最多按速度外推多长时间；单位：毫秒
+		// 如果为0，则不外推，停在最新快照的位置
+		int32 maxExtrapolationTime = 200;
+
+		// 玩家（以及被本机控制的实体）缓慢移动时向服务器同步坐标的最大间隔；单位：毫秒
+		// 每次同步之间移动距离达到playerSyncDistance或者朝向发生了变化时不受此限制，总是按每秒10次同步
+		// 默认值100表示总是每秒同步10次
+		int32 playerSyncMaxInterval = 100;
+
+		// 见playerSyncMaxInterval；单位：厘米
+		float playerSyncDistance = 50.0f;
+
+		// FIXED_DICT类型的值是否解码为FVariantFixedDict（按字段顺序存放的数组，字段名由类型共享），
+		// 而不是以字段名为key的FVariantMap；解码更快、占用更少，但读取属性的代码需要使用FVariantFixedDict
+		bool fixedDictAsStruct = false;
+
+		// BaseCall/CellCall是否检查参数类型；检查与写入在同一次遍历中完成
+		// 正式发布的版本可以关闭以省去检查的开销，但类型不符的参数会导致断言失败
+		bool validateEntityCallArgs = true;
+
+		// 心跳包发送间隔（间隔越短，认为断线的时间也越短）；单位：秒
+		// 如果为0，则不发送
+		// 注意：此值必须小于kbengine_defs.xml或kbengine.xml下<channelCommon><timeout><external>下配置的超时参数
 		int32 tickInterval = 15;
 
-		// ͨЭܣblowfishЭ
+		// 通信协议加密，blowfish协议
 		TArray<uint8> encryptedKey;
 
-		// ͻ˵İ汾ԼЭMD5
+		// 服务端与客户端的版本号以及协议MD5
 		FString clientVersion = "1.3.12";
 		FString clientScriptVersion = "0.1.0";
 
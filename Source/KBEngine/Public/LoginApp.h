@@ -14,8 +14,8 @@ namespace KBEngine
 	class KBENGINE_API LoginApp : public MessagesHandler
 	{
 	public:
-		/* ӻص
-		intĲʾ룬ϢԲοKBEngineApp::serverErrs_
+		/* 连接回调函数
+		int的参数表示错误码，更多的信息可以参考KBEngineApp::serverErrs_
 		*/
 		typedef std::function<void(int32)> ConnectCallbackFunc;
 
@@ -23,31 +23,34 @@ namespace KBEngine
 		LoginApp(KBEngineApp* app);
 		virtual ~LoginApp();
 
-		// ӵ
+		// 连接到服务器
 		void Connect(const FString& host, uint16 port, ConnectCallbackFunc func);
 
-		// Ͽ
+		// 主动断开网络连接
 		void Disconnect();
 
-		// ǷЧϣ
+		// 检查网络是否有效（连接上）
 		bool NetworkIsValid();
 
-		// ¼
+		// 登录
 		void Login(const FString& account, const FString& password, const TArray<uint8>& datas, CLIENT_TYPE clientType, ConnectCallbackFunc func);
 
-		// 
+		// 重置密码
 		void ResetPassword(const FString& account, ConnectCallbackFunc func);
 
 		/*
-		˺
+		创建账号
 		*/
 		void CreateAccount(const FString& username, const FString& password, const TArray<uint8>& datas, ConnectCallbackFunc func);
 
-		// ÿTickִһ
+		// 每个Tick执行一次
 		void Process();
 
-		virtual void HandleMessage(const FString &name, MemoryStream *stream) override;
-		virtual void HandleMessage(const FString &name, const TArray<FVariant> &args) override;
+		virtual void HandleMessage(const Message& msg, MemoryStreamView *stream) override;
+		virtual void HandleMessage(const Message& msg, const TArray<FVariant> &args) override;
+
+		virtual void BindMessage(const Message& msg) override;
+		virtual void UnbindMessages() override;
 
 		const FString& BaseAppAccount() { return baseappAccount_; }
 		const FString& BaseAppHost() { return baseappHost_; }
@@ -58,7 +61,7 @@ namespace KBEngine
 		// for internal
 
 		NetworkInterfaceBase* pNetworkInterface() { return networkInterface_; }
-		void OnLoseConnect();  // ʧȥӣϿ
+		void OnLoseConnect();  // 失去与服务器的连接（非主动断开）
 
 
 	private:
@@ -71,31 +74,38 @@ namespace KBEngine
 		void CmdImportClientMessages();
 		void CmdImportServerErrorsDescr();
 
-		void Client_onHelloCB(MemoryStream &stream);
-		void Client_onVersionNotMatch(MemoryStream &stream);
-		void Client_onScriptVersionNotMatch(MemoryStream &stream);
-		void Client_onImportClientMessages(MemoryStream &stream);
-		void Client_onImportServerErrorsDescr(MemoryStream &stream);
+		void Client_onHelloCB(MemoryStreamView &stream);
+		void Client_onVersionNotMatch(MemoryStreamView &stream);
+		void Client_onScriptVersionNotMatch(MemoryStreamView &stream);
+		void Client_onImportClientMessages(MemoryStreamView &stream);
+		void Client_onImportServerErrorsDescr(MemoryStreamView &stream);
 
-		void Client_onLoginFailed(MemoryStream &stream);
-		void Client_onLoginSuccessfully(MemoryStream &stream);
+		void Client_onLoginFailed(MemoryStreamView &stream);
+		void Client_onLoginSuccessfully(MemoryStreamView &stream);
 		void Client_onReqAccountResetPasswordCB(uint16 failcode);
-		void Client_onCreateAccountResult(MemoryStream &stream);
+		void Client_onCreateAccountResult(MemoryStreamView &stream);
 
 		void Client_onAppActiveTickCB();
 
 	private:
 		KBEngineApp* app_ = nullptr;
 
-		// Ϣ
+		// 消息处理器
 		MessageReader *messageReader_ = nullptr;
 
-		// Ϣִ
+		// 消息处执行器
 		Messages *messages_ = nullptr;
 
+		// 按消息ID索引的消息派发表
+		typedef MessageDispatchTable<LoginApp> DispatchTable;
+		DispatchTable dispatchTable_;
+
+		// 消息名到处理函数的映射
+		static const DispatchTable::HandlerMap& MessageHandlers();
+
 		NetworkInterfaceBase* networkInterface_ = nullptr;
 
-		// ¼µ¼ʱĵַ˺ŵϢ
+		// 记录下登录时的地址、账号等信息
 		FString host_;
 		uint16 port_;
 		FString account_;
@@ -103,14 +113,14 @@ namespace KBEngine
 		ConnectCallbackFunc connectedCallbackFunc_;
 
 
-		// ¼ɹloginappصBaseApp¼Ϣ
+		// 登录成功后，loginapp返回的BaseApp登录信息
 		FString baseappAccount_;
 		FString baseappHost_;
 		uint16 baseappTcpPort_ = 0;
 		uint16 baseappUdpPort_ = 0;
 
-		// һʱ䡢һյظʱ
-		// ΪǷߵж
+		// 最后一次心跳发送时间、最后一次收到心跳回复的时间
+		// 用于作为是否断线的判断依据
 		FDateTime lastTicktime_ = FDateTime::UtcNow();
 		FDateTime lastTickCBTime_ = FDateTime::UtcNow();
 
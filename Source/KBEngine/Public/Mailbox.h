@@ -18,6 +18,9 @@ namespace KBEngine
 		Mailbox(int32 entityID, const FString& entityType, MAILBOX_TYPE mbType);
 		~Mailbox();
 
+		// 从缓存池中取出复用时，重新指定所属的实体
+		void Reset(int32 entityID, const FString& entityType, MAILBOX_TYPE mbType);
+
 		inline bool IsBase() const
 		{
 			return type_ == MAILBOX_TYPE::MAILBOX_TYPE_BASE;
@@ -29,15 +32,20 @@ namespace KBEngine
 		}
 
 		/*
-		µmail
+		创建新的mail
 		*/
 		Bundle *NewMail();
 
 		/*
-		˷mail
+		向服务端发送这个mail
 		*/
 		void PostMail(NetworkInterfaceBase *networkInterface);
 
+		/*
+		丢弃正在写入的mail，参数写入失败时使用，避免不完整的消息被下一次NewMail带出去
+		*/
+		void DiscardMail();
+
 		int32 ID() { return id_; }
 		const FString& ClassName() { return className_; }
 		MAILBOX_TYPE Type() { return type_; }
@@ -23,14 +23,14 @@ namespace KBEngine
 	};
 
 	/*
-	ģ
-	ܹһЩл(writeXXX)ɶͬʱҲṩ˷л(readXXX)Ȳ
+	只读的二进制数据流视图
+	借用一段外部内存(指针+长度)进行反序列化(readXXX)，自身不拥有也不复制这段内存，
+	构造与销毁都没有堆分配，适合在消息派发等只读场合临时使用。
+	使用者必须保证在视图的生命周期内被借用的内存有效
 	*/
-	class MemoryStream
+	class MemoryStreamView
 	{
 	public:
-		const static size_t BUFFER_MAX = 1460 * 4;
-
 		union PackFloatXType
 		{
 			float fv;
@@ -38,35 +38,21 @@ namespace KBEngine
 			int32 iv;
 		};
 
-		MemoryStream()
-			: rpos_(0), wpos_(0)
-		{
-			data_.resize(BUFFER_MAX);
-		}
-
-		explicit MemoryStream(size_t res)
-			: rpos_(0), wpos_(0)
-		{
-			if (res > 0)
-				data_.resize(res);
-		}
-
-		MemoryStream(const MemoryStream &buf)
-			: rpos_(buf.rpos_), wpos_(buf.wpos_), data_(buf.data_)
+		MemoryStreamView()
+			: data_(nullptr), rpos_(0), wpos_(0)
 		{
 		}
 
-		virtual ~MemoryStream()
+		MemoryStreamView(const uint8 *datas, size_t length)
+			: data_(datas), rpos_(0), wpos_(length)
 		{
 		}
 
-		uint8 *Data() { return &data_[0]; }
-		const uint8 *Data() const { return &data_[0]; }
+		const uint8 *Data() const { return data_; }
 
 		size_t RPos() const     { return rpos_; }
 		void   RPos(size_t pos) { rpos_ = pos; }
 		size_t WPos() const     { return wpos_; }
-		void   WPos(size_t pos) { wpos_ = pos; }
 
 		//---------------------------------------------------------------------------------
 		template <typename T> T Read()
@@ -81,7 +67,7 @@ namespace KBEngine
 			if (pos + sizeof(T) > WPos())
 				throw MemoryStreamException(false, pos, sizeof(T), Length());
 
-			T val = *((T const*)&data_[pos]);
+			T val = *((T const*)(data_ + pos));
 			EndianConvert(val);
 			return val;
 		}
@@ -91,10 +77,21 @@ namespace KBEngine
 			if (len > Length())
 				throw MemoryStreamException(false, rpos_, len, Length());
 
-			memcpy(dest, &data_[rpos_], len);
+			memcpy(dest, data_ + rpos_, len);
 			rpos_ += len;
 		}
 
+		// 一次读取count个定长的基础类型数据，数据不足时抛出MemoryStreamException
+		template <typename T> void ReadArray(TArray<T>& out, uint32 count)
+		{
+			size_t len = (size_t)count * sizeof(T);
+			if (len > Length())
+				throw MemoryStreamException(false, rpos_, len, Length());
+
+			out.SetNumUninitialized(count);
+			Read((uint8 *)out.GetData(), len);
+		}
+
 		int8   ReadInt8()   { return Read<int8>(); }
 		int16  ReadInt16()  { return Read<int16>(); }
 		int32  ReadInt32()  { return Read<int32>(); }
@@ -130,6 +127,90 @@ namespace KBEngine
 			return y;
 		}
 
+		//---------------------------------------------------------------------------------
+		template<typename T>
+		void ReadSkip() { ReadSkip(sizeof(T)); }
+
+		void ReadSkip(size_t skip)
+		{
+			if (skip > Length())
+				throw MemoryStreamException(false, rpos_, skip, Length());
+
+			rpos_ += skip;
+		}
+
+		//---------------------------------------------------------------------------------
+		size_t Length() const { return RPos() >= WPos() ? 0 : WPos() - RPos(); }
+
+		void Done() { ReadSkip(Length()); }
+
+	protected:
+		const uint8 *data_;
+		mutable size_t rpos_, wpos_;
+	};
+
+	/*
+	二进制数据流模块
+	能够将一些基本类型序列化(writeXXX)成二进制流同时也提供了反序列化(readXXX)等操作
+	*/
+	class MemoryStream : public MemoryStreamView
+	{
+	public:
+		const static size_t BUFFER_MAX = 1460 * 4;
+
+		MemoryStream()
+		{
+			storage_.resize(BUFFER_MAX);
+			data_ = storage_.data();
+		}
+
+		explicit MemoryStream(size_t res)
+		{
+			if (res > 0)
+				storage_.resize(res);
+
+			data_ = storage_.data();
+		}
+
+		MemoryStream(const MemoryStream &buf)
+			: MemoryStreamView(buf), storage_(buf.storage_)
+		{
+			data_ = storage_.data();
+		}
+
+		// data_必须指向自己的storage_，不能沿用对方的指针
+		MemoryStream& operator=(const MemoryStream &buf)
+		{
+			if (this != &buf)
+			{
+				storage_ = buf.storage_;
+				data_ = storage_.data();
+				rpos_ = buf.rpos_;
+				wpos_ = buf.wpos_;
+			}
+
+			return *this;
+		}
+
+		// 从只读视图复制出一份自己拥有的数据
+		MemoryStream(const MemoryStreamView &view)
+			: storage_(view.Data(), view.Data() + view.WPos())
+		{
+			data_ = storage_.data();
+			rpos_ = view.RPos();
+			wpos_ = view.WPos();
+		}
+
+		virtual ~MemoryStream()
+		{
+		}
+
+		uint8 *Data() { return storage_.data(); }
+		const uint8 *Data() const { return storage_.data(); }
+
+		void   WPos(size_t pos) { wpos_ = pos; }
+		using MemoryStreamView::WPos;
+
 		//---------------------------------------------------------------------------------
 		template <typename T> void Append(T value)
 		{
@@ -144,10 +225,13 @@ namespace KBEngine
 
 			check(Size() < 10000000);
 
-			if (data_.size() < wpos_ + cnt)
-				data_.resize(wpos_ + cnt);
+			if (storage_.size() < wpos_ + cnt)
+			{
+				storage_.resize(wpos_ + cnt);
+				data_ = storage_.data();
+			}
 
-			memcpy(&data_[wpos_], src, cnt);
+			memcpy(&storage_[wpos_], src, cnt);
 			wpos_ += cnt;
 		}
 
@@ -197,47 +281,33 @@ namespace KBEngine
 		}
 
 		//---------------------------------------------------------------------------------
-		template<typename T>
-		void ReadSkip() { ReadSkip(sizeof(T)); }
-
-		void ReadSkip(size_t skip)
-		{
-			if (skip > Length())
-				throw MemoryStreamException(false, rpos_, skip, Length());
-
-			rpos_ += skip;
-		}
-
-		//---------------------------------------------------------------------------------
-		virtual size_t Size() const { return data_.size(); }
+		virtual size_t Size() const { return storage_.size(); }
 
 		virtual size_t Space() const { return WPos() >= Size() ? 0 : Size() - WPos(); }
 
-		virtual size_t Length() const { return RPos() >= WPos() ? 0 : WPos() - RPos(); }
-
 		bool ReadEOF() const { return (Size() - RPos()) <= 0; }
 
-		void Done() { ReadSkip(Length()); }
-
 		//---------------------------------------------------------------------------------
 		void Clear()
 		{
 			rpos_ = wpos_ = 0;
 
-			if (data_.size() > BUFFER_MAX)
-				data_.resize(BUFFER_MAX);
+			if (storage_.size() > BUFFER_MAX)
+			{
+				storage_.resize(BUFFER_MAX);
+				data_ = storage_.data();
+			}
 		}
 
 		//---------------------------------------------------------------------------------
 		void GetBuffer(std::vector<uint8> &buf) const
 		{
 			buf.resize(Length());
-			memcpy(buf.data(), data_.data() + RPos(), Length());
+			memcpy(buf.data(), Data() + RPos(), Length());
 		}
 
 		private:
-			mutable size_t rpos_, wpos_;
-			std::vector<uint8> data_;
+			std::vector<uint8> storage_;
 
 	};
 }
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "MemoryStream.h"
+#include "HAL/CriticalSection.h"
+
+namespace KBEngine
+{
+	/*
+	MemoryStreamPool的统计信息，用于性能分析
+	*/
+	struct MemoryStreamPoolStats
+	{
+		// 从池中直接取得空闲块的次数
+		uint64 hits = 0;
+
+		// 池中没有空闲块而不得不新分配的次数
+		uint64 misses = 0;
+
+		// 归还时因超过上限而被直接释放的次数
+		uint64 discards = 0;
+
+		// 当前池中空闲块的数量
+		int32 freeCount = 0;
+
+		// 当前被借出(正在使用)的块数量
+		int32 usedCount = 0;
+
+		// 被借出块数量的峰值
+		int32 peakUsedCount = 0;
+	};
+
+	/*
+	线程安全的MemoryStream块缓存池
+	Bundle从这里取得写消息用的数据流块，发送后再归还，避免每条消息都要new/delete一个BUFFER_MAX大小的流。
+	空闲块的数量超过上限(high-water mark)时，归还的块直接释放
+	*/
+	class KBENGINE_API MemoryStreamPool
+	{
+	public:
+		const static int32 DEFAULT_HIGH_WATER_MARK = 64;
+
+		static MemoryStream* Acquire();
+		static void Release(MemoryStream* stream);
+
+		static void SetHighWaterMark(int32 count);
+		static int32 HighWaterMark();
+
+		static MemoryStreamPoolStats Stats();
+		static void ResetStats();
+
+		// 释放池中所有的空闲块
+		static void Clear();
+
+	private:
+		static FCriticalSection lock_;
+		static TArray<MemoryStream*> freeStreams_;
+		static int32 highWaterMark_;
+		static MemoryStreamPoolStats stats_;
+	};
+}
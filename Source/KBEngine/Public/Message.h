@@ -6,7 +6,7 @@ namespace KBEngine
 {
 	typedef uint16 MessageID;
 	
-	class MemoryStream;
+	class MemoryStreamView;
 	class KBEDATATYPE_BASE;
 	class Messages;
 	class MessagesHandler;
@@ -19,19 +19,25 @@ namespace KBEngine
 		Message(MessageID msgid, FString msgname, int16 length, int8 argstype, const TArray<uint8> &msgargtypes, FString msghandler);
 		~Message();
 
+		// 消息描述由Messages持有，创建后不再修改，其他地方只保存指针
+		Message(const Message&) = delete;
+		Message& operator=(const Message&) = delete;
+
 		inline MessageID ID() const { return id_; }
 		inline int16 MsgLen() const { return msgLen_; }
+		inline const FString& Name() const { return name_; }
+		inline const FString& Handler() const { return handler_; }
 
 		/*
-		ӶдϢĲ
+		从二进制数据流中创建该消息的参数数据
 		*/
-		void CreateFromStream(MemoryStream *msgstream, TArray<FVariant> &out) const;
+		void CreateFromStream(MemoryStreamView *msgstream, TArray<FVariant> &out) const;
 
 		/*
-		һϢл󽻸Ϣĺ
-		磺KBEngineApp.Client_onRemoteMethodCall
+		将一个消息包反序列化后交给消息相关联的函数处理
+		例如：KBEngineApp.Client_onRemoteMethodCall
 		*/
-		void HandleMessage(MemoryStream *msgstream, MessagesHandler* handler) const;
+		void HandleMessage(MemoryStreamView *msgstream, MessagesHandler* handler) const;
 
 	private:
 		MessageID id_ = 0;
@@ -55,29 +61,57 @@ namespace KBEngine
 
 		void Reset();
 
-		const Message* GetMessage(FString name);
-		const Message* GetClientMessage(MessageID id);
+		const Message* GetMessage(const FString& name);
+
+		// 消息表每次变化（重置、导入、析构）都会改变这个值，缓存了消息描述指针的地方据此判断是否需要重新查找
+		static uint32 Generation() { return generation_; }
+
+		// 每条收到的消息都要调用，直接以消息ID为下标取得
+		FORCEINLINE const Message* GetClientMessage(MessageID id) const
+		{
+			return id < clientMessages_.Num() ? clientMessages_[id] : nullptr;
+		}
 
 		bool BaseappMessageImported() { return baseappMessageImported_; }
 		void BaseappMessageImported(bool bValue) { baseappMessageImported_ = bValue; }
 		bool LoginappMessageImported() { return loginappMessageImported_; }
 
-		bool ImportMessagesFromStream(MemoryStream& stream, SERVER_APP_TYPE fromApp);
+		bool ImportMessagesFromStream(MemoryStreamView& stream, SERVER_APP_TYPE fromApp);
+
+		// 注册消息处理者，已有的和之后导入的客户端消息都会通知处理者绑定到它的派发表中
+		void RegisterHandler(MessagesHandler* handler);
+		void UnregisterHandler(MessagesHandler* handler);
 
 	private:
 		void BindFixedMessage();
-		void AddClientMessage(const Message& msg);
-		void AddLoginappMessage(const Message& msg);
-		void AddBaseappMessage(const Message& msg);
+
+		// 以下函数接管msg的所有权
+		void AddMessage(const FString& name, Message* msg);
+		void AddClientMessage(Message* msg);
+		void AddLoginappMessage(Message* msg);
+		void AddBaseappMessage(Message* msg);
 
 	private:
-		TMap<MessageID, Message> loginappMessages_;
-		TMap<MessageID, Message> baseappMessages_;
-		TMap<MessageID, Message> clientMessages_;
-		TMap<FString, Message> messages_;
+		// 所有消息描述的所有者，各个消息表中只保存指针
+		TArray<Message*> ownedMessages_;
+
+		// Reset时换下的消息描述，延迟到下一次Reset时才释放，
+		// 因为Reset可能发生在某条消息的处理过程中(例如Client_onHelloCB)，这时消息描述还在使用
+		TArray<Message*> retiredMessages_;
+
+		TMap<MessageID, const Message*> loginappMessages_;
+		TMap<MessageID, const Message*> baseappMessages_;
+		TMap<FString, const Message*> messages_;
+
+		// 以消息ID为下标，没有对应消息的位置为nullptr
+		TArray<const Message*> clientMessages_;
+
+		TArray<MessagesHandler*> handlers_;
 
 		bool baseappMessageImported_ = false;
 		bool loginappMessageImported_ = false;
 
+		static uint32 generation_;
+
 	};  // end of class Messages
 }
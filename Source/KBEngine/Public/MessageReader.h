@@ -15,54 +15,55 @@ namespace KBEngine
 	class KBENGINE_API MessageReader
 	{
 	public:
-		MessageReader(MessagesHandler* handler, Messages *messages, uint32 bufferLength = 65535);
+		MessageReader(MessagesHandler* handler, Messages *messages);
 		~MessageReader();
 
 		enum READ_STATE
 		{
-			// ϢID
+			// 消息ID
 			READ_STATE_MSGID = 0,
 
-			// Ϣĳ65535
+			// 消息的长度65535以内
 			READ_STATE_MSGLEN = 1,
 
-			// Ϣȶ޷Ҫʱʹչ
+			// 当上面的消息长度都无法到达要求时使用扩展长度
 			// uint32
 			READ_STATE_MSGLEN_EX = 2,
 
-			// Ϣ
+			// 消息的内容
 			READ_STATE_BODY = 3
 		};
 
-		// ̴߳
-		void Process();
-
+		// 主线程中调用：直接解析一段连续的数据并派发消息
+		// 完整落在这段数据中的消息会以借用内存的方式交给处理者，不产生复制，
+		// 因此在本函数返回前datas指向的内存必须保持有效
 		void ProcessData(const uint8* datas, MessageLengthEx length);
-		
-		// ߳д
-		uint32 Write(const uint8* datas, MessageLengthEx length);
 
 		void Reset();
 
+		// 停止派发消息，直到下一次Reset；用于在消息处理函数中断开网络时丢弃剩余的数据
+		void Stop() { stopped_ = true; }
+
 	private:
-		uint32 FreeSpace();
 		void Process_(const uint8* datas, MessageLengthEx length);
 
 	private:
 		MessagesHandler* messagesHandler_ = nullptr;
 		Messages *messages_ = nullptr;
 
-		uint32 rpos_ = 0;
-		uint32 wpos_ = 0;
-		uint8* buffer_ = nullptr;
-		uint32 bufferLength_ = 0;
-
 		MessageID msgid = 0;
+
+		// 当前正在读取的消息的描述，在读取消息头时取得，消息体读取完毕后清空
+		const Message* msg_ = nullptr;
 		MessageLength msglen = 0;
 		MessageLengthEx expectSize = 2;
 		READ_STATE state = READ_STATE::READ_STATE_MSGID;
+
+		// 暂存跨越了数据段边界的不完整消息
 		MemoryStream stream;
 
+		bool stopped_ = false;
+
 	};
 
 }
@@ -5,10 +5,100 @@
 
 namespace KBEngine
 {
+	class Message;
+
 	class KBENGINE_API MessagesHandler
 	{
 	public:
-		virtual void HandleMessage(const FString &name, MemoryStream *stream) = 0;
-		virtual void HandleMessage(const FString &name, const TArray<FVariant> &args) = 0;
+		virtual ~MessagesHandler() {}
+
+		// 客户端消息被导入时由Messages调用，处理者在这里按消息名找到处理函数并按消息ID存入派发表，
+		// 之后派发消息时不再需要任何字符串比较
+		virtual void BindMessage(const Message& msg) = 0;
+
+		// 消息表被重置时由Messages调用，清空派发表
+		virtual void UnbindMessages() = 0;
+
+		virtual void HandleMessage(const Message& msg, MemoryStreamView *stream) = 0;
+		virtual void HandleMessage(const Message& msg, const TArray<FVariant> &args) = 0;
+	};
+
+	/*
+	以消息ID为下标的消息派发表
+	T为消息处理者的类型，处理函数在消息导入时按名字解析一次，之后按ID直接取得
+	*/
+	template<typename T>
+	class MessageDispatchTable
+	{
+	public:
+		// 参数为原始数据流的消息处理函数
+		typedef void(*StreamHandler)(T* handler, MemoryStreamView& stream);
+
+		// 参数已经被反序列化的消息处理函数
+		typedef void(*ArgsHandler)(T* handler, const TArray<FVariant>& args);
+
+		struct Entry
+		{
+			StreamHandler streamHandler = nullptr;
+			ArgsHandler argsHandler = nullptr;
+		};
+
+		// 消息名到处理函数的映射，每种处理者只需要构建一次
+		typedef TMap<FString, Entry> HandlerMap;
+
+		// 把T的成员函数转换为StreamHandler，函数在编译期确定，调用时没有额外的间接开销
+		template<void (T::*F)(MemoryStreamView&)>
+		static void StreamThunk(T* handler, MemoryStreamView& stream)
+		{
+			(handler->*F)(stream);
+		}
+
+		static Entry MakeEntry(StreamHandler streamHandler)
+		{
+			Entry entry;
+			entry.streamHandler = streamHandler;
+			return entry;
+		}
+
+		static Entry MakeEntry(ArgsHandler argsHandler)
+		{
+			Entry entry;
+			entry.argsHandler = argsHandler;
+			return entry;
+		}
+
+	public:
+		// 按名字查找处理函数并绑定到消息ID上，找不到处理函数时返回false
+		bool Bind(uint16 msgid, const FString& name, const HandlerMap& handlers)
+		{
+			const Entry* entry = handlers.Find(name);
+			if (!entry)
+				return false;
+
+			if (entries_.Num() <= msgid)
+				entries_.SetNum(msgid + 1);
+
+			entries_[msgid] = *entry;
+			return true;
+		}
+
+		void Clear()
+		{
+			entries_.Reset();
+		}
+
+		// 取得消息ID对应的处理函数，没有绑定时返回nullptr
+		FORCEINLINE StreamHandler FindStreamHandler(uint16 msgid) const
+		{
+			return msgid < entries_.Num() ? entries_[msgid].streamHandler : nullptr;
+		}
+
+		FORCEINLINE ArgsHandler FindArgsHandler(uint16 msgid) const
+		{
+			return msgid < entries_.Num() ? entries_[msgid].argsHandler : nullptr;
+		}
+
+	private:
+		TArray<Entry> entries_;
 	};
 }
@@ -4,11 +4,12 @@
 namespace KBEngine
 {
 	class KBEDATATYPE_BASE;
+	class EntityMethodProxy;
 
 	/*
-	ʵ嶨ķģ
-	һdefļжķģṩ˸÷Ϣ
-	磺ĲidӦűhandler
+	实体定义的方法模块
+	抽象出一个def文件中定义的方法，改模块类提供了该方法的相关描述信息
+	例如：方法的参数、方法的id、方法对应脚本的handler
 	*/
 	class KBENGINE_API Method
 	{
@@ -19,6 +20,9 @@ namespace KBEngine
 		TArray<KBEDATATYPE_BASE *> args;
 		MessageHandler handler = NULL;
 
+		// 实体类中声明的方法代理，由ScriptModule在创建第一个实体时绑定
+		EntityMethodProxy* proxy = nullptr;
+
 		Method()
 		{
 		}
@@ -3,6 +3,7 @@
 
 #include "Networking.h"
 #include "MessageReader.h"
+#include "PacketSenderBase.h"
 
 
 namespace KBEngine
@@ -42,15 +43,28 @@ namespace KBEngine
 
 		virtual bool Valid();
 
-		// ģʽΪڲı״̬ɾԭ״̬
+		// 参数不能用引用模式，因为在内部会改变状态，删除原来的状态数据
 		virtual void OnConnected(ConnectState state);
 
 		void ConnectTo(const FString& ip, uint16 port, ConnectCallbackFun callback);
 
 		virtual void Close();
 
+		/*
+		关闭并销毁网络接口
+		消息处理函数中也可能要求断开网络（例如Client_onVersionNotMatch），这时调用栈上的接收者与接收缓冲区还在使用，
+		所以推迟到Process返回之前再关闭与销毁，在此之前不再派发这个网络收到的消息
+		*/
+		static void Destroy(NetworkInterfaceBase* networkInterface);
+
+		bool DestroyPending() const { return destroyPending_; }
+
 		bool Send(uint8* datas, int32 length);
 
+		// 一次性提交多段数据(scatter/gather)，所有数据段只唤醒发送线程一次
+		bool SendV(const SendSpanArray& spans);
+
+		// 派生类重写时必须在最后调用NetworkInterfaceBase::Process，因为本对象可能在其中被销毁（见Destroy）
 		virtual void Process();
 
 		void ChangeNetworkStatus(NetworkStatus* status);
@@ -64,8 +78,8 @@ namespace KBEngine
 	public:
 		// for internal
 
-		// PacketReceiverPacketSenderSocketдʱ֪ͨرʹ
-		// ˽ӿڽ̵߳
+		// 用于PacketReceiver和PacketSender发现Socket有错误时，通知关闭使用
+		// 此接口将被子线程调用
 		void WillClose();
 
 	protected:
@@ -84,6 +98,10 @@ namespace KBEngine
 
 		bool willClose_ = false;
 
+		// 正在Process中，以及Process期间被要求销毁
+		bool processing_ = false;
+		bool destroyPending_ = false;
+
 		NetworkStatus* networkStatus_ = nullptr;
 
 		MessageReader* messageReader_ = nullptr;
@@ -26,7 +26,7 @@ public:
 
 	bool Valid() override;
 	
-	// ģʽΪڲı״̬ɾԭ״̬
+	// 参数不能用引用模式，因为在内部会改变状态，删除原来的状态数据
 	void OnConnected(ConnectState state) override;
 
 	int SendTo(const char* buf, int len);
@@ -62,7 +62,7 @@ public:
 			opt_.error = TEXT("Connect Error");
 		}
 
-		// ӳɹ񣬶ʶѽй
+		// 无论连接成功与否，都标识已进行过连接
 		connected_ = true;
 		return 0;
 	}
@@ -129,12 +129,12 @@ private:
 		UINT32 DataSize;
 		if (opt_.socket->HasPendingData(DataSize))
 		{
-			MemoryStream s;
+			uint8 datas[MemoryStream::BUFFER_MAX];
 			int32 bytesRead = 0;
 			TSharedRef<FInternetAddr> addr = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateInternetAddr();
-			if (opt_.socket->RecvFrom(s.Data(), s.Size(), bytesRead, *addr))
+			if (opt_.socket->RecvFrom(datas, sizeof(datas), bytesRead, *addr))
 			{
-				s.WPos(bytesRead);
+				MemoryStreamView s(datas, bytesRead);
 				FString helloAck = s.ReadString();
 				FString versionString = s.ReadString();
 				uint32 connID = s.ReadUint32();
@@ -150,19 +150,19 @@ private:
 				{
 					opt_.error = TEXT("failed to connect! conv is 0!");
 				}
-				// TODO֤ versionString Ƿһ
+				// TODO：验证 versionString 是否一致
 
 				connID_ = connID;
 			}
 
-			// ӳɹ񣬶ʶѽй
+			// 无论连接成功与否，都标识已进行过连接
 			connected_ = true;
 		}
 		else
 		{
 			auto currTime = FPlatformTime::Seconds();
 
-			if (currTime - startTime_ > 1.5f && connectCount_ < 2)	// ʱδյ˻ظٴγ
+			if (currTime - startTime_ > 1.5f && connectCount_ < 2)	// 短时间内未收到服务端回复，再次尝试连接
 			{
 				StartConnect();
 				connectCount_ += 1;
@@ -170,7 +170,7 @@ private:
 				return;
 			}
 
-			if (currTime - startTime_ > 15.0f)	// ʱʧܣҵҪд
+			if (currTime - startTime_ > 15.0f)	// 超时失败，业务层需要进行处理
 			{
 				opt_.error = FString::Printf(TEXT("failed to connect to '%s:%d'!"), *opt_.connectIP, opt_.connectPort);
 				connected_ = true;
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Core.h"
+
+namespace KBEngine
+{
+	/*
+	服务端压缩坐标格式的解码
+	单个值的解码在这里以内联函数实现，MemoryStream的ReadPackXZ/ReadPackY/ReadPackXYZ都使用它们；
+	批量解码接口一次处理多个实体的数据(VolatileDataBatch在应用一帧的易变数据前使用)，在支持的平台上使用SSE2或NEON向量指令，结果与单个解码逐位相同
+	*/
+	class KBENGINE_API PackedFloat
+	{
+	public:
+		FORCEINLINE static float AsFloat(uint32 bits)
+		{
+			float f;
+			FMemory::Memcpy(&f, &bits, sizeof(f));
+			return f;
+		}
+
+		FORCEINLINE static uint32 AsUint32(float f)
+		{
+			uint32 bits;
+			FMemory::Memcpy(&bits, &f, sizeof(bits));
+			return bits;
+		}
+
+		// XZ在数据流中占3个字节，高位在前
+		FORCEINLINE static uint32 LoadXZ(const uint8* src)
+		{
+			return ((uint32)src[0] << 16) | ((uint32)src[1] << 8) | (uint32)src[2];
+		}
+
+		FORCEINLINE static void DecodeXZ(uint32 data, float& x, float& z)
+		{
+			// 0x40000000 = 1000000000000000000000000000000.
+			// 复制指数和尾数
+			float xv = AsFloat(0x40000000 | ((data & 0x7ff000) << 3)) - 2.0f;
+			float zv = AsFloat(0x40000000 | ((data & 0x0007ff) << 15)) - 2.0f;
+
+			// 设置标记位
+			x = AsFloat(AsUint32(xv) | ((data & 0x800000) << 8));
+			z = AsFloat(AsUint32(zv) | ((data & 0x000800) << 20));
+		}
+
+		FORCEINLINE static float DecodeY(uint16 data)
+		{
+			float yv = AsFloat(0x40000000 | ((uint32)(data & 0x7fff) << 12)) - 2.f;
+			return AsFloat(AsUint32(yv) | ((uint32)(data & 0x8000) << 16));
+		}
+
+		FORCEINLINE static void DecodeXYZ(uint32 packed, float& x, float& y, float& z, float minf)
+		{
+			x = (packed & 0x7FF) * 0.25f + minf;
+			z = ((packed >> 11) & 0x7FF) * 0.25f + minf;
+			y = (packed >> 22) * 0.25f + minf / 2.f;
+		}
+
+		/*
+		批量解码
+		src为连续存放的count个压缩值（XZ每个3字节，Y每个2字节，XYZ每个4字节），结果按分量分别写入输出数组
+		*/
+		static void DecodeXZ(const uint8* src, int32 count, float* outX, float* outZ);
+		static void DecodeY(const uint8* src, int32 count, float* outY);
+		static void DecodeXYZ(const uint8* src, int32 count, float* outX, float* outY, float* outZ, float minf = -256.f);
+	};
+}
@@ -1,24 +1,63 @@
 #pragma once
+#include <atomic>
+
 #include "MessageReader.h"
+#include "RingBuffer.h"
+
+class FEvent;
 
 namespace KBEngine
 {
 	class MessageReader;
 	class NetworkInterfaceBase;
 
+	/*
+	接收缓冲区的统计信息，用于观察网络突发时的积压情况
+	*/
+	struct PacketReceiverStats
+	{
+		// 当前接收缓冲区的容量
+		uint32 capacity = 0;
+
+		// 接收缓冲区容量的峰值
+		uint32 peakCapacity = 0;
+
+		// 缓冲区中积压(已收到但主线程还未处理)数据的峰值
+		uint32 peakPending = 0;
+
+		// 缓冲区扩容与收缩的次数
+		uint32 growCount = 0;
+		uint32 shrinkCount = 0;
+
+		// 缓冲区达到容量上限后，接收线程不得不等待主线程处理的次数以及累计等待时间(秒)
+		// 等待期间socket不再读取，由TCP的流量控制让服务端放慢发送
+		uint32 fullCount = 0;
+		double fullWaitTime = 0.0;
+	};
+
 	class PacketReceiverBase : public FRunnable
 	{
 	protected:
 		const static int RECV_BUFFER_LENGTH = 65535;
+		const static int RECV_BUFFER_LIMIT = 4 * 1024 * 1024;
+
+		// 缓冲区被读空并且持续这么长时间没有扩容，就收缩回初始大小；单位：秒
+		const static int RECV_BUFFER_SHRINK_IDLE = 10;
+
+		// 缓冲区已满时接收线程每次等待的最长时间，主线程腾出空间时会提前唤醒；单位：毫秒
+		const static uint32 RECV_BUFFER_FULL_WAIT = 10;
 
 	public:
-		PacketReceiverBase(NetworkInterfaceBase* networkInterface, uint32 buffLength = RECV_BUFFER_LENGTH);
+		PacketReceiverBase(NetworkInterfaceBase* networkInterface, uint32 buffLength = RECV_BUFFER_LENGTH, uint32 buffLimit = RECV_BUFFER_LIMIT);
 		~PacketReceiverBase();
 
 		virtual void Process(MessageReader& messageReader);
 		void StartBackgroundRecv();
 		void WillClose() { willClose_ = true; }
 
+		// 取得接收缓冲区的统计信息，可在任意线程中调用
+		PacketReceiverStats GetStats();
+
 	public:
 		// for FRunnable
 		virtual uint32 Run() override;
@@ -26,32 +65,43 @@ namespace KBEngine
 
 
 	protected:
-		// socketУӿڿܻᵼ¿ⲿǲɱ
+		// 由于阻塞在socket中，所以这个接口可能会导致卡机，外部非测试理由别用
 		void StopBackgroundRecv();
 
-		// ߳еãдĻռ
-		uint32 FreeWriteSpace();
-
-		// ߳еãʼSocketжȡ
+		// 子线程中调用：开始从Socket中读取数据
 		virtual void BackgroundRecv() {};
 
+		// 子线程中调用：取得一段连续的可写空间
+		// 缓冲区空闲时先收缩，空间不足时扩容，已经达到容量上限时让出线程等待主线程处理，直到有空间或线程被要求退出(此时返回0)
+		uint32 AcquireWriteSpan(uint8*& datas);
+
+		// 子线程中调用：发布写入的数据
+		void CommitWrite(uint32 count);
+
 	protected:
 		NetworkInterfaceBase* networkInterface_ = NULL;
 
-		uint8* buffer_;
-		uint32 bufferLength_ = 0;
+		// 接收缓冲区，子线程(socket)写入，主线程读取并解析
+		GrowableRingBuffer<uint8> buffer_;
+
+		// 最近一次扩容的时间
+		double lastGrowTime_ = 0.0;
+
+		// 只有接收线程读写，有新的峰值时才加锁写入stats_
+		uint32 peakPending_ = 0;
 
-		// socket򻺳дʼλ
-		uint32 wpos_ = 0;
+		PacketReceiverStats stats_;
+		FCriticalSection statsLock_;
 
-		// ̶߳ȡݵʼλ
-		uint32 rpos_ = 0;
+		// 缓冲区已满时接收线程在spaceEvent_上等待，主线程读取数据后唤醒它
+		FEvent* spaceEvent_ = nullptr;
+		std::atomic<bool> waitingForSpace_{ false };
 
 		FRunnableThread* thread_ = nullptr;
 		bool breakThread_ = false;
 
-		// NetworkInterfaceرʱ֪ͨ
-		// ԱرʱҲϢ
+		// 由NetworkInterface关闭网络时通知，
+		// 以避免在主动关闭网络时也发出错误信息
 		bool willClose_ = false;
 	};
 
@@ -27,10 +27,10 @@ public:
 	void Process(MessageReader& messageReader) override;
 
 protected:
-	// 룬kcpʹö߳
+	// 废弃代码，kcp无需使用多线程
 	void BackgroundRecv() override;
 
-	uint32 CheckForSpace();
+	uint32 CheckForSpace(uint8*& datas);
 
 protected:
 	TSharedRef<FInternetAddr> remoteAddr_;
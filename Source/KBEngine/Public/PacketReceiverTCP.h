@@ -8,8 +8,8 @@ namespace KBEngine
 class PacketReceiverTCP : public PacketReceiverBase
 {
 public:
-	PacketReceiverTCP(NetworkInterfaceBase* networkInterface, uint32 buffLength = 65535)
-		: PacketReceiverBase(networkInterface, buffLength)
+	PacketReceiverTCP(NetworkInterfaceBase* networkInterface, uint32 buffLength = RECV_BUFFER_LENGTH, uint32 buffLimit = RECV_BUFFER_LIMIT)
+		: PacketReceiverBase(networkInterface, buffLength, buffLimit)
 	{}
 
 	void BackgroundRecv() override;
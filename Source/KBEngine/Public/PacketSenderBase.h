@@ -6,6 +6,16 @@ namespace KBEngine
 {
 	class NetworkInterfaceBase;
 
+	// 一段待发送的连续数据
+	struct SendSpan
+	{
+		uint8* datas;
+		uint32 length;
+	};
+
+	// 一次发送的所有数据段，通常就是一个Bundle中所有的数据流块
+	typedef TArray<SendSpan, TInlineAllocator<16>> SendSpanArray;
+
 	class PacketSenderBase
 	{
 	public:
@@ -14,13 +24,17 @@ namespace KBEngine
 
 		virtual bool Send(uint8* datas, uint32 length) = 0;
 
+		// 一次性发送多段数据，默认实现为逐段调用Send
+		// 子类可以重载以便把所有数据段合并为一次提交
+		virtual bool SendV(const SendSpanArray& spans);
+
 		void WillClose() { willClose_ = true; }
 		
 	protected:
 		NetworkInterfaceBase* networkInterface_ = NULL;
 
-		// NetworkInterfaceرʱ֪ͨ
-		// ԱرʱҲϢ
+		// 由NetworkInterface关闭网络时通知，
+		// 以避免在主动关闭网络时也发出错误信息
 		bool willClose_ = false;
 	};
 
@@ -14,6 +14,20 @@ public:
 
 	bool Send(uint8* datas, uint32 length) override;
 
+	// 将所有数据段合并后交给kcp，避免每段数据都产生独立的kcp分片；合并的数据超过单次发送的上限时分多次交给kcp
+	bool SendV(const SendSpanArray& spans) override;
+
+protected:
+	// 单次ikcp_send的分片数必须小于IKCP_WND_RCV(128)，否则ikcp_send失败
+	const static uint32 KCP_MAX_FRAGMENTS = 127;
+
+	// 单次交给kcp的最大字节数
+	uint32 MaxSendSize() const;
+
+	bool SendChunk(const uint8* datas, uint32 length);
+
+	TArray<uint8> gatherBuffer_;
+
 };
 
 }	// end namespace KBEngine
\ No newline at end of file
@@ -2,6 +2,9 @@
 #include "PacketSenderBase.h"
 #include "NetworkInterfaceBase.h"
 #include "HAL/RunnableThread.h"
+#include "RingBuffer.h"
+
+class FEvent;
 
 namespace KBEngine
 {
@@ -15,6 +18,8 @@ public:
 
 	bool Send(uint8* datas, uint32 length) override;
 
+	bool SendV(const SendSpanArray& spans) override;
+
 	void StartBackgroundSend();
 
 	uint32 Run() override;
@@ -24,31 +29,26 @@ protected:
 
 	void DoThreadedWork();
 
-	void RealBackgroundSend(uint32 sendSize, int32& bytesSent);
+	void RealBackgroundSend(const uint8* datas, uint32 sendSize, int32& bytesSent);
 
-	uint32 SendSize() const;
-
-	// пsocketУӿڿܻᵼ¿ⲿǲɱ
+	// 由于有可能阻塞在socket中，所以这个接口可能会导致卡机，外部非测试理由别用
 	void StopBackgroundSend();
 
-	void InitPipe();
-	void ClosePipe();
-	FString ReadPipe();
-	void WritePipe();
+	// 发送线程的唤醒事件
+	void InitWakeEvent();
+	void CloseWakeEvent();
+	void WakeUp();
 
 protected:
-	uint8* buffer_;
-	uint32	bufferLength_ = 0;
-
-	uint32 wpos_ = 0;				// дλ
-	uint32 spos_ = 0;				// ϵλ
+	// 发送缓冲区，主线程写入，发送线程读取并发送
+	RingBuffer<uint8> buffer_;
 	bool sending_ = false;
 
 	FRunnableThread* thread_ = nullptr;
-	bool breakThread_ = false;
+	volatile bool breakThread_ = false;
 
-	void* readPipe_;
-	void* writePipe_;
+	// 有数据待发送或需要退出时触发，自动重置
+	FEvent* wakeEvent_ = nullptr;
 
 };
 
@@ -19,10 +19,10 @@ namespace KBEngine
 		bool LoadBaseappMessages(MemoryStream& out);
 		bool LoadLoginappMessages(MemoryStream& out);
 
-		void WriteServerErrorsDescr(MemoryStream &stream);
-		void WriteEntityDef(MemoryStream &stream);
-		void WriteBaseappMessages(MemoryStream &stream);
-		void WriteLoginappMessages(MemoryStream &stream);
+		void WriteServerErrorsDescr(MemoryStreamView &stream);
+		void WriteEntityDef(MemoryStreamView &stream);
+		void WriteBaseappMessages(MemoryStreamView &stream);
+		void WriteLoginappMessages(MemoryStreamView &stream);
 
 		void ClearAllMessageFiles();
 		void ClearLoginappMessageFiles();
@@ -41,8 +41,9 @@ namespace KBEngine
 		FString GetSuffixBaseapp() { return baseapp_digest_ + TEXT(".") + GetSuffix(); }
 		FString GetSuffixLoginapp() { return loginapp_digest_ + TEXT(".") + GetSuffix(); }
 
-		void WriteFile(const FString &name, MemoryStream &datas);
+		void WriteFile(const FString &name, MemoryStreamView &datas);
 		bool LoadFile(MemoryStream& out, const FString &name);
+		bool LoadFile(TArray<uint8>& out, const FString &name);
 		void DeleteFile(const FString &name);
 
 	private:
@@ -52,7 +53,7 @@ namespace KBEngine
 		FString loginappHost_;
 		uint16 loginappPort_ = 0;
 
-		// 뱾صdigestǷƥ
+		// 服务器与本地的digest是否匹配
 		bool loginapp_is_match_ = false;
 		bool baseapp_is_match_ = false;
 		FString loginapp_digest_;
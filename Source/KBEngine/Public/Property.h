@@ -1,27 +1,30 @@
 #pragma once
 
+#include "DataTypePlan.h"
+
 namespace KBEngine
 {
 	class KBEDATATYPE_BASE;
+	class EntityPropertyProxy;
 
 	/*
-	һentitydefж
-	ģԵidԼ͵Ϣ
+	抽象出一个entitydef中定义的属性
+	该模块描述了属性的id以及数据类型等信息
 	*/
 	class KBENGINE_API Property
 	{
 	public:
 		enum EntityDataFlags
 		{
-			ED_FLAG_UNKOWN = 0x00000000, // δ
-			ED_FLAG_CELL_PUBLIC = 0x00000001, // cell㲥
-			ED_FLAG_CELL_PRIVATE = 0x00000002, // ǰcell
-			ED_FLAG_ALL_CLIENTS = 0x00000004, // cell㲥пͻ
-			ED_FLAG_CELL_PUBLIC_AND_OWN = 0x00000008, // cell㲥ԼĿͻ
-			ED_FLAG_OWN_CLIENT = 0x00000010, // ǰcellͿͻ
-			ED_FLAG_BASE_AND_CLIENT = 0x00000020, // baseͿͻ
-			ED_FLAG_BASE = 0x00000040, // ǰbase
-			ED_FLAG_OTHER_CLIENTS = 0x00000080, // cell㲥ͻ
+			ED_FLAG_UNKOWN = 0x00000000, // 未定义
+			ED_FLAG_CELL_PUBLIC = 0x00000001, // 相关所有cell广播
+			ED_FLAG_CELL_PRIVATE = 0x00000002, // 当前cell
+			ED_FLAG_ALL_CLIENTS = 0x00000004, // cell广播与所有客户端
+			ED_FLAG_CELL_PUBLIC_AND_OWN = 0x00000008, // cell广播与自己的客户端
+			ED_FLAG_OWN_CLIENT = 0x00000010, // 当前cell和客户端
+			ED_FLAG_BASE_AND_CLIENT = 0x00000020, // base和客户端
+			ED_FLAG_BASE = 0x00000040, // 当前base
+			ED_FLAG_OTHER_CLIENTS = 0x00000080, // cell广播和其他客户端
 		};
 
 		FString name;
@@ -30,11 +33,21 @@ namespace KBEngine
 		uint32 properFlags = 0;
 		int16 aliasID = -1;
 
+		// 属性在所属模块中的序号，实体按此下标存取属性值
+		int32 slot = -1;
+
 		FString defaultValStr;
 		PropertyHandler setmethod = NULL;
 
+		// 实体类中声明的属性改变通知代理，由ScriptModule在创建第一个实体时绑定
+		EntityPropertyProxy* proxy = nullptr;
+
+		// 由defaultValStr解析出的默认值
 		FVariant val;
 
+		// 属性值的解码计划，由ScriptModule在创建第一个实体时编译
+		DataTypePlan plan;
+
 		Property()
 		{
 		}
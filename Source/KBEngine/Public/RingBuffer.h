@@ -0,0 +1,346 @@
+#pragma once
+
+#include <atomic>
+
+#include "KBEDebug.h"
+
+namespace KBEngine
+{
+	/*
+	单生产者单消费者(SPSC)的无锁环形缓冲区
+	只允许一个线程写入(生产者)，另一个线程读取(消费者)。
+
+	容量向上取整为2的幂，下标使用自由增长的uint32计数，取模换成与掩码，
+	写计数与读计数的差就是缓冲区中数据的数量，因此整个容量都可以使用，不需要保留空位。
+	生产者写完数据后以release语义发布写计数，消费者以acquire语义读取，保证看到的数据是完整的，反之亦然。
+	写计数与读计数分别放在独立的缓存行中，避免两个线程之间的伪共享。
+	*/
+	template<typename T>
+	class RingBuffer
+	{
+	public:
+		static const uint32 CACHE_LINE_SIZE = 64;
+
+		explicit RingBuffer(uint32 minCapacity)
+		{
+			capacity_ = RoundUpToPowerOfTwo(minCapacity);
+			mask_ = capacity_ - 1;
+			buffer_ = new T[capacity_];
+		}
+
+		~RingBuffer()
+		{
+			delete[] buffer_;
+			buffer_ = nullptr;
+		}
+
+		RingBuffer(const RingBuffer&) = delete;
+		RingBuffer& operator=(const RingBuffer&) = delete;
+
+		uint32 Capacity() const { return capacity_; }
+
+		// 任意线程中调用：当前缓冲区中数据的数量(只是一个瞬时值)
+		uint32 Size() const
+		{
+			return head_.value.load(std::memory_order_acquire) - tail_.value.load(std::memory_order_acquire);
+		}
+
+		bool Empty() const { return Size() == 0; }
+
+	public:
+		// 生产者线程中调用：可写入的空间
+		uint32 WriteSpace() const
+		{
+			uint32 head = head_.value.load(std::memory_order_relaxed);
+			return capacity_ - (head - tail_.value.load(std::memory_order_acquire));
+		}
+
+		// 生产者线程中调用：取得从写位置开始的一段连续可写空间，返回其长度
+		// 回环时只返回到缓冲区末尾的部分，写完并CommitWrite后再次调用即可得到头部的空间
+		uint32 GetWriteSpan(T*& datas)
+		{
+			uint32 head = head_.value.load(std::memory_order_relaxed);
+			uint32 space = capacity_ - (head - tail_.value.load(std::memory_order_acquire));
+			uint32 index = head & mask_;
+
+			datas = &buffer_[index];
+			return FMath::Min(space, capacity_ - index);
+		}
+
+		// 生产者线程中调用：发布已经写入的count个元素，消费者此后才能看到这些数据
+		void CommitWrite(uint32 count)
+		{
+			uint32 head = head_.value.load(std::memory_order_relaxed);
+			KBE_ASSERT(count <= capacity_ - (head - tail_.value.load(std::memory_order_acquire)));
+			head_.value.store(head + count, std::memory_order_release);
+		}
+
+		// 生产者线程中调用：写入count个元素，空间不足时不写入任何数据并返回false
+		bool Write(const T* datas, uint32 count)
+		{
+			uint32 head = head_.value.load(std::memory_order_relaxed);
+			if (count > capacity_ - (head - tail_.value.load(std::memory_order_acquire)))
+				return false;
+
+			uint32 index = head & mask_;
+			uint32 first = FMath::Min(count, capacity_ - index);
+
+			FMemory::Memcpy(&buffer_[index], datas, first * sizeof(T));
+			if (count > first)
+				FMemory::Memcpy(&buffer_[0], datas + first, (count - first) * sizeof(T));
+
+			head_.value.store(head + count, std::memory_order_release);
+			return true;
+		}
+
+	public:
+		// 消费者线程中调用：可读取的数据数量
+		uint32 ReadSize() const
+		{
+			return head_.value.load(std::memory_order_acquire) - tail_.value.load(std::memory_order_relaxed);
+		}
+
+		// 消费者线程中调用：取得从读位置开始的一段连续数据，返回其长度
+		// 在CommitRead之前这段数据不会被生产者覆盖，可以直接在缓冲区上使用
+		uint32 GetReadSpan(T*& datas)
+		{
+			uint32 tail = tail_.value.load(std::memory_order_relaxed);
+			uint32 size = head_.value.load(std::memory_order_acquire) - tail;
+			uint32 index = tail & mask_;
+
+			datas = &buffer_[index];
+			return FMath::Min(size, capacity_ - index);
+		}
+
+		// 消费者线程中调用：释放已经读取的count个元素，生产者此后可以覆盖这部分空间
+		void CommitRead(uint32 count)
+		{
+			uint32 tail = tail_.value.load(std::memory_order_relaxed);
+			KBE_ASSERT(count <= head_.value.load(std::memory_order_acquire) - tail);
+			tail_.value.store(tail + count, std::memory_order_release);
+		}
+
+		// 消费者线程中调用：读取最多count个元素，返回实际读取的数量
+		uint32 Read(T* datas, uint32 count)
+		{
+			uint32 tail = tail_.value.load(std::memory_order_relaxed);
+			uint32 size = head_.value.load(std::memory_order_acquire) - tail;
+			if (count > size)
+				count = size;
+
+			uint32 index = tail & mask_;
+			uint32 first = FMath::Min(count, capacity_ - index);
+
+			FMemory::Memcpy(datas, &buffer_[index], first * sizeof(T));
+			if (count > first)
+				FMemory::Memcpy(datas + first, &buffer_[0], (count - first) * sizeof(T));
+
+			tail_.value.store(tail + count, std::memory_order_release);
+			return count;
+		}
+
+	private:
+		static uint32 RoundUpToPowerOfTwo(uint32 v)
+		{
+			KBE_ASSERT(v > 0 && v <= (1u << 31));
+
+			uint32 capacity = 1;
+			while (capacity < v)
+				capacity <<= 1;
+
+			return capacity;
+		}
+
+		// 独占一个缓存行的计数
+		struct alignas(CACHE_LINE_SIZE) PaddedIndex
+		{
+			std::atomic<uint32> value{ 0 };
+		};
+
+	private:
+		// 只在构造时写入，两个线程都只读
+		T* buffer_ = nullptr;
+		uint32 capacity_ = 0;
+		uint32 mask_ = 0;
+
+		// 生产者写入的总数量，只有生产者修改
+		PaddedIndex head_;
+
+		// 消费者读取的总数量，只有消费者修改
+		PaddedIndex tail_;
+	};
+
+	/*
+	可增长的单生产者单消费者环形缓冲区
+	由一串RingBuffer组成：生产者写满当前的环后，分配一个更大的环并发布到链上，之后只写新的环；
+	消费者读空旧的环并发现已经有了下一个环时，释放旧的环并切换过去。
+	旧的环一旦被生产者放弃就不会再被写入，所以切换过程不需要加锁。
+	生产者也可以在当前的环已经被读空时换回一个较小的环，以便空闲时归还内存。
+
+	容量上限限制的是链上所有还未被释放的环的容量总和，而不只是当前的环：
+	消费者还没读空的旧环也计入其中，扩容时只使用剩余的额度，额度用完时不再扩容，
+	直到消费者释放了旧环。因此缓冲区中的数据总量不会超过容量上限。
+	*/
+	template<typename T>
+	class GrowableRingBuffer
+	{
+	public:
+		GrowableRingBuffer(uint32 initCapacity, uint32 maxCapacity)
+		{
+			Segment* segment = new Segment(initCapacity);
+			initCapacity_ = segment->ring.Capacity();
+
+			// 每个环的容量都是2的幂，上限向下取整为2的幂，扩容时才不会超过上限
+			maxCapacity_ = RoundDownToPowerOfTwo(FMath::Max(maxCapacity, initCapacity_));
+			allocatedCapacity_.store(initCapacity_, std::memory_order_relaxed);
+			writeSegment_ = readSegment_ = segment;
+		}
+
+		~GrowableRingBuffer()
+		{
+			Segment* segment = readSegment_;
+			while (segment)
+			{
+				Segment* next = segment->next.load(std::memory_order_acquire);
+				delete segment;
+				segment = next;
+			}
+
+			readSegment_ = writeSegment_ = nullptr;
+		}
+
+		GrowableRingBuffer(const GrowableRingBuffer&) = delete;
+		GrowableRingBuffer& operator=(const GrowableRingBuffer&) = delete;
+
+		uint32 InitCapacity() const { return initCapacity_; }
+		uint32 MaxCapacity() const { return maxCapacity_; }
+
+		// 任意线程中调用：链上所有还未被释放的环的容量总和(只是一个瞬时值)
+		uint32 AllocatedCapacity() const { return allocatedCapacity_.load(std::memory_order_acquire); }
+
+	public:
+		// 生产者线程中调用：当前写入的环的容量
+		uint32 Capacity() const { return writeSegment_->ring.Capacity(); }
+
+		// 生产者线程中调用：当前写入的环中还未被读取的数据数量
+		uint32 Size() const { return writeSegment_->ring.Size(); }
+
+		// 生产者线程中调用：取得一段连续可写空间，返回其长度
+		// 如果当前的环已满并且还有剩余的容量额度，会换到一个更大的环；额度用完时返回0
+		uint32 GetWriteSpan(T*& datas)
+		{
+			uint32 space = writeSegment_->ring.GetWriteSpan(datas);
+			if (space > 0 || !Grow())
+				return space;
+
+			return writeSegment_->ring.GetWriteSpan(datas);
+		}
+
+		void CommitWrite(uint32 count)
+		{
+			writeSegment_->ring.CommitWrite(count);
+		}
+
+		// 生产者线程中调用：换到一个更大的环，已经没有剩余的容量额度时返回false
+		// 新环的容量是当前的两倍，但不超过剩余的额度(向下取整为2的幂)
+		bool Grow()
+		{
+			// 消费者释放旧环时才会减少，这里读到的值只会偏大，不会因此超过上限
+			uint32 allocated = allocatedCapacity_.load(std::memory_order_acquire);
+			if (allocated >= maxCapacity_)
+				return false;
+
+			uint32 capacity = writeSegment_->ring.Capacity();
+			SwitchWriteSegment(FMath::Min(capacity * 2, RoundDownToPowerOfTwo(maxCapacity_ - allocated)));
+			return true;
+		}
+
+		// 生产者线程中调用：当前的环已经被读空时换回初始大小的环，成功返回true
+		// 被换下的环已经没有数据，在消费者释放它之前会短暂地多占用一些内存，但之后的扩容仍受额度限制
+		bool Shrink()
+		{
+			if (writeSegment_->ring.Capacity() <= initCapacity_ || writeSegment_->ring.Size() > 0)
+				return false;
+
+			SwitchWriteSegment(initCapacity_);
+			return true;
+		}
+
+	public:
+		// 消费者线程中调用：取得一段连续数据，返回其长度
+		// 当前的环已经读空并且生产者已经换到下一个环时，释放当前的环并从下一个环中读取
+		uint32 GetReadSpan(T*& datas)
+		{
+			while (true)
+			{
+				uint32 size = readSegment_->ring.GetReadSpan(datas);
+				if (size > 0)
+					return size;
+
+				Segment* next = readSegment_->next.load(std::memory_order_acquire);
+				if (!next)
+					return 0;
+
+				// 生产者发布next之前写入旧环的数据此时一定可见，再确认一次旧环确实已经读空
+				size = readSegment_->ring.GetReadSpan(datas);
+				if (size > 0)
+					return size;
+
+				allocatedCapacity_.fetch_sub(readSegment_->ring.Capacity(), std::memory_order_release);
+				delete readSegment_;
+				readSegment_ = next;
+			}
+		}
+
+		void CommitRead(uint32 count)
+		{
+			readSegment_->ring.CommitRead(count);
+		}
+
+	private:
+		struct Segment
+		{
+			explicit Segment(uint32 capacity)
+				: ring(capacity)
+			{
+			}
+
+			RingBuffer<T> ring;
+			std::atomic<Segment*> next{ nullptr };
+		};
+
+		void SwitchWriteSegment(uint32 capacity)
+		{
+			Segment* segment = new Segment(capacity);
+			allocatedCapacity_.fetch_add(segment->ring.Capacity(), std::memory_order_relaxed);
+			writeSegment_->next.store(segment, std::memory_order_release);
+			writeSegment_ = segment;
+		}
+
+	private:
+		static uint32 RoundDownToPowerOfTwo(uint32 v)
+		{
+			KBE_ASSERT(v > 0);
+
+			uint32 capacity = 1;
+			while (capacity <= v / 2)
+				capacity <<= 1;
+
+			return capacity;
+		}
+
+	private:
+		uint32 initCapacity_ = 0;
+		uint32 maxCapacity_ = 0;
+
+		// 链上所有还未被释放的环的容量总和，生产者分配新环时增加，消费者释放旧环时减少
+		std::atomic<uint32> allocatedCapacity_{ 0 };
+
+		// 只有生产者使用
+		Segment* writeSegment_ = nullptr;
+
+		// 只有消费者使用
+		Segment* readSegment_ = nullptr;
+	};
+
+}
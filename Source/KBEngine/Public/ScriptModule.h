@@ -5,13 +5,14 @@
 #include "KBEDebug.h"
 #include "Method.h"
 #include "Property.h"
+#include "Mailbox.h"
 
 namespace KBEngine
 {
 	class Entity;
 
 	/*
-	Ӧһ.defͣԴӦʵ
+	对应一个.def类型，以创建相应的实例
 	*/
 	class KBENGINE_API EntityClassDef
 	{
@@ -62,8 +63,20 @@ namespace KBEngine
 
 
 	/*
-	һentitydefжĽűģ
-	ĳentity뷽ԼentityűģģID
+	实体缓存池的统计数据
+	*/
+	struct EntityPoolStats
+	{
+		uint32 created = 0;		// 新分配的实体数量
+		uint32 reused = 0;		// 从缓存池中取出复用的实体数量（命中次数）
+		uint32 released = 0;	// 归还到缓存池中的实体数量
+		uint32 live = 0;		// 当前存活的实体数量
+		uint32 peakLive = 0;	// 存活实体数量的峰值
+	};
+
+	/*
+	一个entitydef中定义的脚本模块的描述类
+	包含了某个entity定义的属性与方法以及该entity脚本模块的名称与模块ID
 	*/
 	class ScriptModule
 	{
@@ -73,6 +86,15 @@ namespace KBEngine
 
 		Entity* CreateEntity(int32 eid);
 
+		// 销毁实体，缓存池未满时实体被重置后放入缓存池，否则直接释放
+		void ReleaseEntity(Entity* entity);
+
+		// 创建/回收该模块实体使用的Mailbox，同样经由缓存池
+		Mailbox* CreateMailbox(int32 eid, Mailbox::MAILBOX_TYPE mbType);
+		void ReleaseMailbox(Mailbox* mailbox);
+
+		FORCEINLINE const EntityPoolStats& PoolStats() const { return poolStats_; }
+
 		FORCEINLINE const FString& Name() { return name_; }
 		FORCEINLINE void Name(const FString& name) { name_ = name; }
 		
@@ -82,42 +104,71 @@ namespace KBEngine
 		FORCEINLINE bool UseMethodDescrAlias() { return useMethodDescrAlias_; }
 		FORCEINLINE void UseMethodDescrAlias(bool yes) { useMethodDescrAlias_ = yes; }
 
-		void ClonePropertyTo(TMap<FString, Property *>& out1, TMap<uint16, Property *>& out2);
-		Property* MakeProperty(MemoryStream &stream);
+		// 按序号排列的属性描述及默认值，实体创建时整体拷贝默认值作为自己的属性值
+		FORCEINLINE const TArray<Property *>& SlotPropertys() const { return slotpropertys_; }
+		FORCEINLINE const TArray<FVariant>& DefaultValues() const { return defaultValues_; }
+
+		Property* MakeProperty(MemoryStreamView &stream);
 		Property* GetProperty(const FString& name);
+
+		// 按数据流中的ID查找，使用别名时为别名ID，否则为属性ID
 		Property* GetProperty(uint16 id);
 
+		// 按属性ID查找，与是否使用别名无关
+		Property* GetPropertyByUType(uint16 utype);
+
 
-		Method* MakeMethod(MemoryStream &stream);
+		Method* MakeMethod(MemoryStreamView &stream);
 		Method* GetMethod(const FString& name);
+
+		// 按数据流中的ID查找，使用别名时为别名ID，否则为方法ID
 		Method* GetMethod(uint16 id);
 
-		Method* MakeBaseMethod(MemoryStream &stream);
+		Method* MakeBaseMethod(MemoryStreamView &stream);
 		Method* GetBaseMethod(const FString& name);
 		Method* GetBaseMethod(uint16 id);
 
-		Method* MakeCellMethod(MemoryStream &stream);
+		Method* MakeCellMethod(MemoryStreamView &stream);
 		Method* GetCellMethod(const FString& name);
 		Method* GetCellMethod(uint16 id);
 
+	private:
+		// 按名字把方法与属性绑定到实体类声明的代理上，之后按ID派发时不再需要查找映射表
+		void BindProxies(Entity* entity);
+
 	private:
 		FString name_;
 		bool usePropertyDescrAlias_ = false;
 		bool useMethodDescrAlias_ = false;
 
 		TMap<FString, Property *> propertys_;
-		TMap<uint16, Property *> idpropertys_;
+		TArray<Property *> slotpropertys_;
+		TArray<FVariant> defaultValues_;
+		// 以别名ID为下标，别名ID是从0开始连续分配的，只在使用别名时填充
+		TArray<Property *> idpropertys_;
+		// 以属性ID为键，包含所有属性
+		TMap<uint16, Property *> utypepropertys_;
 
 		TMap<FString, Method *> methods_;
 		TMap<FString, Method *> base_methods_;
 		TMap<FString, Method *> cell_methods_;
 
-		TMap<uint16, Method *> idmethods_;
+		// 以别名ID为下标，只在使用别名时填充
+		TArray<Method *> idmethods_;
+		// 以方法ID为键，包含所有方法
+		TMap<uint16, Method *> utypemethods_;
 		TMap<uint16, Method *> idbase_methods_;
 		TMap<uint16, Method *> idcell_methods_;
 
 		EntityClassDef *script_ = nullptr;
-		
+
+		// 方法与属性是否已经绑定到实体类声明的代理上
+		bool proxiesBound_ = false;
+
+		// 已销毁待复用的实体与Mailbox
+		TArray<Entity *> entityPool_;
+		TArray<Mailbox *> mailboxPool_;
+		EntityPoolStats poolStats_;
 
 	};
 
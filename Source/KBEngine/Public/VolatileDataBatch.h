@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Core.h"
+
+namespace KBEngine
+{
+	/*
+	一帧内收到的实体易变数据（坐标与朝向）的批量缓存，按数组分列存放
+	同一个实体在一帧内的多次更新会被合并为一条：坐标以最后一次为准，朝向按分量覆盖
+	优化协议中压缩的坐标先以原始数据保存，应用之前由DecodePackedPositions一次性批量解码
+	*/
+	class KBENGINE_API VolatileDataBatch
+	{
+	public:
+		enum Flags : uint8
+		{
+			HAS_ROLL = 0x01,
+			HAS_PITCH = 0x02,
+			HAS_YAW = 0x04,
+			HAS_POSITION = 0x08,
+
+			// 坐标还是压缩的原始数据(packedXZs/packedYs)，需要DecodePackedPositions解码
+			HAS_PACKED_POSITION = 0x10,
+
+			HAS_DIRECTION = HAS_ROLL | HAS_PITCH | HAS_YAW,
+		};
+
+		/*
+		position为已经转换到Unreal坐标系的本地坐标，positionOffset为没有父对象时需要加上的偏移（优化协议中的玩家服务器坐标）
+		angles为服务器坐标系下的角度：X为roll，Y为pitch，Z为yaw
+		isOnGround小于0表示不设置
+		*/
+		void Add(int32 entityID, uint8 flags, const FVector& position, const FVector& positionOffset, const FVector& angles, int8 isOnGround);
+
+		/*
+		与Add相同，但坐标为优化协议中压缩的原始数据：packedXZ为3个字节，packedY为2个字节，没有Y时为nullptr(解码为0)
+		*/
+		void AddPacked(int32 entityID, uint8 flags, const uint8* packedXZ, const uint8* packedY, const FVector& positionOffset, const FVector& angles, int8 isOnGround);
+
+		// 用PackedFloat的批量接口解码所有压缩的坐标，转换到Unreal坐标系后写入positions
+		void DecodePackedPositions();
+
+		FORCEINLINE int32 Num() const { return entityIDs.Num(); }
+
+		void Reset();
+
+	public:
+		TArray<int32> entityIDs;
+		TArray<uint8> flags;
+		TArray<FVector> positions;
+		TArray<FVector> positionOffsets;
+		TArray<FVector> angles;
+		TArray<int8> onGrounds;
+
+		// 每个实体的压缩坐标原始数据，XZ每个3字节，Y每个2字节，没有压缩坐标的实体为0
+		TArray<uint8> packedXZs;
+		TArray<uint8> packedYs;
+
+		// 累计收到的更新条数，以及因同一实体在同一帧内重复更新而被合并的条数
+		uint64 totalUpdates = 0;
+		uint64 mergedUpdates = 0;
+
+	private:
+		// 合并或者新增一条，返回其下标
+		int32 Merge(int32 entityID, uint8 flags, const FVector& position, const FVector& positionOffset, const FVector& angles, int8 isOnGround);
+
+	private:
+		// 实体ID => 在上面数组中的下标
+		TMap<int32, int32> slots_;
+
+		// 批量解码的输出
+		TArray<float> decodedX_;
+		TArray<float> decodedY_;
+		TArray<float> decodedZ_;
+	};
+}